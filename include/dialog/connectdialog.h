@@ -24,7 +24,7 @@ public:
     ~ConnectDialog();
 
 signals:
-    void connectRequested(const QString &url);    // 建立连接请求
+    void connectRequested(const QStringList &urls);    // 建立连接请求（所有勾选的机器人）
 
 private slots:
     void onAddButtonClicked();
@@ -0,0 +1,41 @@
+#ifndef METRICSDIALOG_H
+#define METRICSDIALOG_H
+
+#include <QDialog>
+#include <QTimer>
+#include <QTableWidgetItem>
+#include <QDebug>
+
+#include "util/topicmetrics.h"
+#include "util/tracerecorder.h"
+
+namespace Ui
+{
+    class MetricsDialog;
+}
+
+// 话题统计面板：每秒刷新 TopicMetrics 快照（消息率、带宽、大小分位数、解析/解码耗时、丢弃数）
+class MetricsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsDialog(QWidget *parent = nullptr);
+    ~MetricsDialog();
+
+private slots:
+    void refresh();
+    void onResetButtonClicked();
+    void onTraceToggled(bool checked);
+    void onTraceExportButtonClicked();     // 导出 Chrome trace JSON（chrome://tracing / Perfetto）
+
+private:
+    void setTableWidget();  // 设置tableWidget
+    void setCell(int row, int column, const QString &text);
+
+private:
+    Ui::MetricsDialog *ui;
+    QTimer *refreshTimer;
+};
+
+#endif // METRICSDIALOG_H
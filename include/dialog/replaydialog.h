@@ -0,0 +1,44 @@
+#ifndef REPLAYDIALOG_H
+#define REPLAYDIALOG_H
+
+#include <QDialog>
+#include <QPointer>
+#include <QStringList>
+#include <QDebug>
+
+namespace Ui
+{
+    class ReplayDialog;
+}
+
+class ReplaySource;
+
+// 会话回放控制：播放/暂停、倍速（含“最快”）、拖动进度条跳转，播放结束时显示吞吐
+// 回放源运行在 worker 线程中，这里只通过 QueuedConnection 调用它的槽
+class ReplayDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayDialog(ReplaySource *source, QWidget *parent = nullptr);
+    ~ReplayDialog();
+
+private slots:
+    void onOpened(const QString &url, qint64 durationUs, quint64 frames, const QStringList &topics);
+    void onPositionChanged(qint64 offsetUs);
+    void onFinished(quint64 frames, quint64 bytes, qint64 elapsedMs, qint64 maxLagMs);
+    void onPlayButtonClicked();
+    void onSpeedChanged(int index);
+    void onSliderReleased();
+
+private:
+    void updatePositionLabel(qint64 offsetUs);
+
+private:
+    Ui::ReplayDialog *ui;
+    QPointer<ReplaySource> m_source;    // 回放连接关闭后被销毁
+    qint64 m_durationUs = 0;
+    bool m_playing = false;
+};
+
+#endif // REPLAYDIALOG_H
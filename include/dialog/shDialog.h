@@ -16,7 +16,7 @@
 
 #include "ros_process/cameraImage.h"
 #include "ros_process/slamMapPoint.h"
-#include "ros_process/pointclouddisplay.h"
+#include "ros_process/pointCloudDisplay.h"
 
 namespace Ui
 {
@@ -51,20 +51,20 @@ signals:
 private:
     void init();
     void bindSlots();
+    void pullSlamMap();                 // 从 SLAM 监视器的信箱取最新的点云/关键帧/相机矩阵
     bool eventFilter(QObject *watched, QEvent *event) override;
 
 
 private:
     Ui::ShDialog *ui;
     WebSocketWorker *m_worker;
-    QThread *featuredImageThread;                       // 特征点图像处理线程
     CameraImageMonitor *featuredImageMonitor;           // 特征点图像监视器
     QTimer *featuredImagePullTimer;                     // 定时器，用于从特征点图像监视器中获取最新帧
     CameraImageMonitor *cameraImageMonitor = nullptr;   // 相机图像监视器
     QString m_featureTopic;
 
     SlamMapMonitor *slamMapMonitor = nullptr;       // SLAM地图点云监视器
-    QThread *slamMapThread = nullptr;               // SLAM地图点云处理线程
+    QTimer *slamMapPullTimer = nullptr;             // 定时器，用于从SLAM监视器信箱中获取最新数据
     
     PointCloudDisplay *pcd = nullptr;           // QOpenGL点云显示
     bool localizationAdvertised = false;        // 是否已发布定位模式话题
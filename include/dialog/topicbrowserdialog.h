@@ -0,0 +1,48 @@
+#ifndef TOPICBROWSERDIALOG_H
+#define TOPICBROWSERDIALOG_H
+
+#include <QDialog>
+#include <QPointer>
+#include <QHash>
+#include <QTableWidgetItem>
+#include <QDebug>
+
+#include "socket_process/rosapi.h"
+
+namespace Ui
+{
+    class TopicBrowserDialog;
+}
+
+class WebSocketWorker;
+
+// 话题列表：通过 rosapi 查询机器人上的全部话题及类型，不必再登录机器人执行 rostopic list
+// 服务端未返回类型的话题，同时发出多个 topic_type 查询逐个补齐
+class TopicBrowserDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TopicBrowserDialog(WebSocketWorker *worker, QWidget *parent = nullptr);
+    ~TopicBrowserDialog();
+
+private slots:
+    void refresh();
+    void applyFilter(const QString &text);
+
+private:
+    void setTableWidget();  // 设置tableWidget
+    void showTopics(const RosApi::TopicList &list);
+    void showTopicType(const RosApi::TopicType &result);
+    void updateSummary();
+
+private:
+    Ui::TopicBrowserDialog *ui;
+    QPointer<WebSocketWorker> m_worker;     // 机器人断开后 worker 被销毁
+    QHash<QString, int> m_rows;             // 话题 -> 行
+    int m_pendingTypes = 0;                 // 尚未返回的 topic_type 查询数
+    quint64 m_generation = 0;               // 每次刷新加一，丢弃上一次刷新迟到的应答
+    qint64 m_elapsedUs = 0;
+};
+
+#endif // TOPICBROWSERDIALOG_H
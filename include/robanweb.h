@@ -11,10 +11,14 @@
 #include <QLabel>
 #include <QJsonArray>
 #include <QProgressBar>
+#include <QComboBox>
+#include <QMap>
+#include <QPointer>
 
 
 
 #include "socket_process/websocketworker.h"
+#include "socket_process/connectionmanager.h"
 #include "ros_process/battery.h"
 #include "ros_process/imu.h"
 #include "ros_process/cameraImage.h"
@@ -34,43 +38,58 @@ private slots:
     void onConnectSettingButtonClicked();       // 连接设置 槽函数
     void onSlamControlButtonClicked();           // SLAM控制按钮 槽函数
     void onVoiceControlButtonClicked();         // 语音控制按钮 槽函数
+    void onMetricsButtonClicked();              // 话题统计按钮 槽函数
+    void onTopicsButtonClicked();               // 话题列表按钮 槽函数
+    void onRecordButtonClicked();               // 开始/停止录制当前机器人的会话
+    void onReplayButtonClicked();               // 打开录制文件回放
+    void onRobotSelected(int index);            // 切换当前显示的机器人
 
-    // webSocket 相关槽函数
-    void onWebSocketConnected();            // 连接webSocket
-    void onWebSocketDisconnected();
-    void onWebSocketError(const QString &error);
-    void establishWebSocketConnection(const QString &url);
-    void tryReconnect();
+    // webSocket 相关槽函数（每个机器人一个连接，以 url 区分）
+    void onRobotOpened(const QString &url, WebSocketWorker *worker);
+    void onRobotClosing(const QString &url, WebSocketWorker *worker);
+    void onWebSocketConnected(const QString &url);
+    void onWebSocketDisconnected(const QString &url);
+    void onWebSocketError(const QString &url, const QString &error);
+    void establishWebSocketConnection(const QStringList &urls);
+    void onWebSocketReconnecting(const QString &url, int attempt, int delayMs);
 
 protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
-private:        
+private:
+    // 每个机器人的一组监视器，数据只在该机器人被选中时显示
+    struct RobotSession {
+        WebSocketWorker *worker = nullptr;
+        BatteryMonitor *batteryMonitor = nullptr;   // 电量获取对象
+        ImuMonitor *imuMonitor = nullptr;           // IMU获取对象
+        CameraImageMonitor *cameraImageMonitor = nullptr;
+        QString status;                             // 连接状态文本
+        int batteryLevel = 0;
+        bool recording = false;                     // 是否正在录制会话
+    };
+
     void settingStatusBar();
     void updateStatusLabel(const QString &status);  // 更新连接显示标签
+    void setRobotStatus(const QString &url, const QString &status);
     void bindSlots();                               // 绑定槽函数
     void init();
-    void startSubscriptions();                     // 启动话题订阅
+    void startSubscriptions(const RobotSession &session);  // 启动话题订阅
+    void destroyRobotSession(const QString &url);
+    RobotSession *currentSession();
+    void showImu(const ImuSample &sample);          // 显示 IMU 数据
+    void updateRecordButton();                      // 按当前机器人的录制状态更新按钮文字
 
 private:
     Ui_robanweb* ui;
-    WebSocketWorker *webSocketWorker;
-    QThread *webSocketThread;       // webSocket 线程
-    QThread *imageThread;           // 图像处理线程
-    QTimer *reconnectTimer;
-    QString wsHost;
-    QString wsPort;
+    ConnectionManager *connectionManager;       // 多机器人连接，每个机器人一个 worker 线程
+    QMap<QString, RobotSession> robots;         // url -> 监视器集合
+    QString currentRobot;                       // 当前显示的机器人 url
 
-    
-    bool isReconnecting;
-    int reconnectAttempts;
-    static const int MAX_RECONNECT_ATTEMPTS = 10;
     QLabel *connect_label;                      // 连接状态标签
+    QComboBox *robotSelector = nullptr;         // 机器人选择
     QProgressBar *batteryProgressBar;           // 电量进度条
-    BatteryMonitor *batteryMonitor = nullptr;   // 电量获取对象
-    ImuMonitor *imuMonitor = nullptr;           // IMU获取对象
-    
-    CameraImageMonitor *cameraImageMonitor = nullptr;
-    QTimer *imagePullTimer = nullptr;           // 定时器，用于从相机监视器中获取最新帧
+    QTimer *imagePullTimer = nullptr;           // 定时器，用于从当前机器人的相机监视器和 IMU 信箱中获取最新数据
+    QPointer<QDialog> metricsDialog;            // 话题统计面板（非模态，关闭时自动删除）
+    QPointer<QDialog> topicBrowserDialog;       // 话题列表（非模态，关闭时自动删除）
 
 };
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <QDir>
 #include <QFile>
 
+#include "socket_process/rosmessage.h"
+
 class WebSocketWorker;
 
 class BatteryMonitor : public QObject {
@@ -21,7 +23,7 @@ public:
 
 public slots:
     void start(); // send subscribe request via worker
-    void onMessageReceived(const QString &message);
+    void onRosMessage(const RosMessage &message);
 
 signals:
     void batteryLevelChanged(int percent);
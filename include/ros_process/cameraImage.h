@@ -19,6 +19,10 @@
 #include <QElapsedTimer>
 #include <QSize>
 
+#include "socket_process/rosmessage.h"
+#include "socket_process/rosmsgs.h"
+#include "util/messagestamps.h"
+
 class WebSocketWorker;
 
 class CameraImageMonitor : public QObject {
@@ -30,7 +34,7 @@ explicit CameraImageMonitor(WebSocketWorker *worker, QObject *parent = nullptr,
 public slots:
     void start(); // send subscribe request via worker
     void stop(); // send unsubscribe request via worker
-    void onMessageReceived(const QString &message);
+    void onRosMessage(const RosMessage &message);
     void requestFrame(); // main thread requests the latest decoded frame (emitted back)
     void setTargetSize(const QSize &size); // desired display size (worker will scale to this)
     void setMaxFps(int fps); // throttle maximum frame rate emitted to UI
@@ -48,7 +52,10 @@ private:
     int m_frameIntervalMs = 33; // default ~30 FPS
     QElapsedTimer m_lastDecodeTimer;
     QImage m_latestImage;
+    MessageStamps m_latestStamps;           // m_latestImage 对应消息的时间点
     QMutex m_latestMutex;
+    rosmsg::CompressedImage m_compressed;   // 解码结果，data 缓冲区逐帧复用
+    rosmsg::Image m_raw;
     QString *topic_name;
     QString cameraCompressed_topic_name;    // Camera话题名称(压缩)
     QString cameraCompressed_topic_type;    // Camera话题类型(压缩)
@@ -64,6 +71,7 @@ private:
 
     QString act_topic_name;                 // 实际使用话题名称
     QString act_topic_type;                 // 实际使用话题类型
+    bool m_compressedMode = true;           // act_topic_type 为 CompressedImage 时按压缩图像解码，否则按原始像素
 };
 
 
@@ -8,8 +8,18 @@
 #include <QDebug>
 #include <QMetaObject>
 
+#include "socket_process/rosmessage.h"
+#include "socket_process/rosmsgs.h"
+#include "util/latestmailbox.h"
+
 class WebSocketWorker;
 
+// 最新一条 IMU 消息；seen 为出现过的字段位（TypedDecoder::fieldBit<rosmsg::Imu>）
+struct ImuSample {
+    rosmsg::Imu imu;
+    quint32 seen = 0;
+};
+
 class ImuMonitor : public QObject {
     Q_OBJECT
 public:
@@ -18,16 +28,16 @@ public:
 
 public slots:
     void start(); // send subscribe request via worker
-    void onMessageReceived(const QString &message);
+    void onRosMessage(const RosMessage &message);
 
-signals:
-    void orientationUpdated(double w, double x, double y, double z);
-    void angularVelocityUpdated(double x, double y, double z);
-    void linearAccelerationUpdated(double x, double y, double z);
+public:
+    // IMU 频率远高于界面刷新，只保留最新值，由界面定时取走
+    LatestMailbox<ImuSample> &mailbox() { return m_mailbox; }
 
 private:
     WebSocketWorker *m_worker;
     QString imu_topic_name; // IMU话题名称
+    LatestMailbox<ImuSample> m_mailbox;
 };
 
 
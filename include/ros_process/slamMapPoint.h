@@ -11,14 +11,31 @@
 #include <QList>
 #include <QVector3D>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QtGlobal>
 #include <QJsonArray>
 #include <QBuffer>
 #include <QCryptographicHash>
 
+#include "socket_process/rosmessage.h"
+#include "socket_process/rosmsgs.h"
+#include "util/latestmailbox.h"
+
 
 class WebSocketWorker;
 
+// 关键帧标记解析结果：points 为点，lines 按顺序两两组成线段
+struct KeyFrameMarkers {
+    QList<QVector3D> points;
+    QList<QVector3D> lines;
+};
+
+// 相机位置：pos 为相机中心的世界坐标，dir 为朝向（单位向量）
+struct CameraPose {
+    QVector3D pos;
+    QVector3D dir;
+};
+
 class SlamMapMonitor : public QObject {
     Q_OBJECT
 public:
@@ -28,30 +45,34 @@ public:
 public slots:
     void start();
     void stop();
-    void onMessageReceived(const QString &message);
+    void onRosMessage(const RosMessage &message);
+
+public:
+    // 点云、关键帧标记、相机矩阵、相机位置只保留最新值，由显示端定时取走（旧数据被新数据覆盖，不在事件队列中积压）
+    LatestMailbox<QList<QVector3D>> &pointCloudMailbox() { return m_pointCloudMailbox; }
+    LatestMailbox<KeyFrameMarkers> &keyFrameMailbox() { return m_keyFrameMailbox; }
+    LatestMailbox<QVector<double>> &cameraMatrixMailbox() { return m_cameraMatrixMailbox; }
+    LatestMailbox<CameraPose> &cameraPoseMailbox() { return m_cameraPoseMailbox; }
 
 signals:
-    void pointCloudReceived(const QList<QVector3D> &points);
     // Emitted when a keyframe message arrives (raw JSON object from rosbridge)
     void keyFrameReceived(const QJsonObject &msg);
-    // parsed marker arrays: points and line segments (pairs in lines list should be interpreted sequentially)
-    void keyFrameMarkers(const QList<QVector3D> &points, const QList<QVector3D> &lines);
-    // Emitted when an OpenGL camera matrix (Float64MultiArray) is received
-    void cameraMatrixReceived(const QList<double> &matrix);
-    // Emitted when a geometry_msgs/PoseStamped camera pose is received.
-    // pos: world position of camera center; dir: forward direction vector (unit) in world coords
-    void cameraPoseReceived(const QVector3D &pos, const QVector3D &dir);
 
 private:
     void loadTopicFromParams();
 
-    QList<QVector3D> parsePointCloud(const QJsonObject &msgObj);    // 解析点云数据
+    QList<QVector3D> parsePointCloud(const RosMessage &message);    // 解析点云数据
     void parseKeyFrame(const QJsonObject &msg);                     // 解析关键帧数据
-    void parseOpenGLMatrix(const QJsonObject &msg);                 // 解析OpenGL矩阵数据
-    void parseCameraPose(const QJsonObject &msg);                   // 解析相机位置数据
+    void parseOpenGLMatrix(const RosMessage &message);              // 解析OpenGL矩阵数据
+    void parseCameraPose(const RosMessage &message);                // 解析相机位置数据
 
 private:
     WebSocketWorker *m_worker;
+    rosmsg::PointCloud2 m_cloud;            // 点云解码结果，data 缓冲区逐帧复用
+    LatestMailbox<QList<QVector3D>> m_pointCloudMailbox;
+    LatestMailbox<KeyFrameMarkers> m_keyFrameMailbox;
+    LatestMailbox<QVector<double>> m_cameraMatrixMailbox;
+    LatestMailbox<CameraPose> m_cameraPoseMailbox;
     QString slamPoint_topic_name;
     QString slamPoint_topic_type;
     QString slamKeyFrame_topic_name;
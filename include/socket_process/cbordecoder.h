@@ -0,0 +1,33 @@
+#ifndef CBORDECODER_H
+#define CBORDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QCborValue>
+#include <QCborMap>
+#include <QCborArray>
+#include <QDebug>
+
+#include "socket_process/rosmessage.h"
+
+// rosbridge 二进制帧解码（subscribe 时 compression 为 "cbor" / "cbor-raw"）
+//  cbor:     整条消息为 CBOR map，uint8[] 为字节串，其他数值数组为 RFC 8746 类型化数组
+//  cbor-raw: msg 为 {secs, nsecs, bytes}，bytes 是 ROS1 序列化后的原始消息
+// msg.data 的原始字节直接放入 RosMessage::data，不再经过 base64 或 JSON 整数数组
+class CborDecoder
+{
+public:
+    // topicTypes: 话题 -> 消息类型，cbor-raw 需要按类型反序列化
+    // 返回 false 表示不是可分发的 publish 消息
+    static bool decode(const QByteArray &frame, const QHash<QString, QString> &topicTypes, RosMessage *out);
+
+private:
+    static QJsonValue toJson(const QCborValue &value);
+    static bool decodeRaw(const QByteArray &bytes, const QString &type, RosMessage *out);
+};
+
+#endif // CBORDECODER_H
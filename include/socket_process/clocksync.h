@@ -0,0 +1,78 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <QObject>
+#include <QTimer>
+#include <QMutex>
+#include <QVector>
+#include <QString>
+#include <QDebug>
+
+#include "socket_process/rosapi.h"
+#include "socket_process/rosmsgs.h"
+#include "util/messagestamps.h"
+
+class WebSocketWorker;
+
+// 机器人与本机的时钟同步（每个连接一个，由 WebSocketWorker 持有）
+// 按 NTP 的方式周期性调用 /rosapi/get_time：offset = 机器人时间 - (发出 + 收到) / 2，往返时间越短的样本越可信
+// 连接建立后先密集采样几次，之后每 SAMPLE_INTERVAL_MS 一次；样本跨度足够时用最小二乘估计漂移
+// get_time 返回的是 ROS 时间（use_sim_time 时为仿真时间），与消息 header.stamp 一致
+// 估计值可在任意线程读取；采样在 socket 线程中进行
+class ClockSync : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ClockSync(WebSocketWorker *worker);
+
+    struct Estimate {
+        bool valid = false;
+        qint64 offsetUs = 0;    // 机器人时钟 - 本机时钟（在 referenceUs 时刻）
+        double drift = 0;       // 偏差的变化率（微秒/微秒），正值表示机器人时钟走得快
+        qint64 referenceUs = 0; // 估计所在的本机时刻
+        qint64 rttUs = 0;       // 所用样本中最短的往返时间，也是偏差误差的上界
+        int samples = 0;
+    };
+
+    Estimate estimate() const;
+    bool isSynced() const { return estimate().valid; }
+
+    // 机器人时间（微秒，自 epoch）换算为本机时间；尚未同步时返回 0
+    qint64 toLocalUs(qint64 robotUs) const;
+    qint64 toLocalUs(const rosmsg::Time &stamp) const;
+
+    // 监视器解码出 header 后调用：填好三个时间点中的前两个，并把传输延迟记到话题的统计项上（RosMessage::metrics）
+    MessageStamps stampMessage(TopicMetrics::Entry *metrics, const rosmsg::Header &header, qint64 receivedUs) const;
+
+    static const int BURST_SAMPLES = 8;             // 连接建立后的密集采样次数
+    static const int BURST_INTERVAL_MS = 200;
+    static const int SAMPLE_INTERVAL_MS = 5000;
+    static const int MAX_SAMPLES = 32;              // 参与估计的最近样本数
+
+public slots:
+    void start();   // 连接建立后由 worker 调用，清空旧样本（机器人可能已重启）
+    void stop();
+
+private:
+    struct Sample {
+        qint64 localUs;     // 发出与收到的中点
+        qint64 offsetUs;
+        qint64 rttUs;
+    };
+
+    void poll();
+    void addSample(const RosApi::Time &time);
+    void updateEstimate();
+
+    WebSocketWorker *m_worker;
+    QTimer *m_timer = nullptr;
+    bool m_inFlight = false;
+    bool m_unavailableLogged = false;
+    int m_burstLeft = 0;
+    QVector<Sample> m_samples;      // 只在 socket 线程中访问
+
+    mutable QMutex m_mutex;
+    Estimate m_estimate;
+};
+
+#endif // CLOCKSYNC_H
@@ -0,0 +1,58 @@
+#ifndef CONNECTIONMANAGER_H
+#define CONNECTIONMANAGER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMap>
+#include <QStringList>
+#include <QDebug>
+
+#include "socket_process/websocketworker.h"
+#include "socket_process/replaysource.h"
+
+// 多机器人连接管理：每个机器人（url）对应一个 WebSocketWorker，各自运行在独立的 QThread 中
+// 只在主线程中使用
+class ConnectionManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ConnectionManager(QObject *parent = nullptr);
+    ~ConnectionManager();
+
+    // 连接机器人，已存在时直接返回已有的 worker
+    WebSocketWorker *open(const QString &url);
+    // 回放录制的会话，以 "replay://文件名" 作为 url 与在线机器人一样管理
+    // 调用方连接好 ReplaySource 的信号后再（跨线程）调用其 open(path)，打开后处于暂停状态
+    ReplaySource *openReplay(const QString &path);
+    // 断开并销毁机器人连接；销毁前发出 robotClosing，使用该 worker 的监视器需在此时释放
+    void close(const QString &url);
+    void closeAll();
+
+    WebSocketWorker *worker(const QString &url) const;
+    ReplaySource *replay(const QString &url) const;     // 不是回放时返回 nullptr
+    QStringList urls() const { return m_connections.keys(); }
+    bool contains(const QString &url) const { return m_connections.contains(url); }
+    bool isConnected(const QString &url) const;
+
+signals:
+    void robotOpened(const QString &url, WebSocketWorker *worker);
+    void robotClosing(const QString &url, WebSocketWorker *worker);
+    void robotConnected(const QString &url);
+    void robotDisconnected(const QString &url);
+    void robotReconnecting(const QString &url, int attempt, int delayMs);
+    void robotError(const QString &url, const QString &error);
+
+private:
+    struct Connection {
+        WebSocketWorker *worker = nullptr;
+        QThread *thread = nullptr;
+        ReplaySource *replay = nullptr;
+        bool connected = false;
+    };
+
+    Connection createConnection(const QString &url, bool replay = false);
+
+    QMap<QString, Connection> m_connections;    // url -> 连接
+};
+
+#endif // CONNECTIONMANAGER_H
@@ -0,0 +1,64 @@
+#ifndef DECODEEXECUTOR_H
+#define DECODEEXECUTOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QPair>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QThreadPool>
+#include <QString>
+#include <functional>
+
+#include "util/topicmetrics.h"
+
+// 解码执行器：所有机器人共享的线程池（线程数 = CPU 核数），替代每个监视器固定的 QThread
+// 任务按 (处理对象, 话题) 分成串行队列（strand）：同一队列的任务按提交顺序逐个执行，不同话题/对象并行
+// 丢弃策略按话题设置（setMaxPending，来自 topic_qos 的 decode_queue）：传感器流积压超过上限时丢弃最旧的任务
+// （记为该话题的丢弃），始终处理最新的消息；未设置上限的话题（电池状态等）不丢弃，按顺序全部执行
+// 可在任意线程调用
+class DecodeExecutor
+{
+public:
+    static DecodeExecutor &instance();
+
+    // 提交任务；owner 为处理对象，topic 用于分队列和丢弃统计
+    void post(QObject *owner, const QString &topic, std::function<void()> job);
+    // 丢弃 owner 所有待执行的任务，并等待其正在执行的任务结束（在任务内部调用时不等待自己）
+    void cancel(QObject *owner);
+
+    // 设置话题的积压上限，0 表示不丢弃；对已有队列立即生效
+    void setMaxPending(const QString &topic, int maxPending);
+
+    int threadCount() const;
+
+    static const int MAX_BATCH = 8;     // 一个队列连续执行的任务数，之后让出线程给其他队列
+
+private:
+    DecodeExecutor();
+    Q_DISABLE_COPY(DecodeExecutor)
+
+    struct Strand {
+        QObject *owner = nullptr;
+        QString topic;
+        QQueue<std::function<void()>> jobs;
+        int maxPending = 0;             // 0 表示不丢弃
+        TopicMetrics::Entry *metrics = nullptr;     // 丢弃计数记到这里
+        bool scheduled = false;         // 已交给线程池（排队或执行中）
+        bool cancelled = false;
+        QThread *runner = nullptr;      // 正在执行任务的线程
+    };
+    using StrandKey = QPair<QObject *, QString>;
+
+    void drain(Strand *strand);
+
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    QWaitCondition m_jobFinished;
+    QHash<StrandKey, Strand *> m_strands;
+    QHash<QString, int> m_maxPending;   // 话题 -> 积压上限
+};
+
+#endif // DECODEEXECUTOR_H
@@ -0,0 +1,21 @@
+#ifndef ENVELOPEPREFILTER_H
+#define ENVELOPEPREFILTER_H
+
+#include <QString>
+#include <QStringView>
+#include <QLatin1String>
+#include <QByteArray>
+
+// 信封预过滤：不构建 JSON/CBOR DOM，只扫描帧开头找出 "op" 和 "topic" 字段，
+// 让没有处理对象的话题在任何解析和内存分配之前就被丢弃
+class EnvelopePrefilter
+{
+public:
+    // 文本帧；返回是否找到 op，topic 可能为空（不在信封开头或不存在）
+    // 返回的视图指向 frame 内部
+    static bool peek(QStringView frame, QStringView *op, QStringView *topic);
+    // 二进制 CBOR 帧（cbor/cbor-raw），op/topic 为 ASCII 文本视图
+    static bool peekCbor(const QByteArray &frame, QLatin1String *op, QLatin1String *topic);
+};
+
+#endif // ENVELOPEPREFILTER_H
@@ -0,0 +1,42 @@
+#ifndef FRAGMENTASSEMBLER_H
+#define FRAGMENTASSEMBLER_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// rosbridge 分片拼接（op:"fragment"，{id, data, num, total}）
+// 同一 id 的分片写入一块预分配的缓冲区，超时未收齐的分片组会被丢弃
+// 只在 socket 线程中使用
+class FragmentAssembler
+{
+public:
+    explicit FragmentAssembler(int timeoutMs = 5000);
+
+    // 加入一个分片；当该 id 的全部分片收齐时返回 true，并把完整消息写入 complete
+    bool add(const QString &id, int num, int total, const QString &data, QString *complete);
+    // 丢弃超时未完成的分片组，返回丢弃的组数
+    int purgeExpired();
+    int pendingCount() const { return m_pending.size(); }
+
+private:
+    struct Pending {
+        QString buffer;             // 预分配的完整消息缓冲区
+        QVector<bool> received;     // 已收到的分片
+        QHash<int, QString> early;  // 分片长度确定前到达的最后一个分片
+        int total = 0;
+        int count = 0;              // 已收到的分片数
+        qsizetype chunk = -1;       // 非最后分片的长度（rosbridge 按固定长度切分）
+        qsizetype lastLen = -1;     // 最后一个分片的长度
+        QElapsedTimer age;
+    };
+
+    static void place(Pending &p, int num, const QString &data);
+
+    QHash<QString, Pending> m_pending;
+    int m_timeoutMs;
+};
+
+#endif // FRAGMENTASSEMBLER_H
@@ -0,0 +1,97 @@
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// 拉取式 JSON 解析器：直接在 UTF-8 帧字节上逐个读取键和值，不构建 QJsonDocument/QJsonObject
+// 字符串以视图形式返回（指向原缓冲区，不处理转义），数值数组直接写入类型化的输出缓冲区
+// 缓冲区必须在读取期间保持有效；格式错误时 hasError() 为 true，之后所有读取都返回 false
+//
+// 典型用法：
+//   JsonReader r(json);
+//   r.beginObject();
+//   QByteArrayView key;
+//   while (r.nextKey(&key)) {
+//       if (JsonReader::equals(key, "x")) r.readDouble(&x);
+//       else r.skipValue();
+//   }
+class JsonReader
+{
+public:
+    enum Type {
+        Invalid = 0,    // 格式错误或已读到末尾
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    JsonReader(const char *begin, const char *end) : m_begin(begin), m_p(begin), m_end(end) {}
+    explicit JsonReader(QByteArrayView json) : JsonReader(json.data(), json.data() + json.size()) {}
+
+    Type peek();                                    // 下一个值的类型（跳过空白和逗号）
+
+    bool beginObject();                             // 消费 '{'
+    // 读取下一个键并消费 ':'；对象结束时消费 '}' 并返回 false
+    bool nextKey(QByteArrayView *key);
+    // 在当前对象中向后查找键（跳过其他值），找到时停在其值之前；未找到时对象已被读完
+    bool findKey(const char *key);
+
+    bool beginArray();                              // 消费 '['
+    // 数组中还有元素时返回 true；数组结束时消费 ']' 并返回 false
+    bool nextElement();
+
+    bool readString(QByteArrayView *raw);           // 引号内的原始字节，不处理转义
+    bool readString(QString *out);                  // 处理转义后的字符串
+    bool readDouble(double *out);
+    bool readInt(qint64 *out);
+    bool readBool(bool *out);
+    bool readNull();
+    bool skipValue();                               // 跳过任意值（含嵌套对象/数组）
+
+    // 把数值数组直接读入 out（追加），元素按 T 转换
+    template <typename T>
+    bool readNumberArray(QVector<T> *out);
+    // uint8[] 的整数数组（如 [12, 255, 0]）直接写成字节追加到 out，逐字符扫描，不经过 double
+    bool readByteArray(QByteArray *out);
+
+    qsizetype offset() const { return m_p - m_begin; }   // 当前读取位置（相对缓冲区起点）
+    bool atEnd() { skipSpace(); return m_p >= m_end; }
+    bool hasError() const { return m_error; }
+
+    static bool equals(QByteArrayView view, const char *literal);
+    static QString unescape(QByteArrayView raw);    // 解码 JSON 字符串转义（\n、\uXXXX 等）
+
+private:
+    void skipSpace();
+    void skipSeparator();       // 跳过空白和一个可选的 ','
+    bool fail();
+    bool scanString(const char **begin, const char **end);
+    bool scanNumber(double *out);
+    bool expectLiteral(const char *literal, qsizetype length);
+
+    const char *m_begin;
+    const char *m_p;
+    const char *m_end;
+    bool m_error = false;
+};
+
+template <typename T>
+bool JsonReader::readNumberArray(QVector<T> *out)
+{
+    if (!beginArray()) return false;
+    double v = 0;
+    while (nextElement()) {
+        if (!readDouble(&v)) return false;
+        out->append(static_cast<T>(v));
+    }
+    return !m_error;
+}
+
+#endif // JSONREADER_H
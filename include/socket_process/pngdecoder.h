@@ -0,0 +1,22 @@
+#ifndef PNGDECODER_H
+#define PNGDECODER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+// rosbridge png 压缩帧解码（subscribe 时 compression 为 "png"）
+// 服务端把整条 JSON 消息的字节当作 RGB 像素（不足一行用 '\n' 补齐）编码成 PNG，再 base64 后发送：
+//   {"op": "png", "data": "<base64 PNG>"}
+// 这里还原出原始 JSON 文本，交回文本帧的处理流程（可能是 publish，也可能是 fragment）
+// 重复性高的话题（如 MarkerArray）传输量可降到原来的约十分之一，代价是两端的压缩/解压耗时
+class PngDecoder
+{
+public:
+    // frame 为整条 png 帧；成功时 json 为还原出的 JSON 文本
+    static bool decode(const QString &frame, QString *json);
+    // data 为 base64 编码的 PNG
+    static bool decodeData(QByteArrayView base64, QByteArray *json);
+};
+
+#endif // PNGDECODER_H
@@ -0,0 +1,75 @@
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QStringList>
+#include <QVector>
+#include <QDebug>
+
+#include "socket_process/sessionreader.h"
+
+class WebSocketWorker;
+
+// 会话回放：代替 socket，把录制文件中的帧按原来的时间间隔注入 WebSocketWorker 的接收路径，
+// 之后的预过滤、分片/png、路由、解码线程池和监视器与在线时完全相同，可以不连机器人复现现场的卡顿
+// speed 为 1 按原速，N 为 N 倍速，0 为不等待、尽快注入（用于测整条客户端流水线的吞吐）
+// 作为 worker 的子对象运行在 worker 线程中，槽函数跨线程用 QueuedConnection 调用
+// 跟不上原速时不丢帧，只是变慢；落后的最大时长记为 maxLagMs
+class ReplaySource : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ReplaySource(WebSocketWorker *worker);
+
+    static const int MAX_SLICE_MS = 5;          // 一次连续注入的最长时间，之后让出事件循环
+    static const int PROGRESS_INTERVAL_MS = 100;
+
+    struct Stats {
+        quint64 frames = 0;     // 本次播放注入的帧数
+        quint64 bytes = 0;
+        qint64 elapsedMs = 0;   // 本次播放的墙钟时间
+        qint64 maxLagMs = 0;    // 注入时间落后于应到时间的最大值（倍速下按倍速后的时间）
+    };
+
+public slots:
+    void open(const QString &path);
+    void play();
+    void pause();
+    void setSpeed(double speed);
+    void seek(qint64 offsetUs);     // 相对录制中第一帧的时间
+
+signals:
+    void opened(const QString &url, qint64 durationUs, quint64 frames, const QStringList &topics);
+    void openFailed(const QString &error);
+    void playingChanged(bool playing);
+    void positionChanged(qint64 offsetUs);
+    // 播放到文件末尾；吞吐 = frames / elapsedMs
+    void finished(quint64 frames, quint64 bytes, qint64 elapsedMs, qint64 maxLagMs);
+
+private:
+    void pump();
+    bool loadChunk(int index);
+    bool atEnd() const { return m_next >= m_frames.size() && m_chunk + 1 >= m_reader.chunks().size(); }
+    void anchor();      // 以当前帧为起点重新计算时间基准（开始播放、改速度、跳转后）
+    void reportPosition(bool force);
+
+    QPointer<WebSocketWorker> m_worker;
+    SessionReader m_reader;
+    QVector<SessionReader::Frame> m_frames;     // 当前块的帧
+    int m_chunk = -1;
+    int m_next = 0;                             // 当前块中下一帧
+    bool m_playing = false;
+    double m_speed = 1.0;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;                      // 时间基准：m_clock 起点对应录制时间 m_anchorUs
+    qint64 m_anchorUs = 0;
+    qint64 m_positionUs = 0;                    // 最近注入帧的录制时间
+    QElapsedTimer m_progressTimer;
+    QElapsedTimer m_playTimer;
+    Stats m_stats;
+};
+
+#endif // REPLAYSOURCE_H
@@ -0,0 +1,56 @@
+#ifndef ROSAPI_H
+#define ROSAPI_H
+
+#include <QString>
+#include <QList>
+#include <QFuture>
+
+#include "socket_process/rosmsgs.h"
+
+class WebSocketWorker;
+
+struct RosTopicInfo {
+    QString name;
+    QString type;       // 服务端未返回类型时为空，可再用 RosApi::topicType 查询
+};
+
+// rosapi 节点的常用查询（rosbridge 启动时一般同时启动 rosapi），基于 WebSocketWorker::callService
+// 全部为异步调用，结果在 QFuture 中；需要批量查询时可同时发出多个请求
+//
+//   RosApi::topics(worker).then(this, [this](const RosApi::TopicList &list) { ... });
+class RosApi
+{
+public:
+    static const int DEFAULT_TIMEOUT_MS = 3000;
+
+    struct TopicList {
+        bool ok = false;
+        QString error;
+        QList<RosTopicInfo> topics;
+        qint64 elapsedUs = 0;
+    };
+
+    struct TopicType {
+        bool ok = false;
+        QString error;
+        QString topic;
+        QString type;
+    };
+
+    // 机器人时间；sentAtUs/receivedAtUs 为本机发出请求和收到应答的时间，用于估计时钟偏差（ClockSync）
+    struct Time {
+        bool ok = false;
+        QString error;
+        rosmsg::Time stamp;
+        qint64 sentAtUs = 0;
+        qint64 receivedAtUs = 0;
+        qint64 elapsedUs = 0;
+    };
+
+    static QFuture<TopicList> topics(WebSocketWorker *worker, int timeoutMs = DEFAULT_TIMEOUT_MS);             // /rosapi/topics
+    static QFuture<TopicType> topicType(WebSocketWorker *worker, const QString &topic,
+                                        int timeoutMs = DEFAULT_TIMEOUT_MS);                                   // /rosapi/topic_type
+    static QFuture<Time> getTime(WebSocketWorker *worker, int timeoutMs = DEFAULT_TIMEOUT_MS);                 // /rosapi/get_time
+};
+
+#endif // ROSAPI_H
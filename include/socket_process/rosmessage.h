@@ -0,0 +1,39 @@
+#ifndef ROSMESSAGE_H
+#define ROSMESSAGE_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QMetaType>
+
+#include "util/topicmetrics.h"
+
+// rosbridge 消息信封：TopicRouter 只解析一次，再把 msg 部分分发给关心该话题的监视器
+// JSON 文本帧不再构建 QJsonObject：json 保存整帧 UTF-8 字节，msg 字段的位置由 msgOffset/msgLength 给出，
+// 监视器可用 JsonReader 直接在 msgJson() 上解析，需要 DOM 时再调用 msgObject()
+struct RosMessage
+{
+    QString topic;      // 话题名称
+    QJsonObject msg;    // 二进制传输（cbor/cbor-raw）解码得到的 msg 字段；JSON 文本帧时为空
+    QByteArray data;    // 二进制传输（cbor/cbor-raw）时 msg.data 的原始字节，此时 msg 中不含 data
+    QByteArray json;    // JSON 文本帧的 UTF-8 字节（隐式共享，多个监视器之间不复制）
+    qsizetype msgOffset = 0;    // msg 字段的值在 json 中的起始位置
+    qsizetype msgLength = 0;
+    qint64 receivedUs = 0;      // socket 线程收到该帧的本机时间（微秒，自 epoch），用于延迟统计
+    TopicMetrics::Entry *metrics = nullptr;     // 该话题的统计项，由 TopicRouter 填写；直接构造的消息为空，此时不记录
+
+    bool hasJson() const { return msgLength > 0; }
+    QByteArrayView msgJson() const { return QByteArrayView(json.constData() + msgOffset, msgLength); }
+    // 按需构建 msg 的 QJsonObject（慢路径，供尚未改用 JsonReader 的处理代码使用）
+    QJsonObject msgObject() const
+    {
+        if (!hasJson()) return msg;
+        return QJsonDocument::fromJson(QByteArray::fromRawData(json.constData() + msgOffset, msgLength)).object();
+    }
+};
+
+Q_DECLARE_METATYPE(RosMessage)
+
+#endif // ROSMESSAGE_H
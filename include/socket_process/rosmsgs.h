@@ -0,0 +1,252 @@
+#ifndef ROSMSGS_H
+#define ROSMSGS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <tuple>
+
+// 订阅的 ROS 消息类型对应的普通结构体，以及编译期字段表 RosFields<T>
+// 字段表只列出需要的字段（JSON 键名 -> 成员），其余键在解码时直接跳过
+// TypedDecoder（typeddecoder.h）按字段表生成专用解码器，每条消息不再做 QJsonObject 键查找
+//
+// 新增类型：定义结构体，再特化 RosFields，例如
+//   template <> struct RosFields<rosmsg::Vector3> {
+//       static constexpr auto fields = std::make_tuple(rosField("x", &rosmsg::Vector3::x), ...);
+//   };
+
+template <typename S, typename M>
+struct RosField
+{
+    const char *name;
+    qsizetype length;
+    M S::*member;
+};
+
+template <typename S, typename M, std::size_t N>
+constexpr RosField<S, M> rosField(const char (&name)[N], M S::*member)
+{
+    return RosField<S, M>{name, qsizetype(N - 1), member};
+}
+
+template <typename T>
+struct RosFields {};    // 每个消息结构体特化一份，未特化的类型没有字段表
+
+namespace rosmsg {
+
+// std_msgs/Header：ROS1 的时间戳为 secs/nsecs，ROS2 为 sec/nanosec，两种键名都接受
+struct Time
+{
+    qint64 sec = 0;
+    qint64 nanosec = 0;
+};
+
+struct Header
+{
+    Time stamp;
+    QString frame_id;
+};
+
+struct Vector3
+{
+    double x = 0, y = 0, z = 0;
+};
+
+struct Quaternion
+{
+    double x = 0, y = 0, z = 0, w = 1;
+};
+
+struct Pose
+{
+    Vector3 position;           // geometry_msgs/Point 与 Vector3 字段相同
+    Quaternion orientation;
+};
+
+// geometry_msgs/PoseStamped
+struct PoseStamped
+{
+    Header header;
+    Pose pose;
+};
+
+// sensor_msgs/Imu（协方差矩阵不使用，跳过）
+struct Imu
+{
+    Header header;
+    Quaternion orientation;
+    Vector3 angular_velocity;
+    Vector3 linear_acceleration;
+};
+
+// sensor_msgs/BatteryState（只列出 BatteryMonitor 使用的字段，其余字段解码时跳过；
+// charge/capacity/current/percentage 常为 NaN，rosbridge 以 null 发送）
+struct BatteryState
+{
+    double voltage = 0;
+};
+
+// std_msgs/Float64MultiArray（layout 不使用，跳过）
+struct Float64MultiArray
+{
+    QVector<double> data;
+};
+
+// sensor_msgs/PointField
+struct PointField
+{
+    QString name;
+    qint64 offset = 0;
+    qint64 datatype = 0;
+    qint64 count = 0;
+};
+
+// sensor_msgs/PointCloud2；uint8[] 字段（data）为 QByteArray，解码时复用其容量
+struct PointCloud2
+{
+    Header header;
+    qint64 height = 0;
+    qint64 width = 0;
+    QVector<PointField> fields;
+    bool is_bigendian = false;
+    qint64 point_step = 0;
+    qint64 row_step = 0;
+    QByteArray data;
+    bool is_dense = false;
+};
+
+// sensor_msgs/CompressedImage
+struct CompressedImage
+{
+    Header header;
+    QString format;
+    QByteArray data;
+};
+
+// sensor_msgs/Image
+struct Image
+{
+    Header header;
+    qint64 height = 0;
+    qint64 width = 0;
+    QString encoding;
+    bool is_bigendian = false;
+    qint64 step = 0;
+    QByteArray data;
+};
+
+} // namespace rosmsg
+
+template <> struct RosFields<rosmsg::Time>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("secs", &rosmsg::Time::sec),
+        rosField("nsecs", &rosmsg::Time::nanosec),
+        rosField("sec", &rosmsg::Time::sec),
+        rosField("nanosec", &rosmsg::Time::nanosec));
+};
+
+template <> struct RosFields<rosmsg::Header>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("stamp", &rosmsg::Header::stamp),
+        rosField("frame_id", &rosmsg::Header::frame_id));
+};
+
+template <> struct RosFields<rosmsg::Vector3>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("x", &rosmsg::Vector3::x),
+        rosField("y", &rosmsg::Vector3::y),
+        rosField("z", &rosmsg::Vector3::z));
+};
+
+template <> struct RosFields<rosmsg::Quaternion>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("x", &rosmsg::Quaternion::x),
+        rosField("y", &rosmsg::Quaternion::y),
+        rosField("z", &rosmsg::Quaternion::z),
+        rosField("w", &rosmsg::Quaternion::w));
+};
+
+template <> struct RosFields<rosmsg::Pose>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("position", &rosmsg::Pose::position),
+        rosField("orientation", &rosmsg::Pose::orientation));
+};
+
+template <> struct RosFields<rosmsg::PoseStamped>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("header", &rosmsg::PoseStamped::header),
+        rosField("pose", &rosmsg::PoseStamped::pose));
+};
+
+template <> struct RosFields<rosmsg::Imu>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("header", &rosmsg::Imu::header),
+        rosField("orientation", &rosmsg::Imu::orientation),
+        rosField("angular_velocity", &rosmsg::Imu::angular_velocity),
+        rosField("linear_acceleration", &rosmsg::Imu::linear_acceleration));
+};
+
+template <> struct RosFields<rosmsg::BatteryState>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("voltage", &rosmsg::BatteryState::voltage));
+};
+
+template <> struct RosFields<rosmsg::Float64MultiArray>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("data", &rosmsg::Float64MultiArray::data));
+};
+
+template <> struct RosFields<rosmsg::PointField>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("name", &rosmsg::PointField::name),
+        rosField("offset", &rosmsg::PointField::offset),
+        rosField("datatype", &rosmsg::PointField::datatype),
+        rosField("count", &rosmsg::PointField::count));
+};
+
+template <> struct RosFields<rosmsg::PointCloud2>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("header", &rosmsg::PointCloud2::header),
+        rosField("height", &rosmsg::PointCloud2::height),
+        rosField("width", &rosmsg::PointCloud2::width),
+        rosField("fields", &rosmsg::PointCloud2::fields),
+        rosField("is_bigendian", &rosmsg::PointCloud2::is_bigendian),
+        rosField("point_step", &rosmsg::PointCloud2::point_step),
+        rosField("row_step", &rosmsg::PointCloud2::row_step),
+        rosField("data", &rosmsg::PointCloud2::data),
+        rosField("is_dense", &rosmsg::PointCloud2::is_dense));
+};
+
+template <> struct RosFields<rosmsg::CompressedImage>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("header", &rosmsg::CompressedImage::header),
+        rosField("format", &rosmsg::CompressedImage::format),
+        rosField("data", &rosmsg::CompressedImage::data));
+};
+
+template <> struct RosFields<rosmsg::Image>
+{
+    static constexpr auto fields = std::make_tuple(
+        rosField("header", &rosmsg::Image::header),
+        rosField("height", &rosmsg::Image::height),
+        rosField("width", &rosmsg::Image::width),
+        rosField("encoding", &rosmsg::Image::encoding),
+        rosField("is_bigendian", &rosmsg::Image::is_bigendian),
+        rosField("step", &rosmsg::Image::step),
+        rosField("data", &rosmsg::Image::data));
+};
+
+#endif // ROSMSGS_H
@@ -0,0 +1,60 @@
+#ifndef SERVICECALLER_H
+#define SERVICECALLER_H
+
+#include <QString>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QPromise>
+#include <QMetaType>
+#include <memory>
+
+// call_service 的结果
+struct ServiceResponse {
+    bool ok = false;            // 服务端返回 result:true
+    QJsonValue values;          // 服务的返回值（通常为对象）
+    QString error;              // 失败原因：超时、断线或服务端返回的错误信息
+    QString service;
+    qint64 sentAtUs = 0;        // 请求登记时的本机时间（微秒，自 epoch）
+    qint64 receivedAtUs = 0;    // 收到应答时的本机时间
+    qint64 elapsedUs = 0;       // 发出请求到收到应答的耗时（单调时钟，微秒）
+};
+Q_DECLARE_METATYPE(ServiceResponse)
+
+// rosbridge call_service 的挂起请求表：按 id 匹配 service_response，超时未应答的请求以失败结束
+// 多个请求可同时在途，互不等待
+// 只在 socket 线程中使用；结果通过 QPromise 交给调用方的 QFuture
+class ServiceCaller
+{
+public:
+    using Promise = std::shared_ptr<QPromise<ServiceResponse>>;
+
+    // 登记一个请求，返回请求 id 和要发送的 call_service 文本
+    QString add(const QString &service, const QJsonObject &args, int timeoutMs, const Promise &promise, QString *request);
+    // 处理 op:"service_response"；id 不在表中（已超时等）时返回 false
+    bool complete(const QJsonObject &response);
+    // 结束超时的请求，返回结束的个数
+    int expire();
+    // 连接断开等情况下结束全部请求
+    void failAll(const QString &error);
+    int pendingCount() const { return m_pending.size(); }
+    bool isPending(const QString &id) const { return m_pending.contains(id); }
+
+private:
+    struct Pending {
+        Promise promise;
+        QString service;
+        qint64 sentAtUs = 0;
+        QElapsedTimer age;
+        int timeoutMs = 0;
+    };
+
+    static void finish(Pending &pending, ServiceResponse response);
+
+    QHash<QString, Pending> m_pending;
+    quint64 m_nextId = 0;
+};
+
+#endif // SERVICECALLER_H
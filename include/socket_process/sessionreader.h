@@ -0,0 +1,74 @@
+#ifndef SESSIONREADER_H
+#define SESSIONREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QDebug>
+
+#include "socket_process/sessionrecorder.h"
+
+// 读取 SessionRecorder 录制的文件（格式见 sessionrecorder.h）
+// open 时建立块表和话题表：正常关闭的文件按文件尾找到 TRLR 直接读块表，只读各块的 INDX 和 TOPC；
+// 未正常关闭（没有 TRLR）的文件顺序扫描块头（跳过帧内容），末尾不完整的块被忽略
+// 帧按块读入，回放时一次只需要一块在内存中
+// 不是线程安全的，由使用者（ReplaySource）在自己的线程中使用
+class SessionReader
+{
+public:
+    struct Frame {
+        qint64 receivedUs = 0;
+        SessionRecorder::FrameKind kind = SessionRecorder::TextFrame;
+        quint16 topicId = 0;
+        QByteArray data;
+    };
+
+    struct Chunk {
+        qint64 offset = 0;      // CHNK 块内容在文件中的偏移
+        qint64 length = 0;      // 块内容长度
+        qint64 firstUs = 0;
+        qint64 lastUs = 0;
+        quint32 count = 0;
+    };
+
+    bool open(const QString &path);
+    void close();
+    QString errorString() const { return m_error; }
+
+    QString url() const { return m_url; }
+    qint64 startUs() const { return m_startUs; }    // 开始录制的时间
+    qint64 firstUs() const { return m_chunks.isEmpty() ? 0 : m_chunks.first().firstUs; }
+    qint64 lastUs() const { return m_chunks.isEmpty() ? 0 : m_chunks.last().lastUs; }
+    quint64 frameCount() const { return m_frameCount; }
+
+    const QVector<Chunk> &chunks() const { return m_chunks; }
+    QString topicName(quint16 id) const { return m_topics.value(id); }  // 编号 0 返回空
+    QStringList topics() const;
+    quint64 topicFrameCount(quint16 id) const { return m_topicCounts.value(id); }   // 来自各块的 INDX
+
+    // 读出一块的全部帧
+    bool readChunk(int index, QVector<Frame> *out);
+    // 包含时间 us 的块（或其后的第一块）；us 晚于最后一帧时返回 -1
+    int chunkAt(qint64 us) const;
+
+private:
+    bool scan();
+    bool readTrailer(qint64 start, qint64 trailerOffset, qint64 size);
+    bool scanBlocks(qint64 pos, qint64 size);
+    void addTopic(const QByteArray &data);      // TOPC 内容
+    void addIndex(const QByteArray &data);      // INDX 内容，累计各话题帧数
+
+    QFile m_file;
+    QString m_error;
+    QString m_url;
+    qint64 m_startUs = 0;
+    quint64 m_frameCount = 0;
+    QVector<Chunk> m_chunks;
+    QHash<quint16, QString> m_topics;
+    QHash<quint16, quint64> m_topicCounts;
+};
+
+#endif // SESSIONREADER_H
@@ -0,0 +1,118 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// 会话录制：把 socket 收到的每一帧（文本或二进制，原样）连同接收时间写入文件，用于离线复现现场的性能问题
+// socket 线程只把帧放进内存队列（短暂加锁，不碰磁盘）；独立的写线程把帧编码成块，按块整体写入文件
+// 写线程跟不上、队列超过 MAX_PENDING_BYTES 时丢弃新帧并计数，不会阻塞 socket 线程
+//
+// 文件格式（小端，只追加；未正常关闭的文件按块顺序扫描仍可读出全部完整的块）：
+//   文件头   "RBWREC01" | i64 开始时间(us) | u32 长度 | url (UTF-8)
+//   之后为若干块，每块为 4 字节标签 + u32 块长度（不含这 8 字节）+ 内容，读取时可跳过不认识的块：
+//   TOPC     u16 话题编号 | 话题名 (UTF-8)；话题第一次出现时写在引用它的 CHNK 之前，编号 0 为无话题的帧（分片、png 等）
+//   CHNK     u32 帧数 | i64 首帧时间 | i64 末帧时间 | 帧...
+//            帧：i64 接收时间(us) | u8 类型(0 文本 / 1 二进制) | u16 话题编号 | u32 长度 | 帧字节
+//   INDX     紧跟在对应 CHNK 之后：u64 CHNK 在文件中的偏移 | u32 话题数 |
+//            每个话题：u16 编号 | u32 帧数 | i64 首帧时间 | i64 末帧时间 | u32 帧在块内容中的偏移 × 帧数
+//   TRLR     正常关闭时写入：u32 块数 | 每块：u64 CHNK 偏移 | u64 INDX 偏移 | i64 首帧时间 | i64 末帧时间 | u32 帧数
+//   文件尾   u64 TRLR 偏移 | "RBWEND01"
+class SessionRecorder
+{
+public:
+    enum FrameKind : quint8 {
+        TextFrame = 0,
+        BinaryFrame = 1
+    };
+
+    static const qint64 CHUNK_BYTES = 4 * 1024 * 1024;          // 块内容达到该大小时写出
+    static const int CHUNK_MAX_AGE_MS = 1000;                   // 块最长缓存时间
+    static const qint64 MAX_PENDING_BYTES = 256 * 1024 * 1024;  // 等待写线程处理的最大字节数
+
+    SessionRecorder();
+    ~SessionRecorder();     // 未停止时先 stop()
+
+    // 打开文件并启动写线程
+    bool start(const QString &path, const QString &url);
+    // 写出剩余的帧和 TRLR，等待写线程结束
+    void stop();
+    bool isRecording() const { return m_thread != nullptr; }
+    QString path() const { return m_path; }
+
+    // 记录一帧，在 socket 线程中调用；topic 为信封中的话题（没有时为空）
+    void record(FrameKind kind, qint64 receivedUs, const QString &topic, const QByteArray &data);
+
+    quint64 framesWritten() const { return m_framesWritten.loadRelaxed(); }
+    quint64 bytesWritten() const { return m_bytesWritten.loadRelaxed(); }
+    quint64 framesDropped() const { return m_framesDropped.loadRelaxed(); }
+
+private:
+    Q_DISABLE_COPY(SessionRecorder)
+
+    struct Frame {
+        qint64 receivedUs;
+        FrameKind kind;
+        QString topic;
+        QByteArray data;
+    };
+
+    struct TopicIndex {
+        QVector<quint32> offsets;
+        qint64 firstUs = 0;
+        qint64 lastUs = 0;
+    };
+
+    struct ChunkInfo {
+        quint64 chunkOffset;
+        quint64 indexOffset;
+        qint64 firstUs;
+        qint64 lastUs;
+        quint32 count;
+    };
+
+    void run();                         // 写线程
+    void append(const Frame &frame);    // 编码进当前块
+    quint16 topicId(const QString &topic);
+    void flushChunk();
+    void writeTrailer();
+    bool writeAll(const QByteArray &bytes);
+
+    // socket 线程与写线程共享
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QVector<Frame> m_pending;
+    qint64 m_pendingBytes = 0;
+    bool m_stopping = false;
+
+    // 只在写线程中访问
+    QFile m_file;
+    QByteArray m_chunk;                 // 当前块的帧（内容部分）
+    QByteArray m_topicBlocks;           // 新话题的 TOPC 块，写在下一个 CHNK 之前
+    QByteArray m_blockBuffer;           // flushChunk 拼块头和索引用，逐块复用
+    quint32 m_chunkCount = 0;
+    qint64 m_chunkFirstUs = 0;
+    qint64 m_chunkLastUs = 0;
+    QElapsedTimer m_chunkAge;
+    QHash<QString, quint16> m_topicIds;
+    QHash<quint16, TopicIndex> m_chunkIndex;
+    QVector<ChunkInfo> m_chunks;
+    bool m_writeFailed = false;
+
+    QThread *m_thread = nullptr;
+    QString m_path;
+    QAtomicInteger<quint64> m_framesWritten{0};
+    QAtomicInteger<quint64> m_bytesWritten{0};
+    QAtomicInteger<quint64> m_framesDropped{0};
+};
+
+#endif // SESSIONRECORDER_H
@@ -0,0 +1,35 @@
+#ifndef SUBSCRIPTIONREGISTRY_H
+#define SUBSCRIPTIONREGISTRY_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+
+// 话题订阅引用计数：每个话题按使用者（监视器）计数，
+// 第一个使用者订阅时才需要向 rosbridge 发送 subscribe，最后一个使用者退订时才发送 unsubscribe
+// 只在 socket 线程中使用；使用者以 WebSocketWorker 分配的编号区分，不保存指针（对象销毁后地址可能被新对象复用）
+class SubscriptionRegistry
+{
+public:
+    // 使用者订阅话题；该话题此前没有任何使用者时返回 true（需要发送 subscribe）
+    bool acquire(quint64 consumer, const QString &topic, const QString &type);
+    // 使用者退订话题；该话题已没有使用者时返回 true（需要发送 unsubscribe）
+    bool release(quint64 consumer, const QString &topic);
+    // 使用者退订全部话题，返回已没有使用者、需要发送 unsubscribe 的话题
+    QStringList releaseConsumer(quint64 consumer);
+
+    bool isActive(const QString &topic) const { return m_consumers.contains(topic); }
+    QStringList activeTopics() const { return m_consumers.keys(); }
+    int consumerCount(const QString &topic) const { return m_consumers.value(topic).size(); }
+    QString typeOf(const QString &topic) const { return m_types.value(topic); }
+    // 活跃话题 -> 类型（cbor-raw 解码需要）
+    const QHash<QString, QString> &topicTypes() const { return m_types; }
+
+private:
+    QHash<QString, QSet<quint64>> m_consumers;     // 话题 -> 使用者编号
+    QHash<QString, QString> m_types;                // 话题 -> 类型
+};
+
+#endif // SUBSCRIPTIONREGISTRY_H
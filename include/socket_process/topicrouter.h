@@ -0,0 +1,68 @@
+#ifndef TOPICROUTER_H
+#define TOPICROUTER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+#include <QSet>
+#include <QByteArray>
+#include <QStringView>
+#include <QLatin1String>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+#include <memory>
+
+#include "socket_process/rosmessage.h"
+#include "util/topicmetrics.h"
+
+// 话题路由器：对 WebSocket 收到的每条消息只解析一次信封（op/topic），
+// 然后把 msg 作为解码任务交给 DecodeExecutor，由线程池调用为该话题注册的处理对象，避免每个监视器都重复解析整条消息
+// 同一处理对象的同一话题按顺序处理，不同话题并行；处理槽不在对象所属线程中执行，需自行保护与其他槽共享的状态
+// JSON 文本帧不构建 DOM，监视器拿到的是帧字节和 msg 的位置（见 RosMessage）
+class TopicRouter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TopicRouter(QObject *parent = nullptr);
+    ~TopicRouter();
+
+    // 注册/注销话题处理对象，method 为 receiver 上参数为 (const RosMessage &) 的槽函数名
+    // 可在任意线程调用；removeReceiver 返回后不会再有该对象的处理槽在执行，处理对象析构前应调用
+    void addHandler(const QString &topic, QObject *receiver, const char *method = "onRosMessage");
+    void removeReceiver(QObject *receiver);
+    // 有处理对象的话题的统计项，没有处理对象时返回 nullptr（预过滤用）
+    // socket 线程每帧调用：在话题集合快照上按 QStringView 做哈希查找，不加路由锁、不复制话题名
+    TopicMetrics::Entry *metrics(QStringView topic) const;
+
+    // 解析 publish 帧的信封，填写 out 的 topic/json/msgOffset/msgLength；不是 publish 或格式错误时返回 false
+    static bool parseEnvelope(const QByteArray &json, RosMessage *out);
+
+public slots:
+    void route(const QString &message);     // 在 socket 线程中调用
+    void routeUtf8(const QByteArray &json); // 同上，参数为 UTF-8 帧字节
+    void dispatch(const RosMessage &message);   // 分发已解码的消息（二进制帧由 CborDecoder 解码）
+
+private:
+    struct Handler {
+        QObject *receiver;
+        QByteArray method;
+    };
+
+    void publishTopics();   // 持有 m_mutex 时调用：处理对象的话题集合变化后更新快照
+
+    mutable QMutex m_mutex;
+    QHash<QString, QList<Handler>> m_handlers;  // 话题 -> 处理对象
+    // 有处理对象的话题 -> 统计项，整体替换；读取方用 std::atomic_load 取得快照，注册/注销很少发生
+    struct TopicSnapshot {
+        QList<QString> names;                               // 持有话题名，entries 的键指向其中的字符
+        QHash<QStringView, TopicMetrics::Entry *> entries;
+    };
+    std::shared_ptr<const TopicSnapshot> m_topics = std::make_shared<const TopicSnapshot>();
+    QSet<QObject *> m_watched;                  // 已监听 destroyed 信号的对象
+};
+
+#endif // TOPICROUTER_H
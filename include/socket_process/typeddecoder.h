@@ -0,0 +1,266 @@
+#ifndef TYPEDDECODER_H
+#define TYPEDDECODER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLatin1String>
+#include <QString>
+#include <QVector>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "socket_process/jsonreader.h"
+#include "socket_process/rosmessage.h"
+#include "socket_process/rosmsgs.h"
+
+// 按 RosFields<T> 字段表把 msg 解码到结构体 T
+//  JSON 文本帧：在帧字节上用 JsonReader 读取，键名与字段表逐项比较（先比长度），匹配后直接写入成员
+//  cbor 帧（已转成 QJsonObject）：按字段表逐个查找键
+// 解码前把 out 恢复为默认值，但 QByteArray/QVector 成员只清空不释放，重复使用同一个结构体时缓冲区可复用
+// seen 返回顶层出现过的字段，位 i 对应字段表第 i 项，用 fieldBit<T>("name") 取得
+//
+//   rosmsg::Imu imu;
+//   quint32 seen = 0;
+//   if (TypedDecoder::decode(message, &imu, &seen) && (seen & TypedDecoder::fieldBit<rosmsg::Imu>("orientation"))) ...
+class TypedDecoder
+{
+public:
+    template <typename T>
+    static bool decode(QByteArrayView json, T *out, quint32 *seen = nullptr);
+    template <typename T>
+    static bool decode(const QJsonObject &obj, T *out, quint32 *seen = nullptr);
+    // 按消息来源选择上面两者之一；cbor 帧的二进制 data 在 message.data 中，需由调用方取用
+    template <typename T>
+    static bool decode(const RosMessage &message, T *out, quint32 *seen = nullptr);
+
+    // 字段在 seen 中对应的位，名字不在字段表中时为 0
+    template <typename T>
+    static constexpr quint32 fieldBit(const char *name);
+
+private:
+    template <typename T, typename = void>
+    struct IsMessage : std::false_type {};
+    template <typename T>
+    struct IsMessage<T, std::void_t<decltype(RosFields<T>::fields)>> : std::true_type {};
+
+    template <typename T>
+    using FieldIndices = std::make_index_sequence<std::tuple_size<std::decay_t<decltype(RosFields<T>::fields)>>::value>;
+
+    // 叶子类型（typeddecoder.cpp）
+    static bool read(JsonReader &reader, double *out);
+    static bool read(JsonReader &reader, qint64 *out);
+    static bool read(JsonReader &reader, bool *out);
+    static bool read(JsonReader &reader, QString *out);
+    static bool read(JsonReader &reader, QByteArray *out);          // uint8[]：base64 字符串或整数数组
+    static bool read(JsonReader &reader, QVector<double> *out);     // float64[]：数组，或 base64 编码的 double
+    static bool read(const QJsonValue &value, double *out);
+    static bool read(const QJsonValue &value, qint64 *out);
+    static bool read(const QJsonValue &value, bool *out);
+    static bool read(const QJsonValue &value, QString *out);
+    static bool read(const QJsonValue &value, QByteArray *out);
+    static bool read(const QJsonValue &value, QVector<double> *out);
+
+    // 嵌套消息与消息数组
+    template <typename T>
+    static bool read(JsonReader &reader, T *out);
+    template <typename T>
+    static bool read(JsonReader &reader, QVector<T> *out);
+    template <typename T>
+    static bool read(const QJsonValue &value, T *out);
+    template <typename T>
+    static bool read(const QJsonValue &value, QVector<T> *out);
+
+    template <typename T>
+    static bool readObject(JsonReader &reader, T *out, quint32 *seen);
+    template <typename T>
+    static bool readObject(const QJsonObject &obj, T *out, quint32 *seen);
+
+    template <typename S, typename M>
+    static bool matches(const RosField<S, M> &field, QByteArrayView key)
+    {
+        return key.size() == field.length && std::memcmp(key.data(), field.name, size_t(field.length)) == 0;
+    }
+
+    template <typename T, std::size_t... I>
+    static int findField(QByteArrayView key, std::index_sequence<I...>);
+    template <typename T, std::size_t... I>
+    static bool readField(JsonReader &reader, T *out, int index, std::index_sequence<I...>);
+    template <typename T, std::size_t... I>
+    static bool readFields(const QJsonObject &obj, T *out, quint32 *seen, std::index_sequence<I...>);
+
+    template <typename T>
+    static void reset(T *out);
+    template <typename T, std::size_t... I>
+    static void resetFields(T *out, const T &defaults, std::index_sequence<I...>);
+    static void resetValue(QByteArray *value, const QByteArray &) { value->resize(0); }
+    template <typename E>
+    static void resetValue(QVector<E> *value, const QVector<E> &) { value->resize(0); }
+    template <typename V>
+    static void resetValue(V *value, const V &defaultValue);
+
+    static constexpr bool sameName(const char *a, const char *b)
+    {
+        return *a == *b && (*a == '\0' || sameName(a + 1, b + 1));
+    }
+    template <typename T, std::size_t... I>
+    static constexpr quint32 fieldBitImpl(const char *name, std::index_sequence<I...>)
+    {
+        return ((sameName(std::get<I>(RosFields<T>::fields).name, name) ? (quint32(1) << I) : 0u) | ... | 0u);
+    }
+};
+
+template <typename T>
+constexpr quint32 TypedDecoder::fieldBit(const char *name)
+{
+    return fieldBitImpl<T>(name, FieldIndices<T>());
+}
+
+template <typename T>
+bool TypedDecoder::decode(QByteArrayView json, T *out, quint32 *seen)
+{
+    reset(out);
+    if (seen) *seen = 0;
+    JsonReader reader(json);
+    return readObject(reader, out, seen);
+}
+
+template <typename T>
+bool TypedDecoder::decode(const QJsonObject &obj, T *out, quint32 *seen)
+{
+    reset(out);
+    if (seen) *seen = 0;
+    return readObject(obj, out, seen);
+}
+
+template <typename T>
+bool TypedDecoder::decode(const RosMessage &message, T *out, quint32 *seen)
+{
+    return message.hasJson() ? decode(message.msgJson(), out, seen) : decode(message.msg, out, seen);
+}
+
+template <typename T>
+bool TypedDecoder::readObject(JsonReader &reader, T *out, quint32 *seen)
+{
+    static_assert(std::tuple_size<std::decay_t<decltype(RosFields<T>::fields)>>::value <= 32, "too many fields for the seen mask");
+    if (!reader.beginObject()) return false;
+    QByteArrayView key;
+    while (reader.nextKey(&key)) {
+        const int index = findField<T>(key, FieldIndices<T>());
+        if (index < 0) {
+            if (!reader.skipValue()) return false;
+            continue;
+        }
+        if (!readField(reader, out, index, FieldIndices<T>())) return false;
+        if (seen) *seen |= quint32(1) << index;
+    }
+    return !reader.hasError();
+}
+
+template <typename T>
+bool TypedDecoder::readObject(const QJsonObject &obj, T *out, quint32 *seen)
+{
+    quint32 mask = 0;
+    const bool ok = readFields(obj, out, &mask, FieldIndices<T>());
+    if (seen) *seen = mask;
+    return ok;
+}
+
+template <typename T, std::size_t... I>
+int TypedDecoder::findField(QByteArrayView key, std::index_sequence<I...>)
+{
+    int index = -1;
+    (void)((matches(std::get<I>(RosFields<T>::fields), key) ? (index = int(I), true) : false) || ...);
+    return index;
+}
+
+template <typename T, std::size_t... I>
+bool TypedDecoder::readField(JsonReader &reader, T *out, int index, std::index_sequence<I...>)
+{
+    bool ok = false;
+    (void)((index == int(I) ? (ok = read(reader, &(out->*std::get<I>(RosFields<T>::fields).member)), true) : false) || ...);
+    return ok;
+}
+
+template <typename T, std::size_t... I>
+bool TypedDecoder::readFields(const QJsonObject &obj, T *out, quint32 *seen, std::index_sequence<I...>)
+{
+    bool ok = true;
+    auto one = [&](const auto &field, quint32 bit) {
+        const auto it = obj.constFind(QLatin1String(field.name, field.length));
+        if (it == obj.constEnd()) return;
+        const QJsonValue value = it.value();
+        if (read(value, &(out->*field.member))) *seen |= bit;
+        else ok = false;
+    };
+    (one(std::get<I>(RosFields<T>::fields), quint32(1) << I), ...);
+    return ok;
+}
+
+template <typename T>
+bool TypedDecoder::read(JsonReader &reader, T *out)
+{
+    static_assert(IsMessage<T>::value, "no decoder for this field type; add a leaf read() or a RosFields specialization");
+    return readObject(reader, out, nullptr);
+}
+
+template <typename T>
+bool TypedDecoder::read(JsonReader &reader, QVector<T> *out)
+{
+    out->resize(0);
+    if (!reader.beginArray()) return false;
+    while (reader.nextElement()) {
+        out->resize(out->size() + 1);
+        if (!read(reader, &out->last())) return false;
+    }
+    return !reader.hasError();
+}
+
+template <typename T>
+bool TypedDecoder::read(const QJsonValue &value, T *out)
+{
+    static_assert(IsMessage<T>::value, "no decoder for this field type; add a leaf read() or a RosFields specialization");
+    return value.isObject() && readObject(value.toObject(), out, nullptr);
+}
+
+template <typename T>
+bool TypedDecoder::read(const QJsonValue &value, QVector<T> *out)
+{
+    out->resize(0);
+    if (!value.isArray()) return false;
+    const QJsonArray arr = value.toArray();
+    out->resize(arr.size());
+    for (qsizetype i = 0; i < arr.size(); ++i) {
+        if (!read(arr.at(i), &(*out)[i])) return false;
+    }
+    return true;
+}
+
+template <typename T>
+void TypedDecoder::reset(T *out)
+{
+    static const T defaults{};
+    resetFields(out, defaults, FieldIndices<T>());
+}
+
+template <typename T, std::size_t... I>
+void TypedDecoder::resetFields(T *out, const T &defaults, std::index_sequence<I...>)
+{
+    (resetValue(&(out->*std::get<I>(RosFields<T>::fields).member), defaults.*std::get<I>(RosFields<T>::fields).member), ...);
+}
+
+template <typename V>
+void TypedDecoder::resetValue(V *value, const V &defaultValue)
+{
+    if constexpr (IsMessage<V>::value) {
+        resetFields(value, defaultValue, FieldIndices<V>());
+    } else {
+        *value = defaultValue;
+    }
+}
+
+#endif // TYPEDDECODER_H
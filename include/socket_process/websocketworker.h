@@ -8,6 +8,26 @@
 #include <QThread>
 #include <QUrl>
 #include <QNetworkProxy>
+#include <QHash>
+#include <QSet>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QNetworkInformation>
+
+#include "socket_process/topicrouter.h"
+#include "socket_process/cbordecoder.h"
+#include "socket_process/fragmentassembler.h"
+#include "socket_process/pngdecoder.h"
+#include "socket_process/envelopeprefilter.h"
+#include "socket_process/subscriptionregistry.h"
+#include "socket_process/servicecaller.h"
+#include "socket_process/clocksync.h"
+#include "socket_process/sessionrecorder.h"
+
+#include <functional>
 
 
 class WebSocketWorker : public QObject
@@ -17,30 +37,129 @@ public:
     explicit WebSocketWorker(QObject *parent = nullptr);
     ~WebSocketWorker();
 
+    TopicRouter *router() const { return m_router; }  // 话题路由器，监视器在此注册关心的话题
+    ClockSync *clockSync() const { return m_clockSync; }    // 与机器人的时钟同步，换算消息时间戳
+
+    // 调用 ROS 服务（rosbridge call_service），可在任意线程调用，不阻塞
+    // 每个请求带独立 id，可同时发出多个；timeoutMs 内未应答、连接断开或关闭、worker 停止时以失败结束（ok 为 false，error 说明原因）
+    static const int DEFAULT_SERVICE_TIMEOUT_MS = 5000;
+    QFuture<ServiceResponse> callService(const QString &service, const QJsonObject &args = QJsonObject(),
+                                         int timeoutMs = DEFAULT_SERVICE_TIMEOUT_MS);
+    // 回调形式：callback 在 context 所在线程中执行，context 已销毁时不再回调
+    void callService(const QString &service, const QJsonObject &args, QObject *context,
+                     std::function<void(const ServiceResponse &)> callback,
+                     int timeoutMs = DEFAULT_SERVICE_TIMEOUT_MS);
+
+    // 回放（ReplaySource）：beginReplay 之后 worker 按已连接处理但不打开 socket，
+    // injectFrame 把录制的帧送入与 socket 相同的接收路径；只能在 worker 线程中调用
+    void beginReplay(const QString &name);
+    void injectFrame(const QByteArray &frame, bool binary);
+
+    // 按使用者引用计数订阅/取消订阅话题：同一话题只向 rosbridge 发送一次 subscribe/unsubscribe，
+    // 重连后自动重新订阅；QoS（限频/队列/分片/压缩）从 topic_config.yaml 的 topic_qos 读取
+    // 线程安全，由使用者在自己的线程中直接调用：使用者在这里换成编号，实际的订阅变更排队到 worker 线程执行
+    void subscribeTopic(QObject *consumer, const QString &topic, const QString &type);
+    void unsubscribeTopic(QObject *consumer, const QString &topic);
+    void unsubscribeAll(QObject *consumer);     // 使用者销毁时也会自动调用
+
+    // 发送优先级，数值越小越先发送
+    enum SendPriority {
+        TeleopPriority = 0,         // 遥控按键
+        ControlPriority = 1,        // 脚本启停、模式切换等控制命令，以及 advertise/unadvertise（须先于同级的 publish 发出）
+        SubscriptionPriority = 2,   // subscribe/unsubscribe、call_service
+        PriorityCount
+    };
+    Q_ENUM(SendPriority)
+
+    // 连接状态机：断线后按抖动指数退避重连，网络恢复时立即重试
+    enum ConnectionState {
+        Disconnected = 0,   // 未连接且不重连（未启动或主动断开）
+        Connecting,         // 正在打开连接
+        Connected,
+        Backoff             // 等待下一次重连
+    };
+    Q_ENUM(ConnectionState)
+
 public slots:
     void init(); // create QWebSocket/QTimer in worker thread
     void startConnect(const QString &url);
     void closeConnection();
-    void sendText(const QString &text);
+    void sendText(const QString &text);     // 以 ControlPriority 入队
+    // 按优先级入队发送；coalesceKey 非空时，队列中相同 key 的旧消息被新消息取代
+    void enqueueText(const QString &text, int priority, const QString &coalesceKey = QString());
+    // 会话录制：把此后收到的每一帧原样写入 path（格式见 SessionRecorder），写盘在录制器自己的线程中进行
+    void startRecording(const QString &path);
+    void stopRecording();       // 剩余数据在后台写完，不阻塞 socket 线程
 
 signals:
     void connected();
     void disconnected();
     void errorOccurred(const QString &error);
-    void messageReceived(const QString &message);
+    void reconnecting(int attempt, int delayMs);                // 进入退避，delayMs 后第 attempt 次重连
+    void recordingChanged(bool recording, const QString &path); // 开始/停止录制（打开文件失败时 recording 为 false）
 
 private slots:
     void onConnected();
     void onDisconnected();
     void onTextMessageReceived(const QString &message);
+    void onBinaryMessageReceived(const QByteArray &message);
     void onErrorOccurred(QAbstractSocket::SocketError error);
+    void onReachabilityChanged(QNetworkInformation::Reachability reachability);
 
 private:
+    // 帧处理入口：socket 收到的帧先录制再进入这里，分片拼接和 png 还原出的消息直接从这里重新进入
+    void processTextFrame(const QString &message);
+    void processBinaryFrame(const QByteArray &message);
+    void initTimers();
+    bool handleFragment(const QString &message);   // 处理 op:"fragment"，拼接完成后再路由
+    bool handlePng(const QString &message);        // 处理 op:"png"，解压出 JSON 文本后再路由
+    void handleServiceResponse(const QString &message);
+    void startServiceCall(const ServiceCaller::Promise &promise, const QString &service, const QJsonObject &args, int timeoutMs);
+    void scheduleFlush();
+    void flushSendQueue();
+    bool isConnected() const;
+    void sendSubscribe(const QString &topic);
+    void sendUnsubscribe(const QString &topic);
+    void resubscribeAll();      // 连接建立后重放全部活跃订阅
+    void failServiceCalls(const QString &error);    // 结束全部在途的服务调用，并从发送队列移除其请求
+    void openSocket();
+    void scheduleReconnect();
+    void noteFirstMessage(QStringView topic);
+    bool recordReceived(QStringView topic, qint64 bytes);   // 统计收包，话题无处理对象时返回 false
+    // 以下在 worker 线程中执行，consumerId 由 subscribeTopic 分配
+    void acquireTopic(quint64 consumerId, const QString &topic, const QString &type);
+    void releaseTopic(quint64 consumerId, const QString &topic);
+    void releaseConsumer(quint64 consumerId);
+
+    struct Outgoing {
+        QString text;
+        QString key;            // 合并键（如 "sub:/topic"），空表示不合并
+        QElapsedTimer age;      // 入队时间，断线期间超过有效期的消息丢弃
+    };
+
     QWebSocket *m_webSocket;
+    TopicRouter *m_router;
+    TopicMetrics::Entry *m_unroutedMetrics;     // 没有处理对象的话题共用的统计项（<unrouted>）
+    ClockSync *m_clockSync;
     QTimer *m_reconnectTimer;
+    QTimer *m_connectTimeoutTimer = nullptr;    // 打开连接超时则放弃本次尝试
     QString m_url;
-    bool m_isReconnecting;
+    bool m_isReconnecting;                      // 断线后是否自动重连（主动断开时为 false）
     int m_reconnectAttempts;
+    ConnectionState m_state = Disconnected;
+    QElapsedTimer m_sessionTimer;               // 本次连接建立的时间
+    QSet<QString> m_awaitingFirst;              // 本次连接后尚未收到数据的话题
+    SubscriptionRegistry m_subscriptions;   // 话题订阅引用计数
+    QMutex m_consumerMutex;                 // 保护 m_consumerIds，使用者线程与 destroyed 回调都会访问
+    QHash<QObject *, quint64> m_consumerIds;    // 存活的使用者 -> 编号，销毁时同步移除
+    quint64 m_nextConsumerId = 1;
+    FragmentAssembler m_fragments;          // 大消息分片拼接
+    QTimer *m_fragmentTimer = nullptr;      // 定期清理超时分片
+    ServiceCaller m_services;               // 在途的服务调用
+    QTimer *m_serviceTimer = nullptr;       // 有在途调用时定期检查超时
+    SessionRecorder *m_recorder = nullptr;  // 录制中时非空
+    QList<Outgoing> m_sendQueues[PriorityCount];    // 各优先级的发送队列
+    bool m_flushScheduled = false;
 };
 
 #endif // WEBSOCKETWORKER_H
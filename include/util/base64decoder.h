@@ -0,0 +1,27 @@
+#ifndef BASE64DECODER_H
+#define BASE64DECODER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QtGlobal>
+
+// base64 解码（rosbridge 的 uint8[] 字段：CompressedImage/Image/PointCloud2 的 data）
+// 直接在帧的 UTF-8 字节上解码，写入调用方提供的缓冲区，不经过 QString 也不产生临时 QByteArray
+// x86 上按 CPU 能力在运行时选择 AVX2（每次 32 字符）或 SSE4.1（每次 16 字符），其他平台用查表实现
+// 与 QByteArray::fromBase64 的默认行为一致：遇到 '=' 结束，其余非字母表字符（换行、JSON 的 "\/" 转义等）跳过
+class Base64Decoder
+{
+public:
+    // 解码 length 个字符最多产生的字节数，dst 至少要有这么大
+    static qsizetype maxDecodedSize(qsizetype length) { return (length + 3) / 4 * 3; }
+
+    // 解码到 dst，返回写入的字节数
+    static qsizetype decode(const char *src, qsizetype length, char *dst);
+
+    // 解码到可复用的缓冲区：out 未共享且容量足够时不重新分配内存，返回解码后的字节数
+    static qsizetype decode(QByteArrayView src, QByteArray *out);
+
+    static const char *backend();   // 当前使用的实现："avx2" / "sse4.1" / "scalar"
+};
+
+#endif // BASE64DECODER_H
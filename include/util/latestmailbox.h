@@ -0,0 +1,104 @@
+#ifndef LATESTMAILBOX_H
+#define LATESTMAILBOX_H
+
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+#include <utility>
+
+#include "util/topicmetrics.h"
+#include "util/messagestamps.h"
+#include "util/tracerecorder.h"
+
+// 每个话题的“最新值”信箱：生产者（解码线程）覆盖写入，消费者（界面）按自己的节奏取最新值
+// 代替 QueuedConnection 信号：界面繁忙时事件队列不会积压旧数据，内存和延迟都有上界
+// 序号为原子量，消费者无新数据时不加锁即可返回；槽位本身由一个短锁保护（QList 等为隐式共享，拷贝只增引用计数）
+// 槽位不做成原子指针：T 多为 QList 等非平凡类型，原子槽每次 post 都要分配节点，且 peek 读取时不能被生产者释放；
+// 锁内只有移动赋值和引用计数拷贝，每个话题的解码按顺序执行（只有一个生产者在写），只在界面 take 的同一瞬间才会争用
+// 未被取走就被覆盖的样本计入 overwritten()，并记为该话题的跳过（TopicMetrics::recordSkip，不算丢失）
+// 值可附带消息的时间点（MessageStamps），消费者显示后调用 markDisplayed 记录端到端延迟
+// 支持多个生产者、一个消费者
+//
+//   // 解码线程
+//   m_pointsMailbox.post(points, stamps);
+//   // 界面定时器
+//   QList<QVector3D> points;
+//   MessageStamps stamps;
+//   if (monitor->pointCloudMailbox().take(&points, &stamps)) {
+//       display->onPointCloudReceived(points);
+//       stamps.markDisplayed(monitor->pointCloudMailbox().topic());
+//   }
+template <typename T>
+class LatestMailbox
+{
+public:
+    explicit LatestMailbox(const QString &topic = QString()) { setTopic(topic); }
+
+    // 话题名用于丢弃和延迟统计，在开始 post 之前设置
+    void setTopic(const QString &topic)
+    {
+        m_topic = topic;
+        m_metrics = topic.isEmpty() ? nullptr : TopicMetrics::instance().entry(topic);
+    }
+    const QString &topic() const { return m_topic; }
+
+    void post(T value, const MessageStamps &stamps = MessageStamps())
+    {
+        bool overwritten = false;
+        {
+            TraceRecorder::Zone zone("mailbox.post");
+            QMutexLocker locker(&m_mutex);
+            m_value = std::move(value);
+            m_stamps = stamps;
+            const quint64 seq = m_sequence.loadRelaxed();
+            overwritten = seq != m_taken.loadRelaxed();
+            m_sequence.storeRelease(seq + 1);
+        }
+        if (overwritten) {
+            m_overwritten.fetchAndAddRelaxed(1);
+            TopicMetrics::instance().recordSkip(m_metrics);
+        }
+    }
+
+    // 取出上次 take 之后的最新值；没有新值时返回 false，out 不变
+    bool take(T *out, MessageStamps *stamps = nullptr)
+    {
+        if (m_sequence.loadAcquire() == m_taken.loadRelaxed()) return false;
+        TraceRecorder::Zone zone("mailbox.take");
+        QMutexLocker locker(&m_mutex);
+        const quint64 seq = m_sequence.loadRelaxed();
+        if (seq == m_taken.loadRelaxed()) return false;
+        *out = m_value;
+        if (stamps) *stamps = m_stamps;
+        m_taken.storeRelaxed(seq);
+        return true;
+    }
+
+    // 读取最新值（不论是否已取过），用于切换显示对象后立即刷新；从未 post 过时返回 false
+    bool peek(T *out) const
+    {
+        if (m_sequence.loadAcquire() == 0) return false;
+        QMutexLocker locker(&m_mutex);
+        *out = m_value;
+        return true;
+    }
+
+    bool hasNew() const { return m_sequence.loadAcquire() != m_taken.loadRelaxed(); }
+    quint64 sequence() const { return m_sequence.loadAcquire(); }     // 累计 post 次数
+    quint64 overwritten() const { return m_overwritten.loadRelaxed(); }
+
+private:
+    Q_DISABLE_COPY(LatestMailbox)
+
+    QString m_topic;
+    TopicMetrics::Entry *m_metrics = nullptr;
+    mutable QMutex m_mutex;
+    T m_value{};
+    MessageStamps m_stamps;
+    QAtomicInteger<quint64> m_sequence{0};
+    QAtomicInteger<quint64> m_taken{0};        // 消费者最近一次取走的序号
+    QAtomicInteger<quint64> m_overwritten{0};
+};
+
+#endif // LATESTMAILBOX_H
@@ -1,9 +1,12 @@
+#pragma once
 #include <QString>
 #include <QDir>
 #include <QFile>    
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>  
 #include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
 
 // 从config/topic_config.yaml加载命令
 inline QString loadTopicFromConfig(const QString &key)
@@ -58,6 +61,89 @@ inline QString loadTopicFromConfig(const QString &key)
 }
 
 
+// rosbridge 订阅参数（服务端限频/队列/分片/压缩），在 topic_config.yaml 的 topic_qos 块中按话题配置
+struct TopicQos
+{
+    int throttle_rate = 0;      // 服务端最小发送间隔（ms），0 表示不限频
+    int queue_length = 0;       // 服务端缓存队列长度，0 表示使用 rosbridge 默认值
+    int fragment_size = 0;      // 分片大小（字节），0 表示不分片
+    QString compression;        // none / cbor / cbor-raw / png
+    int decode_queue = 0;       // 客户端解码队列长度，积压超过时丢弃最旧的消息；0 表示不丢弃，按顺序全部处理
+};
+
+// 读取并解析 topic_config.yaml 中全部话题的 QoS（读文件 + 正则），由 loadTopicQosFromConfig 缓存结果，格式：
+// topic_qos:
+//   "/topic/name": {throttle_rate: 50, queue_length: 1, fragment_size: 0, compression: "cbor", decode_queue: 4}
+inline QHash<QString, TopicQos> parseTopicQosConfig()
+{
+    QHash<QString, TopicQos> result;
+    QDir d(QCoreApplication::applicationDirPath());
+    QStringList candidates = {
+        d.filePath("config/topic_config.yaml"),
+        d.filePath("../config/topic_config.yaml"),
+        QDir::current().filePath("config/topic_config.yaml")
+    };
+    QString content;
+    for (const QString &path : candidates) {
+        QFile f(path);
+        if (f.exists() && f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            content = QString::fromUtf8(f.readAll());
+            f.close();
+            break;
+        }
+    }
+    if (content.isEmpty()) return result;
+
+    // 缩进行: "topic": {key: value, ...}
+    QRegularExpression re(QStringLiteral("^[ \\t]+[\"']?([^\"'{}:\\s]+)[\"']?\\s*:\\s*\\{([^}]*)\\}"));
+    re.setPatternOptions(QRegularExpression::MultilineOption);
+    QRegularExpression kv(QStringLiteral("(\\w+)\\s*:\\s*[\"']?([^,\"']*)[\"']?"));
+    QRegularExpressionMatchIterator lines = re.globalMatch(content);
+    while (lines.hasNext()) {
+        QRegularExpressionMatch m = lines.next();
+        TopicQos qos;
+        QRegularExpressionMatchIterator it = kv.globalMatch(m.captured(2));
+        while (it.hasNext()) {
+            QRegularExpressionMatch p = it.next();
+            QString key = p.captured(1);
+            QString val = p.captured(2).trimmed();
+            if (key == "throttle_rate") qos.throttle_rate = val.toInt();
+            else if (key == "queue_length") qos.queue_length = val.toInt();
+            else if (key == "fragment_size") qos.fragment_size = val.toInt();
+            else if (key == "compression") qos.compression = val;
+            else if (key == "decode_queue") qos.decode_queue = val.toInt();
+        }
+        result.insert(m.captured(1), qos);
+    }
+    return result;
+}
+
+struct TopicQosCache
+{
+    QMutex mutex;
+    bool loaded = false;
+    QHash<QString, TopicQos> qos;
+};
+
+inline TopicQosCache &topicQosCache()
+{
+    static TopicQosCache cache;
+    return cache;
+}
+
+// 话题的 QoS：第一次调用时解析配置文件，之后（包括重连后的重新订阅）直接查表，修改配置后重启程序生效；可在任意线程调用
+inline TopicQos loadTopicQosFromConfig(const QString &topic)
+{
+    TopicQosCache &cache = topicQosCache();
+    QMutexLocker locker(&cache.mutex);
+    if (!cache.loaded) {
+        cache.qos = parseTopicQosConfig();
+        cache.loaded = true;
+    }
+    return cache.qos.value(topic);
+}
+
+
 // 从config/bash_config.yaml加载命令
 inline QString loadCmdFromConfig(const QString &key)
 {
@@ -0,0 +1,37 @@
+#ifndef MESSAGESTAMPS_H
+#define MESSAGESTAMPS_H
+
+#include <QString>
+#include <QtGlobal>
+#include <chrono>
+
+#include "util/topicmetrics.h"
+
+// 一条消息经过的三个时间点，均为本机时钟（微秒，自 epoch）
+//  robotUs:     消息 header.stamp 经时钟同步换算到本机时钟（ClockSync::stampMessage），无时间戳或尚未同步时为 0
+//  receivedUs:  socket 线程收到该帧
+//  displayedUs: 界面显示（markDisplayed）
+struct MessageStamps {
+    qint64 robotUs = 0;
+    qint64 receivedUs = 0;
+    qint64 displayedUs = 0;
+    TopicMetrics::Entry *metrics = nullptr;     // 话题的统计项（ClockSync::stampMessage 填写），为空时按话题名查找
+
+    static qint64 nowUs()
+    {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    // 在界面显示该消息时调用：记录显示时间，并把机器人时间戳到显示的延迟记到 topic 上
+    void markDisplayed(const QString &topic)
+    {
+        displayedUs = nowUs();
+        if (robotUs <= 0) return;
+        const qint64 nsecs = (displayedUs - robotUs) * 1000;
+        if (metrics) TopicMetrics::instance().recordTime(metrics, TopicMetrics::EndToEnd, nsecs);
+        else TopicMetrics::instance().recordTime(topic, TopicMetrics::EndToEnd, nsecs);
+    }
+};
+
+#endif // MESSAGESTAMPS_H
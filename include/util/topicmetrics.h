@@ -0,0 +1,98 @@
+#ifndef TOPICMETRICS_H
+#define TOPICMETRICS_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+// 每个话题的统计快照
+struct TopicStats {
+    QString topic;
+    quint64 messages = 0;       // 累计收到的消息数
+    quint64 bytes = 0;          // 累计收到的字节数
+    quint64 drops = 0;          // 累计丢弃数（预过滤、解码队列满、超时分片等），即真正丢失的消息
+    quint64 skipped = 0;        // 按设计跳过的消息（最新值信箱覆盖、超过最大帧率），不算丢失
+    double msgsPerSec = 0;      // 最近一秒
+    double bytesPerSec = 0;
+    qint64 sizeP50 = 0;         // 最近样本的消息大小分位数（字节）
+    qint64 sizeP99 = 0;
+    double parseUsP50 = 0;      // 信封/CBOR 解析耗时（微秒）
+    double parseUsP99 = 0;
+    double decodeUsP50 = 0;     // 监视器解码耗时（微秒），如图像解码、点云解析
+    double decodeUsP99 = 0;
+    double transportMsP50 = 0;  // 机器人时间戳 -> 本机收到（毫秒，经时钟同步换算），无样本时为 0
+    double transportMsP99 = 0;
+    double endToEndMsP50 = 0;   // 机器人时间戳 -> 界面显示（毫秒）
+    double endToEndMsP99 = 0;
+    quint64 transportSamples = 0;   // 累计的延迟样本数，为 0 表示该话题没有时间戳或时钟未同步
+    quint64 endToEndSamples = 0;
+    qint64 resumeMs = -1;       // 最近一次连接建立到该话题收到第一条消息的耗时（毫秒），-1 表示尚无记录
+};
+
+// 话题统计注册表：socket worker 记录收包、解析和丢弃，监视器记录解码耗时
+// 可在任意线程调用；多机器人时同名话题合并统计
+// 每个话题一个 Entry，计数和样本均为原子量，记录时不加锁；Entry 创建后不会释放（reset 只清零），
+// 热点路径在订阅时用 entry() 取得一次（TopicRouter 随话题集合快照保存，经 RosMessage::metrics 传给监视器），
+// 之后按 Entry 记录；按话题名记录的重载每次都要加锁查表，只用于低频路径。锁只在查表、快照和清零时使用
+class TopicMetrics
+{
+public:
+    enum Stage {
+        Parse,      // 信封解析（JSON/CBOR）
+        Decode,     // 监视器内的消息解码
+        Transport,  // 机器人时间戳到本机收到（需要时钟同步，见 ClockSync）
+        EndToEnd    // 机器人时间戳到界面显示
+    };
+
+    struct Entry;
+
+    static TopicMetrics &instance();
+
+    // 取得话题的统计项（不存在时创建），返回的指针在程序运行期间一直有效
+    Entry *entry(const QString &topic);
+
+    // entry 为空时不记录
+    void recordReceived(Entry *entry, qint64 bytes);
+    void recordTime(Entry *entry, Stage stage, qint64 nsecs);
+    void recordDrop(Entry *entry, int count = 1);
+    void recordSkip(Entry *entry, int count = 1);
+    void recordResume(Entry *entry, qint64 ms);     // 连接建立后收到第一条消息的耗时，只保留最近一次
+
+    void recordReceived(const QString &topic, qint64 bytes);
+    void recordTime(const QString &topic, Stage stage, qint64 nsecs);
+    void recordDrop(const QString &topic, int count = 1);
+
+    QList<TopicStats> snapshot() const;     // 按话题名排序
+    TopicStats stats(const QString &topic) const;
+    void reset();
+
+    // 作用域计时：析构时把耗时记到 stage 上
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(Entry *entry, Stage stage) : m_entry(entry), m_stage(stage) { m_timer.start(); }
+        ScopedTimer(const QString &topic, Stage stage)
+            : m_entry(topic.isEmpty() ? nullptr : TopicMetrics::instance().entry(topic)), m_stage(stage) { m_timer.start(); }
+        ~ScopedTimer() { TopicMetrics::instance().recordTime(m_entry, m_stage, m_timer.nsecsElapsed()); }
+    private:
+        Q_DISABLE_COPY(ScopedTimer)
+        Entry *m_entry;
+        Stage m_stage;
+        QElapsedTimer m_timer;
+    };
+
+private:
+    TopicMetrics();
+
+    static void roll(Entry &e, qint64 second);
+    static TopicStats toStats(const Entry &e, qint64 second);
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry *> m_entries;
+    QElapsedTimer m_clock;
+};
+
+#endif // TOPICMETRICS_H
@@ -0,0 +1,90 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+
+// 管线追踪：在热点路径上放置作用域区间（Zone），按线程记录到无锁环形缓冲区，按需导出为 Chrome trace JSON
+// （chrome://tracing 或 ui.perfetto.dev 打开），可以看到 socket 接收、信封解析、解码、绘制等区间在各线程上的先后与重叠
+// 默认关闭，关闭时每个 Zone 只有一次原子读；可用环境变量 ROBANWEB_TRACE=1、话题统计面板的“记录追踪”或 setEnabled 开启
+// 每个线程第一次记录时取得自己的缓冲区（只有这一步加锁），之后只由该线程写入，满了覆盖最旧的事件；
+// 线程退出后缓冲区保留到被新线程复用，导出时仍能看到已结束线程（如断开的连接）的事件
+// 区间名须为字符串字面量（只保存指针）
+class TraceRecorder
+{
+public:
+    static TraceRecorder &instance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+    void clear();       // 丢弃已记录的事件
+
+    // 导出为 Chrome trace JSON（complete 事件，时间为自程序启动的微秒数）
+    bool writeChromeTrace(const QString &path, QString *error = nullptr) const;
+    static QString defaultPath();   // 程序目录/traces/trace_yyyyMMdd_hhmmss.json
+
+    // Unix 上收到 SIGUSR1 时在主线程导出到 defaultPath()（kill -USR1 <pid>），其他平台无操作
+    // 在创建 QCoreApplication 之后于主线程调用
+    static void installDumpSignal();
+
+    static qint64 nowNs();          // 单调时钟
+
+    static const int BUFFER_EVENTS = 65536;     // 每个线程保留的最近事件数
+
+    // 作用域区间：析构时记录 [构造, 析构) 的耗时；arg 非负时作为参数 n 一并导出（字节数、点数等）
+    class Zone
+    {
+    public:
+        explicit Zone(const char *name, qint64 arg = -1)
+            : m_name(name), m_arg(arg), m_startNs(isEnabled() ? nowNs() : -1) {}
+        ~Zone()
+        {
+            if (m_startNs >= 0) TraceRecorder::instance().record(m_name, m_startNs, nowNs() - m_startNs, m_arg);
+        }
+        void setArg(qint64 arg) { m_arg = arg; }
+    private:
+        Q_DISABLE_COPY(Zone)
+        const char *m_name;
+        qint64 m_arg;
+        qint64 m_startNs;
+    };
+
+private:
+    TraceRecorder();
+
+    // 事件字段用原子量逐个读写（relaxed），导出线程与写入线程之间没有数据竞争
+    struct Event {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<qint64> startNs{0};
+        std::atomic<qint64> durationNs{0};
+        std::atomic<qint64> arg{-1};
+    };
+
+    struct ThreadBuffer {
+        std::unique_ptr<Event[]> events{new Event[BUFFER_EVENTS]};
+        std::atomic<quint64> head{0};       // 累计写入的事件数，下一个事件写到 head % BUFFER_EVENTS
+        std::atomic<quint64> start{0};      // clear() 或复用时的 head，之前的事件不导出
+        bool alive = true;                  // 以下字段受 m_mutex 保护
+        int tid = 0;
+        QString name;
+    };
+
+    friend struct TraceThreadHandle;
+
+    void record(const char *name, qint64 startNs, qint64 durationNs, qint64 arg);
+    ThreadBuffer *acquireBuffer();
+    void releaseBuffer(ThreadBuffer *buffer);
+
+    static std::atomic<bool> s_enabled;
+    qint64 m_originNs;
+    mutable QMutex m_mutex;
+    QList<ThreadBuffer *> m_buffers;        // 只增不删，导出时可以安全访问
+    int m_nextTid = 1;
+};
+
+#endif // TRACERECORDER_H
@@ -243,7 +243,8 @@ void ConnectDialog::onDeleteButtonClicked()
 // 连接按钮connectButton  槽函数
 void ConnectDialog::onConnectButtonClicked()
 {
-  // 查找选中的行
+    // 查找所有勾选的行，每个机器人一个连接
+    QStringList urls;
     for (int row = 0; row < ui->tableWidget->rowCount(); ++row) {
         QTableWidgetItem *checkItem = ui->tableWidget->item(row, 0);
         if (checkItem && checkItem->checkState() == Qt::Checked) {
@@ -251,13 +252,18 @@ void ConnectDialog::onConnectButtonClicked()
             QString port = ui->tableWidget->item(row, 2)->text();
             QString protocol = "ws://";
             QString url = protocol + host + ":" + port;
-            qDebug() << "请求连接到:" << url;
-            emit connectRequested(url);
-            accept();
-            return;
+            if (!urls.contains(url)) {
+                qDebug() << "请求连接到:" << url;
+                urls.append(url);
+            }
         }
     }
-    qDebug() << "未选择任何连接";
+    if (urls.isEmpty()) {
+        qDebug() << "未选择任何连接";
+        return;
+    }
+    emit connectRequested(urls);
+    accept();
 }
 // 断开连接按钮cancelButton  槽函数
 void ConnectDialog::onCancelButtonClicked()
@@ -0,0 +1,146 @@
+#include "dialog/metricsdialog.h"
+#include "ui_metricsDialog.h"
+
+#include <QFileDialog>
+
+// 表格列
+enum MetricsColumn {
+    TopicColumn = 0,
+    MsgRateColumn,
+    ByteRateColumn,
+    SizeP50Column,
+    SizeP99Column,
+    ParseColumn,
+    DecodeColumn,
+    TransportColumn,
+    EndToEndColumn,
+    MessagesColumn,
+    DropsColumn,
+    SkippedColumn,
+    ResumeColumn,
+    ColumnCount
+};
+
+static QString formatBytes(double bytes)
+{
+    if (bytes >= 1024.0 * 1024.0) return QString::number(bytes / (1024.0 * 1024.0), 'f', 2) + " MB";
+    if (bytes >= 1024.0) return QString::number(bytes / 1024.0, 'f', 1) + " KB";
+    return QString::number(bytes, 'f', 0) + " B";
+}
+
+static QString formatUs(double p50, double p99)
+{
+    return QString("%1 / %2").arg(p50, 0, 'f', 0).arg(p99, 0, 'f', 0);
+}
+
+static QString formatMs(double p50, double p99)
+{
+    return QString("%1 / %2").arg(p50, 0, 'f', 1).arg(p99, 0, 'f', 1);
+}
+
+MetricsDialog::MetricsDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::MetricsDialog),
+    refreshTimer(new QTimer(this))
+{
+    ui->setupUi(this);
+    setWindowTitle("话题统计");
+    setAttribute(Qt::WA_DeleteOnClose);
+    setTableWidget();
+
+    ui->traceCheckBox->setChecked(TraceRecorder::isEnabled());
+    connect(ui->traceCheckBox, &QCheckBox::toggled, this, &MetricsDialog::onTraceToggled);
+    connect(ui->traceExportButton, &QPushButton::clicked, this, &MetricsDialog::onTraceExportButtonClicked);
+    connect(ui->resetButton, &QPushButton::clicked, this, &MetricsDialog::onResetButtonClicked);
+    connect(ui->closeButton, &QPushButton::clicked, this, &MetricsDialog::close);
+
+    refreshTimer->setInterval(1000);
+    connect(refreshTimer, &QTimer::timeout, this, &MetricsDialog::refresh);
+    refreshTimer->start();
+    refresh();
+}
+
+MetricsDialog::~MetricsDialog()
+{
+    delete ui;
+}
+
+// 设置tableWidget
+void MetricsDialog::setTableWidget()
+{
+    ui->tableWidget->setColumnCount(ColumnCount);
+    QStringList headers;
+    headers << "话题" << "消息/秒" << "带宽/秒" << "大小 p50" << "大小 p99"
+            << "解析 p50/p99 (us)" << "解码 p50/p99 (us)"
+            << "传输延迟 p50/p99 (ms)" << "端到端 p50/p99 (ms)" << "累计消息" << "丢弃" << "跳过" << "恢复耗时 (ms)";
+    ui->tableWidget->setHorizontalHeaderLabels(headers);
+    ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers); // 禁止编辑
+    ui->tableWidget->verticalHeader()->setVisible(false);
+    ui->tableWidget->horizontalHeader()->setSectionResizeMode(TopicColumn, QHeaderView::Stretch);
+    for (int c = MsgRateColumn; c < ColumnCount; ++c) {
+        ui->tableWidget->horizontalHeader()->setSectionResizeMode(c, QHeaderView::ResizeToContents);
+    }
+}
+
+void MetricsDialog::setCell(int row, int column, const QString &text)
+{
+    QTableWidgetItem *item = ui->tableWidget->item(row, column);
+    if (!item) {
+        item = new QTableWidgetItem();
+        if (column != TopicColumn) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        ui->tableWidget->setItem(row, column, item);
+    }
+    item->setText(text);
+}
+
+void MetricsDialog::refresh()
+{
+    const QList<TopicStats> stats = TopicMetrics::instance().snapshot();
+    ui->tableWidget->setRowCount(stats.size());
+
+    double totalBytesPerSec = 0;
+    quint64 totalDrops = 0;
+    for (int row = 0; row < stats.size(); ++row) {
+        const TopicStats &s = stats.at(row);
+        setCell(row, TopicColumn, s.topic);
+        setCell(row, MsgRateColumn, QString::number(s.msgsPerSec, 'f', 0));
+        setCell(row, ByteRateColumn, formatBytes(s.bytesPerSec));
+        setCell(row, SizeP50Column, formatBytes(double(s.sizeP50)));
+        setCell(row, SizeP99Column, formatBytes(double(s.sizeP99)));
+        setCell(row, ParseColumn, formatUs(s.parseUsP50, s.parseUsP99));
+        setCell(row, DecodeColumn, formatUs(s.decodeUsP50, s.decodeUsP99));
+        // 没有时间戳或时钟尚未同步的话题不显示延迟
+        setCell(row, TransportColumn, s.transportSamples > 0 ? formatMs(s.transportMsP50, s.transportMsP99) : QString("-"));
+        setCell(row, EndToEndColumn, s.endToEndSamples > 0 ? formatMs(s.endToEndMsP50, s.endToEndMsP99) : QString("-"));
+        setCell(row, MessagesColumn, QString::number(s.messages));
+        setCell(row, DropsColumn, QString::number(s.drops));
+        setCell(row, SkippedColumn, QString::number(s.skipped));
+        // 连接建立到收到第一条消息的耗时，<session> 行为全部话题都恢复的耗时
+        setCell(row, ResumeColumn, s.resumeMs >= 0 ? QString::number(s.resumeMs) : QString("-"));
+        totalBytesPerSec += s.bytesPerSec;
+        totalDrops += s.drops;
+    }
+    ui->summaryLabel->setText(QString("话题数: %1    总带宽: %2/s    总丢弃: %3")
+                              .arg(stats.size()).arg(formatBytes(totalBytesPerSec)).arg(totalDrops));
+}
+
+void MetricsDialog::onResetButtonClicked()
+{
+    TopicMetrics::instance().reset();
+    refresh();
+}
+
+void MetricsDialog::onTraceToggled(bool checked)
+{
+    TraceRecorder::instance().setEnabled(checked);
+}
+
+void MetricsDialog::onTraceExportButtonClicked()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "导出追踪", TraceRecorder::defaultPath(), "Chrome Trace (*.json)");
+    if (path.isEmpty()) return;
+    QString error;
+    if (!TraceRecorder::instance().writeChromeTrace(path, &error)) {
+        qDebug() << "MetricsDialog: 导出追踪失败" << path << error;
+    }
+}
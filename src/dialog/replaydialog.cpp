@@ -0,0 +1,100 @@
+#include "dialog/replaydialog.h"
+#include "ui_replayDialog.h"
+#include "socket_process/replaysource.h"
+
+ReplayDialog::ReplayDialog(ReplaySource *source, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::ReplayDialog),
+    m_source(source)
+{
+    ui->setupUi(this);
+    setWindowTitle("会话回放");
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    // 倍速，0 表示不等待、尽快注入
+    ui->speedComboBox->addItem("0.5x", 0.5);
+    ui->speedComboBox->addItem("1x", 1.0);
+    ui->speedComboBox->addItem("2x", 2.0);
+    ui->speedComboBox->addItem("4x", 4.0);
+    ui->speedComboBox->addItem("10x", 10.0);
+    ui->speedComboBox->addItem("最快", 0.0);
+    ui->speedComboBox->setCurrentIndex(1);
+    ui->playButton->setEnabled(false);
+    ui->positionSlider->setEnabled(false);
+
+    connect(ui->playButton, &QPushButton::clicked, this, &ReplayDialog::onPlayButtonClicked);
+    connect(ui->closeButton, &QPushButton::clicked, this, &ReplayDialog::close);
+    connect(ui->speedComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ReplayDialog::onSpeedChanged);
+    connect(ui->positionSlider, &QSlider::sliderReleased, this, &ReplayDialog::onSliderReleased);
+
+    if (m_source) {
+        connect(m_source, &ReplaySource::opened, this, &ReplayDialog::onOpened, Qt::QueuedConnection);
+        connect(m_source, &ReplaySource::openFailed, this, [this](const QString &error) {
+            ui->fileLabel->setText(QString("无法打开录制文件：%1").arg(error));
+        }, Qt::QueuedConnection);
+        connect(m_source, &ReplaySource::positionChanged, this, &ReplayDialog::onPositionChanged, Qt::QueuedConnection);
+        connect(m_source, &ReplaySource::playingChanged, this, [this](bool playing) {
+            m_playing = playing;
+            ui->playButton->setText(playing ? "暂停" : "播放");
+        }, Qt::QueuedConnection);
+        connect(m_source, &ReplaySource::finished, this, &ReplayDialog::onFinished, Qt::QueuedConnection);
+    }
+}
+
+ReplayDialog::~ReplayDialog()
+{
+    delete ui;
+}
+
+void ReplayDialog::onOpened(const QString &url, qint64 durationUs, quint64 frames, const QStringList &topics)
+{
+    m_durationUs = durationUs;
+    ui->fileLabel->setText(QString("%1   %2 帧，%3 个话题").arg(url).arg(frames).arg(topics.size()));
+    ui->fileLabel->setToolTip(topics.join("\n"));
+    ui->positionSlider->setRange(0, int(durationUs / 1000));
+    ui->positionSlider->setEnabled(true);
+    ui->playButton->setEnabled(true);
+    updatePositionLabel(0);
+}
+
+void ReplayDialog::onPositionChanged(qint64 offsetUs)
+{
+    if (!ui->positionSlider->isSliderDown()) ui->positionSlider->setValue(int(offsetUs / 1000));
+    updatePositionLabel(offsetUs);
+}
+
+void ReplayDialog::onFinished(quint64 frames, quint64 bytes, qint64 elapsedMs, qint64 maxLagMs)
+{
+    const double seconds = qMax<qint64>(1, elapsedMs) / 1000.0;
+    ui->summaryLabel->setText(QString("%1 帧 / %2 s，%3 帧/s，%4 MiB/s，最大落后 %5 ms")
+                                  .arg(frames).arg(seconds, 0, 'f', 2)
+                                  .arg(frames / seconds, 0, 'f', 0)
+                                  .arg(bytes / seconds / (1024 * 1024), 0, 'f', 1)
+                                  .arg(maxLagMs));
+}
+
+void ReplayDialog::onPlayButtonClicked()
+{
+    if (!m_source) return;
+    if (!m_playing) ui->summaryLabel->clear();
+    QMetaObject::invokeMethod(m_source, m_playing ? "pause" : "play", Qt::QueuedConnection);
+}
+
+void ReplayDialog::onSpeedChanged(int index)
+{
+    if (!m_source) return;
+    const double speed = ui->speedComboBox->itemData(index).toDouble();
+    QMetaObject::invokeMethod(m_source, "setSpeed", Qt::QueuedConnection, Q_ARG(double, speed));
+}
+
+void ReplayDialog::onSliderReleased()
+{
+    if (!m_source) return;
+    const qint64 offsetUs = qint64(ui->positionSlider->value()) * 1000;
+    QMetaObject::invokeMethod(m_source, "seek", Qt::QueuedConnection, Q_ARG(qint64, offsetUs));
+}
+
+void ReplayDialog::updatePositionLabel(qint64 offsetUs)
+{
+    ui->positionLabel->setText(QString("%1 / %2 s").arg(offsetUs / 1e6, 0, 'f', 1).arg(m_durationUs / 1e6, 0, 'f', 1));
+}
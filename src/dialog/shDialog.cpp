@@ -29,43 +29,18 @@ ShDialog::~ShDialog()
 
     // Request monitor to unsubscribe
     if (featuredImageMonitor) {
-        QMetaObject::invokeMethod(featuredImageMonitor, "stop", Qt::BlockingQueuedConnection);
+        featuredImageMonitor->stop();
     }
 
-    // Disconnect worker -> monitor connections to avoid messages during teardown
-    if (m_worker && featuredImageMonitor) {
-        QObject::disconnect(m_worker, nullptr, featuredImageMonitor, nullptr);
-    }
-
-    // Stop and delete thread cleanly
-    if (featuredImageThread) {
-        if (featuredImageThread->isRunning()) {
-            featuredImageThread->quit();
-            featuredImageThread->wait();
-        }
-        delete featuredImageThread;
-        featuredImageThread = nullptr;
-    }
-
-    // Delete monitor (it lives in the thread; thread stopped above so it's safe)
+    // Delete monitor; its destructor unregisters from the router and waits for in-flight decode jobs
     if (featuredImageMonitor) {
         delete featuredImageMonitor;
         featuredImageMonitor = nullptr;
     }
 
-    // 清理SLAM地图监视器和线程
-    if(slamMapMonitor){
-        QMetaObject::invokeMethod(slamMapMonitor, "stop", Qt::BlockingQueuedConnection);
-    }
-    if(slamMapThread){
-        if(slamMapThread->isRunning()){
-            slamMapThread->quit();
-            slamMapThread->wait();
-        }
-        delete slamMapThread;
-        slamMapThread = nullptr;
-    }
+    // 清理SLAM地图监视器
     if(slamMapMonitor){
+        slamMapMonitor->stop();
         delete slamMapMonitor;
         slamMapMonitor = nullptr;
     }
@@ -83,12 +58,10 @@ void ShDialog::init()
     // 图像pull定时器
     featuredImagePullTimer = new QTimer(this);
     featuredImagePullTimer->setInterval(50); // 50ms间隔
-    // 图像处理线程（不设 parent，析构由本类显式管理，以避免父对象自动删除时线程仍在运行）
-    featuredImageThread = new QThread();
-    m_featureTopic = loadTopicFromConfig("featureImageCompressed_topic");
+    // 特征点图像监视器（不设 parent，析构由本类显式管理）；解码在解码线程池中执行
+    m_featureTopic = loadTopicFromConfig("featureImage_display_topic");
+    if (m_featureTopic.isEmpty()) m_featureTopic = loadTopicFromConfig("featureImageCompressed_topic");
     featuredImageMonitor = new CameraImageMonitor(m_worker, nullptr, m_featureTopic);
-    featuredImageMonitor->moveToThread(featuredImageThread);
-    featuredImageThread->start();
 
     // 避免图像显示标签在pixmap调整大小时自身也调整大小
     if (ui->featurePoint_Display) {
@@ -116,19 +89,16 @@ void ShDialog::init()
         });
     }
 
-    // 启动点云地图监视器和线程
-    slamMapThread = new QThread();
+    // 启动点云地图监视器（解析在解码线程池中执行）
     slamMapMonitor = new SlamMapMonitor(m_worker, nullptr);
-    slamMapMonitor->moveToThread(slamMapThread);
-    slamMapThread->start();
 
     // 启动点云显示对象
     if (ui->pointCloud_Display) {
         pcd = new PointCloudDisplay(ui->pointCloud_Display);
-        connect(slamMapMonitor, &SlamMapMonitor::pointCloudReceived, pcd, &PointCloudDisplay::onPointCloudReceived, Qt::QueuedConnection);
-        connect(slamMapMonitor, &SlamMapMonitor::keyFrameMarkers, pcd, &PointCloudDisplay::onKeyFrameMarkers, Qt::QueuedConnection);
-        connect(slamMapMonitor, &SlamMapMonitor::cameraMatrixReceived, pcd, &PointCloudDisplay::onCameraMatrixReceived, Qt::QueuedConnection);
-        connect(slamMapMonitor, &SlamMapMonitor::cameraPoseReceived, pcd, &PointCloudDisplay::onCameraPoseReceived, Qt::QueuedConnection);
+        // 点云、关键帧、相机矩阵、相机位置由定时器从信箱拉取最新值（显示端只画最新的相机位置）
+        slamMapPullTimer = new QTimer(this);
+        slamMapPullTimer->setInterval(33); // ~30 FPS
+        connect(slamMapPullTimer, &QTimer::timeout, this, &ShDialog::pullSlamMap);
         // ensure pcd matches placeholder size now and when resized by the UI (splitter)
         ui->pointCloud_Display->installEventFilter(this);
         // sync initial size
@@ -155,6 +125,30 @@ void ShDialog::init()
 
 }
 
+// 每个信箱只取最新的一份，界面繁忙时中间的帧被覆盖而不是排队
+void ShDialog::pullSlamMap()
+{
+    if (!slamMapMonitor || !pcd) return;
+    QList<QVector3D> points;
+    MessageStamps stamps;
+    if (slamMapMonitor->pointCloudMailbox().take(&points, &stamps)) {
+        pcd->onPointCloudReceived(points);
+        stamps.markDisplayed(slamMapMonitor->pointCloudMailbox().topic());
+    }
+    KeyFrameMarkers markers;
+    if (slamMapMonitor->keyFrameMailbox().take(&markers)) {
+        pcd->onKeyFrameMarkers(markers.points, markers.lines);
+    }
+    QVector<double> matrix;
+    if (slamMapMonitor->cameraMatrixMailbox().take(&matrix)) {
+        pcd->onCameraMatrixReceived(matrix);
+    }
+    CameraPose pose;
+    if (slamMapMonitor->cameraPoseMailbox().take(&pose)) {
+        pcd->onCameraPoseReceived(pose.pos, pose.dir);
+    }
+}
+
 void ShDialog::bindSlots(){
     // 按钮槽函数
     connect(ui->startSlam_Button, &QPushButton::clicked, this, &ShDialog::onRunSLAMButtonClicked);
@@ -163,8 +157,7 @@ void ShDialog::bindSlots(){
     connect(ui->cancelControl_Button, &QPushButton::clicked, this, &ShDialog::onCancelControlButtonClicked);
     connect(ui->startControl_Button, &QPushButton::clicked, this, &ShDialog::onRunControlButtonClicked);
 
-    // 连接webSocket信号到特征点图像监视器槽函数
-    connect(m_worker, &WebSocketWorker::messageReceived, featuredImageMonitor, &CameraImageMonitor::onMessageReceived, Qt::QueuedConnection);
+    // 特征点图像监视器在 start() 中向话题路由器注册
     connect(featuredImageMonitor, &CameraImageMonitor::imageReceived, this, [this](const QImage &img){
         if (ui->featurePoint_Display) {
             // The worker already scales to the configured target size (SmoothTransformation), set pixmap directly
@@ -173,10 +166,6 @@ void ShDialog::bindSlots(){
     }, Qt::QueuedConnection);
 
 
-    // 连接webSocket信号到SLAM地图监视器槽函数
-    connect(m_worker, &WebSocketWorker::messageReceived, slamMapMonitor, &SlamMapMonitor::onMessageReceived, Qt::QueuedConnection);
-
-
     // 控制按钮槽函数
     // Ensure buttons do not auto-repeat when held down (send only once per click)
     if (ui->w_Button) {
@@ -297,19 +286,11 @@ void ShDialog::onRunSLAMButtonClicked()
 
     // 启动特征点图像订阅
     if (featuredImageMonitor) {
-        // If thread is not running (stopped previously), restart it
-        if (featuredImageThread && !featuredImageThread->isRunning()) {
-            featuredImageMonitor->moveToThread(featuredImageThread);
-            featuredImageThread->start();
-        }
-        // ensure the worker->monitor connection exists (disconnect old then reconnect to avoid duplicates)
-        QObject::disconnect(m_worker, nullptr, featuredImageMonitor, nullptr);
-        connect(m_worker, &WebSocketWorker::messageReceived, featuredImageMonitor, &CameraImageMonitor::onMessageReceived, Qt::QueuedConnection);
-        // Set the desired target size on the worker *right before* starting so it will scale to the shown widget size
+        // Set the desired target size *right before* starting so it will scale to the shown widget size
         if (ui->featurePoint_Display) {
-            QSize target = ui->featurePoint_Display->size();
-            QMetaObject::invokeMethod(featuredImageMonitor, "setTargetSize", Qt::BlockingQueuedConnection, Q_ARG(QSize, target));
+            featuredImageMonitor->setTargetSize(ui->featurePoint_Display->size());
         }
+        // start() registers the monitor with the topic router and subscribes
         QMetaObject::invokeMethod(featuredImageMonitor, "start", Qt::QueuedConnection);
         // Request an immediate frame to refresh the display (queued)
         QMetaObject::invokeMethod(featuredImageMonitor, "requestFrame", Qt::QueuedConnection);
@@ -325,15 +306,10 @@ void ShDialog::onRunSLAMButtonClicked()
 
     // 启动或确保 SLAM 地图点云订阅（通过 slamMapMonitor 发送 subscribe 请求）
     if (slamMapMonitor) {
-        // If thread is not running (stopped previously), restart it
-        if (slamMapThread && !slamMapThread->isRunning()) {
-            slamMapMonitor->moveToThread(slamMapThread);
-            slamMapThread->start();
+        if (slamMapPullTimer && !slamMapPullTimer->isActive()) {
+            slamMapPullTimer->start();
         }
-        // ensure the worker->monitor connection exists (disconnect old then reconnect to avoid duplicates)
-        QObject::disconnect(m_worker, nullptr, slamMapMonitor, nullptr);
-        connect(m_worker, &WebSocketWorker::messageReceived, slamMapMonitor, &SlamMapMonitor::onMessageReceived, Qt::QueuedConnection);
-        // Ask the monitor to send a rosbridge subscribe request
+        // Ask the monitor to register with the router and send a rosbridge subscribe request
         QMetaObject::invokeMethod(slamMapMonitor, "start", Qt::QueuedConnection);
     }
 
@@ -343,6 +319,7 @@ void ShDialog::onRunSLAMButtonClicked()
     }
 
     // Advertise /SLAM/localizationMode topic via rosbridge so subscribers can infer type
+    // 经 sendText 以 ControlPriority 发送：与之后的定位模式 publish 同级，按入队顺序先于 publish 发出
     if (!localizationAdvertised && m_worker) {
         QJsonObject adv;
         adv["op"] = "advertise";
@@ -403,9 +380,9 @@ void ShDialog::onCloseSLAMButtonClicked()
         ui->featurePoint_Display->clear();
     }
 
-    // Disconnect worker -> slamMapMonitor to stop receiving further messages immediately
+    // Unregister slamMapMonitor from the router to stop receiving further messages immediately
     if (m_worker && slamMapMonitor) {
-        QObject::disconnect(m_worker, nullptr, slamMapMonitor, nullptr);
+        m_worker->router()->removeReceiver(slamMapMonitor);
     }
 
     // Ask slamMapMonitor to stop (unsubscribe) and wait for it to finish to avoid races
@@ -413,6 +390,21 @@ void ShDialog::onCloseSLAMButtonClicked()
         QMetaObject::invokeMethod(slamMapMonitor, "stop", Qt::QueuedConnection);
     }
 
+    // 停止拉取；信箱中尚未取走的数据丢弃，避免清空后又显示旧数据
+    if (slamMapPullTimer) {
+        slamMapPullTimer->stop();
+    }
+    if (slamMapMonitor) {
+        QList<QVector3D> points;
+        KeyFrameMarkers markers;
+        QVector<double> matrix;
+        CameraPose pose;
+        slamMapMonitor->pointCloudMailbox().take(&points);
+        slamMapMonitor->keyFrameMailbox().take(&markers);
+        slamMapMonitor->cameraMatrixMailbox().take(&matrix);
+        slamMapMonitor->cameraPoseMailbox().take(&pose);
+    }
+
     // 清空点云和关键帧可视化
     if (pcd) {
         QMetaObject::invokeMethod(pcd, "clearPointCloud", Qt::QueuedConnection);
@@ -543,7 +535,9 @@ void ShDialog::onControlButtonClicked()
 
     QJsonDocument doc(pub);
     QString jsonString = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-    QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, jsonString));
+    // 遥控命令使用最高优先级，不会排在订阅请求之后
+    QMetaObject::invokeMethod(m_worker, "enqueueText", Qt::QueuedConnection, Q_ARG(QString, jsonString),
+                              Q_ARG(int, WebSocketWorker::TeleopPriority), Q_ARG(QString, QString()));
     qDebug() << "Sent remote SLAM control command:" << cmdStr;
 
 }
@@ -566,6 +560,8 @@ void ShDialog::onLocalizationModeToggled(bool checked)
 
     QJsonDocument doc(pub);
     QString jsonString = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-    QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, jsonString));
+    // 尚未发出的旧模式切换会被新值取代
+    QMetaObject::invokeMethod(m_worker, "enqueueText", Qt::QueuedConnection, Q_ARG(QString, jsonString),
+                              Q_ARG(int, WebSocketWorker::ControlPriority), Q_ARG(QString, QStringLiteral("pub:/SLAM/localizationMode")));
     qDebug() << "Published /SLAM/localizationMode:" << checked;
 }
\ No newline at end of file
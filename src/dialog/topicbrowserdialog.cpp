@@ -0,0 +1,135 @@
+#include "dialog/topicbrowserdialog.h"
+#include "ui_topicBrowserDialog.h"
+#include "socket_process/websocketworker.h"
+
+// 表格列
+enum TopicColumn {
+    NameColumn = 0,
+    TypeColumn,
+    ColumnCount
+};
+
+TopicBrowserDialog::TopicBrowserDialog(WebSocketWorker *worker, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::TopicBrowserDialog),
+    m_worker(worker)
+{
+    ui->setupUi(this);
+    setWindowTitle("话题列表");
+    setAttribute(Qt::WA_DeleteOnClose);
+    setTableWidget();
+
+    connect(ui->refreshButton, &QPushButton::clicked, this, &TopicBrowserDialog::refresh);
+    connect(ui->closeButton, &QPushButton::clicked, this, &TopicBrowserDialog::close);
+    connect(ui->filterEdit, &QLineEdit::textChanged, this, &TopicBrowserDialog::applyFilter);
+    refresh();
+}
+
+TopicBrowserDialog::~TopicBrowserDialog()
+{
+    delete ui;
+}
+
+// 设置tableWidget
+void TopicBrowserDialog::setTableWidget()
+{
+    ui->tableWidget->setColumnCount(ColumnCount);
+    QStringList headers;
+    headers << "话题" << "类型";
+    ui->tableWidget->setHorizontalHeaderLabels(headers);
+    ui->tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers); // 禁止编辑
+    ui->tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->tableWidget->verticalHeader()->setVisible(false);
+    ui->tableWidget->horizontalHeader()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    ui->tableWidget->horizontalHeader()->setSectionResizeMode(TypeColumn, QHeaderView::Stretch);
+}
+
+void TopicBrowserDialog::refresh()
+{
+    if (!m_worker) {
+        ui->summaryLabel->setText("机器人未连接");
+        return;
+    }
+    const quint64 generation = ++m_generation;
+    m_pendingTypes = 0;
+    ui->summaryLabel->setText("正在查询...");
+    ui->refreshButton->setEnabled(false);
+    RosApi::topics(m_worker).then(this, [this, generation](const RosApi::TopicList &list) {
+        if (generation != m_generation) return;
+        ui->refreshButton->setEnabled(true);
+        showTopics(list);
+    });
+}
+
+void TopicBrowserDialog::showTopics(const RosApi::TopicList &list)
+{
+    if (!list.ok) {
+        ui->summaryLabel->setText("查询失败: " + list.error);
+        return;
+    }
+    m_elapsedUs = list.elapsedUs;
+    m_rows.clear();
+    ui->tableWidget->setSortingEnabled(false);
+    ui->tableWidget->setRowCount(list.topics.size());
+    for (int row = 0; row < list.topics.size(); ++row) {
+        const RosTopicInfo &info = list.topics.at(row);
+        ui->tableWidget->setItem(row, NameColumn, new QTableWidgetItem(info.name));
+        ui->tableWidget->setItem(row, TypeColumn, new QTableWidgetItem(info.type));
+        m_rows.insert(info.name, row);
+    }
+
+    // 缺少类型的话题：全部查询同时发出，按应答先后填入
+    if (m_worker) {
+        const quint64 generation = m_generation;
+        for (const RosTopicInfo &info : list.topics) {
+            if (!info.type.isEmpty()) continue;
+            ++m_pendingTypes;
+            RosApi::topicType(m_worker, info.name).then(this, [this, generation](const RosApi::TopicType &result) {
+                if (generation != m_generation) return;
+                --m_pendingTypes;
+                showTopicType(result);
+            });
+        }
+    }
+    if (m_pendingTypes == 0) {
+        ui->tableWidget->setSortingEnabled(true);
+        ui->tableWidget->sortByColumn(NameColumn, Qt::AscendingOrder);
+    }
+    applyFilter(ui->filterEdit->text());
+    updateSummary();
+}
+
+void TopicBrowserDialog::showTopicType(const RosApi::TopicType &result)
+{
+    const int row = m_rows.value(result.topic, -1);
+    if (row >= 0) {
+        QTableWidgetItem *item = ui->tableWidget->item(row, TypeColumn);
+        if (item) item->setText(result.ok ? result.type : QString("(%1)").arg(result.error));
+    }
+    if (m_pendingTypes == 0) {
+        // 类型补齐后再排序，避免行号在查询过程中变化
+        ui->tableWidget->setSortingEnabled(true);
+        ui->tableWidget->sortByColumn(NameColumn, Qt::AscendingOrder);
+    }
+    updateSummary();
+}
+
+void TopicBrowserDialog::applyFilter(const QString &text)
+{
+    for (int row = 0; row < ui->tableWidget->rowCount(); ++row) {
+        bool match = text.isEmpty();
+        for (int c = 0; c < ColumnCount && !match; ++c) {
+            QTableWidgetItem *item = ui->tableWidget->item(row, c);
+            match = item && item->text().contains(text, Qt::CaseInsensitive);
+        }
+        ui->tableWidget->setRowHidden(row, !match);
+    }
+}
+
+void TopicBrowserDialog::updateSummary()
+{
+    QString text = QString("话题数: %1    查询耗时: %2 ms")
+                       .arg(m_rows.size()).arg(double(m_elapsedUs) / 1000.0, 0, 'f', 1);
+    if (m_pendingTypes > 0) text += QString("    正在查询类型: %1").arg(m_pendingTypes);
+    ui->summaryLabel->setText(text);
+}
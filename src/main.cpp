@@ -1,4 +1,5 @@
 #include "robanweb.h"
+#include "util/tracerecorder.h"
 
 #include <QApplication>
 #pragma comment(lib, "user32.lib")
@@ -6,6 +7,7 @@
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    TraceRecorder::installDumpSignal();     // kill -USR1 <pid> 导出追踪
     robanweb w;
     w.show();
     return a.exec();
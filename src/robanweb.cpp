@@ -1,18 +1,24 @@
 #include "robanweb.h"
 #include "dialog/connectdialog.h"
 #include "dialog/shDialog.h"
+#include "dialog/metricsdialog.h"
+#include "dialog/topicbrowserdialog.h"
+#include "dialog/replaydialog.h"
 #include "socket_process/websocketworker.h"
+#include "socket_process/typeddecoder.h"
 #include "util/load_param.hpp"
 
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QUrl>
+
 
 robanweb::robanweb(QWidget* parent)
     : QMainWindow(parent)
     , ui(new Ui_robanweb)
-    , webSocketWorker(nullptr)
-    , webSocketThread(nullptr)
-    , reconnectTimer(new QTimer(this))
-    , isReconnecting(false)
-    , reconnectAttempts(0)
+    , connectionManager(new ConnectionManager(this))
 {
     ui->setupUi(this);
     // 设置状态栏
@@ -28,83 +34,159 @@ robanweb::robanweb(QWidget* parent)
 
 robanweb::~robanweb()
 {
-    // 在析构中，确保线程已停止并清理
-    if (webSocketThread) {
-        QMetaObject::invokeMethod(webSocketWorker, "closeConnection", Qt::QueuedConnection);
-        webSocketThread->quit();
-        webSocketThread->wait();
-        // webSocketWorker 会在 thread finished 时 deleteLater 被调用
-        delete webSocketThread;
-        webSocketThread = nullptr;
-        webSocketWorker = nullptr;
-    }
-    if(imageThread){
-        imageThread->quit();
-        imageThread->wait();
-        delete imageThread;
-        imageThread = nullptr;
-        cameraImageMonitor = nullptr;
+    // 在析构中，先释放各机器人的监视器，再停止并清理 worker 线程
+    if (connectionManager) {
+        connectionManager->closeAll();
     }
-    delete reconnectTimer;
-    // delete imagePullTimer;
     delete ui; 
 }
 // 初始化
 void robanweb::init(){
-    // 创建 worker 和线程，把 WebSocket 操作放到子线程
-    webSocketWorker = new WebSocketWorker();
-    webSocketThread = new QThread(this);
-    webSocketWorker->moveToThread(webSocketThread);
-    webSocketThread->start();
-    
-    reconnectTimer->setInterval(5000); // 每5秒尝试重连
     // 图像拉取定时器（UI 拉取最新缓存帧，避免信号队列积压）
     imagePullTimer = new QTimer(this);
     imagePullTimer->setInterval(50); // 默认 20 FPS
 
-
-    // ros话题接收对象
-    batteryMonitor = new BatteryMonitor(webSocketWorker, this);         // 电池数据
-    imuMonitor = new ImuMonitor(webSocketWorker, this);                 // IMU数据
-   
-    // 创建 cameraImageMonitor 时不指定父对象，并将其移动到 imageThread进行处理,订阅压缩图像
-    QString camera_topic = loadTopicFromConfig("cameraCompressed_topic");
-    cameraImageMonitor = new CameraImageMonitor(webSocketWorker, nullptr, camera_topic); // 图像数据（无父以便移动线程）
-    imageThread = new QThread(this);
-    cameraImageMonitor->moveToThread(imageThread);
-    imageThread->start();
-    connect(imageThread, &QThread::finished, cameraImageMonitor, &QObject::deleteLater);
     // Ensure image display label does not resize itself to the pixmap
     if (ui->imageRawDisplay) {
         // Let the worker scale to the desired target size and avoid QLabel auto-scaling to prevent blur
         ui->imageRawDisplay->setScaledContents(false);
         ui->imageRawDisplay->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
     }
-    // 设置目标显示尺寸和最大帧率（在 worker 线程中设置）
-    if (ui->imageRawDisplay) {
-        QSize target = ui->imageRawDisplay->size();
-        QMetaObject::invokeMethod(cameraImageMonitor, "setTargetSize", Qt::QueuedConnection, Q_ARG(QSize, target));
-    }
-    // 将帧率限制到 20 FPS 默认以减少延迟和 CPU 负载
-    QMetaObject::invokeMethod(cameraImageMonitor, "setMaxFps", Qt::QueuedConnection, Q_ARG(int, 20));
     // 安装事件过滤器以在 imageRawDisplay 尺寸变更时更新目标尺寸
     if (ui->imageRawDisplay) {
         ui->imageRawDisplay->installEventFilter(this);
     }
  
-    // connect imagePullTimer once to cameraImageMonitor requestFrame (use queued connection)
-    if (imagePullTimer && cameraImageMonitor) {
-        connect(imagePullTimer, &QTimer::timeout, this, [this]() {
-            QMetaObject::invokeMethod(cameraImageMonitor, "requestFrame", Qt::QueuedConnection);
-        });
+    // connect imagePullTimer once; 只拉取当前选中机器人的最新帧和最新 IMU 数据
+    connect(imagePullTimer, &QTimer::timeout, this, [this]() {
+        RobotSession *session = currentSession();
+        if (session && session->cameraImageMonitor) {
+            QMetaObject::invokeMethod(session->cameraImageMonitor, "requestFrame", Qt::QueuedConnection);
+        }
+        ImuSample sample;
+        MessageStamps stamps;
+        if (session && session->imuMonitor && session->imuMonitor->mailbox().take(&sample, &stamps)) {
+            showImu(sample);
+            stamps.markDisplayed(session->imuMonitor->mailbox().topic());
+        }
+    });
+}
+
+// 更新IMU数据显示（只显示消息中出现的字段）
+void robanweb::showImu(const ImuSample &sample)
+{
+    const rosmsg::Imu &imu = sample.imu;
+    if (sample.seen & TypedDecoder::fieldBit<rosmsg::Imu>("orientation")) {
+        ui->ori_w->setText(QString::number(imu.orientation.w, 'f', 2));
+        ui->ori_x->setText(QString::number(imu.orientation.x, 'f', 2));
+        ui->ori_y->setText(QString::number(imu.orientation.y, 'f', 2));
+        ui->ori_z->setText(QString::number(imu.orientation.z, 'f', 2));
+    }
+    if (sample.seen & TypedDecoder::fieldBit<rosmsg::Imu>("angular_velocity")) {
+        ui->ang_x->setText(QString::number(imu.angular_velocity.x, 'f', 2));
+        ui->ang_y->setText(QString::number(imu.angular_velocity.y, 'f', 2));
+        ui->ang_z->setText(QString::number(imu.angular_velocity.z, 'f', 2));
+    }
+    if (sample.seen & TypedDecoder::fieldBit<rosmsg::Imu>("linear_acceleration")) {
+        ui->lin_x->setText(QString::number(imu.linear_acceleration.x, 'f', 2));
+        ui->lin_y->setText(QString::number(imu.linear_acceleration.y, 'f', 2));
+        ui->lin_z->setText(QString::number(imu.linear_acceleration.z, 'f', 2));
+    }
+}
+
+// 为新连接的机器人创建一组监视器（ros话题接收对象）
+void robanweb::onRobotOpened(const QString &url, WebSocketWorker *worker)
+{
+    RobotSession session;
+    session.worker = worker;
+    session.status = "正在连接...";
+    session.batteryMonitor = new BatteryMonitor(worker, this);         // 电池数据
+    session.imuMonitor = new ImuMonitor(worker, this);                 // IMU数据
+
+    // 订阅配置的显示话题（压缩或原始）；解码由路由器提交到解码线程池，不再为每个机器人单独开图像线程
+    QString camera_topic = loadTopicFromConfig("camera_display_topic");
+    if (camera_topic.isEmpty()) camera_topic = loadTopicFromConfig("cameraCompressed_topic");
+    session.cameraImageMonitor = new CameraImageMonitor(worker, this, camera_topic); // 图像数据
+    // 设置目标显示尺寸和最大帧率
+    if (ui->imageRawDisplay) {
+        QSize target = ui->imageRawDisplay->size();
+        QMetaObject::invokeMethod(session.cameraImageMonitor, "setTargetSize", Qt::QueuedConnection, Q_ARG(QSize, target));
+    }
+    // 将帧率限制到 20 FPS 默认以减少延迟和 CPU 负载
+    QMetaObject::invokeMethod(session.cameraImageMonitor, "setMaxFps", Qt::QueuedConnection, Q_ARG(int, 20));
+
+    // 各机器人的数据只在其被选中时更新界面
+    connect(session.batteryMonitor, &BatteryMonitor::batteryLevelChanged, this, [this, url](int pct){
+        auto it = robots.find(url);
+        if (it != robots.end()) it->batteryLevel = pct;
+        if (url == currentRobot && batteryProgressBar) batteryProgressBar->setValue(pct);
+    }, Qt::QueuedConnection);
+
+    // 从ros话题获取图像信息
+    connect(session.cameraImageMonitor, &CameraImageMonitor::imageReceived, this, [this, url](const QImage &img){
+        if (url == currentRobot && ui->imageRawDisplay) {
+            // Worker should already provide an image scaled to the target size; set directly to avoid resampling blur
+            ui->imageRawDisplay->setPixmap(QPixmap::fromImage(img));
+        }
+    }, Qt::QueuedConnection);
+
+    // 录制状态由 worker 报告（打开文件失败时也会回到未录制）
+    connect(worker, &WebSocketWorker::recordingChanged, this, [this, url](bool recording, const QString &path){
+        auto it = robots.find(url);
+        if (it != robots.end()) it->recording = recording;
+        qDebug() << (recording ? "开始录制:" : "停止录制:") << url << path;
+        if (url == currentRobot) updateRecordButton();
+    }, Qt::QueuedConnection);
+
+    robots.insert(url, session);
+    if (robotSelector) {
+        robotSelector->addItem(url);    // 第一个机器人加入时会触发 onRobotSelected
     }
+}
 
-    
+// 机器人连接即将销毁：先释放其监视器，避免监视器持有失效的 worker
+void robanweb::onRobotClosing(const QString &url, WebSocketWorker *worker)
+{
+    Q_UNUSED(worker)
+    destroyRobotSession(url);
 }
 
+void robanweb::destroyRobotSession(const QString &url)
+{
+    auto it = robots.find(url);
+    if (it == robots.end()) return;
+    RobotSession session = it.value();
+    robots.erase(it);
+
+    // 监视器析构时从路由器注销并等待正在执行的解码任务
+    delete session.cameraImageMonitor;
+    delete session.batteryMonitor;
+    delete session.imuMonitor;
+
+    if (robotSelector) {
+        int index = robotSelector->findText(url);
+        if (index >= 0) robotSelector->removeItem(index);
+    }
+    if (robots.isEmpty()) {
+        currentRobot.clear();
+        if (imagePullTimer) imagePullTimer->stop();
+        updateStatusLabel("未连接");
+    }
+}
+
+robanweb::RobotSession *robanweb::currentSession()
+{
+    auto it = robots.find(currentRobot);
+    return it == robots.end() ? nullptr : &it.value();
+}
 
 // 设置状态栏组件
 void robanweb::settingStatusBar(){
+    // 机器人选择
+    robotSelector = new QComboBox();
+    robotSelector->setMinimumWidth(160);
+    robotSelector->setToolTip("选择要显示和控制的机器人");
+    ui->statusbar->addWidget(robotSelector);
     // 连接状态
     connect_label = new QLabel("未连接");
     connect_label->setMinimumWidth(100);
@@ -126,68 +208,36 @@ void robanweb::bindSlots(){
     connect(ui->SLAM_Control_Button, &QPushButton::clicked, this, &robanweb::onSlamControlButtonClicked);
     // 语音控制按钮槽
     connect(ui->voice_Button, &QPushButton::clicked, this, &robanweb::onVoiceControlButtonClicked);
-
-    // 当线程启动时可做初始化
-    connect(webSocketThread, &QThread::finished, webSocketWorker, &QObject::deleteLater);
-
-    // 连接 worker 的信号到主线程槽
-    connect(webSocketWorker, &WebSocketWorker::connected, this, &robanweb::onWebSocketConnected);
-    connect(webSocketWorker, &WebSocketWorker::disconnected, this, &robanweb::onWebSocketDisconnected);
-    // connect(webSocketWorker, &WebSocketWorker::messageReceived, this, &robanweb::onWebSocketMessageReceived);
-    connect(webSocketWorker, &WebSocketWorker::errorOccurred, this, &robanweb::onWebSocketError);
-
-    // 保留 UI 侧的重连策略触发器
-    connect(reconnectTimer, &QTimer::timeout, this, &robanweb::tryReconnect);
-
-    // 从ros话题获取电量信息
-    connect(webSocketWorker, &WebSocketWorker::messageReceived, batteryMonitor, &BatteryMonitor::onMessageReceived, Qt::QueuedConnection);
-    connect(batteryMonitor, &BatteryMonitor::batteryLevelChanged, this, [this](int pct){
-        if (batteryProgressBar) batteryProgressBar->setValue(pct);
-    }, Qt::QueuedConnection);
-    
-    // 从ros话题获取IMU信息
-    connect(webSocketWorker, &WebSocketWorker::messageReceived, imuMonitor, &ImuMonitor::onMessageReceived, Qt::QueuedConnection);
-    
-    // 从ros话题获取图像信息
-    connect(webSocketWorker, &WebSocketWorker::messageReceived, cameraImageMonitor, &CameraImageMonitor::onMessageReceived, Qt::QueuedConnection);
-    connect(cameraImageMonitor, &CameraImageMonitor::imageReceived, this, [this](const QImage &img){
-        if (ui->imageRawDisplay) {
-            // Worker should already provide an image scaled to the target size; set directly to avoid resampling blur
-            ui->imageRawDisplay->setPixmap(QPixmap::fromImage(img));
-        }
-    }, Qt::QueuedConnection);
-
-
-    // 更新IMU数据显示
-    connect(imuMonitor, &ImuMonitor::orientationUpdated, this, [this](double w, double x, double y, double z){
-        if (ui) {
-            ui->ori_w->setText(QString::number(w, 'f', 2));
-            ui->ori_x->setText(QString::number(x, 'f', 2));
-            ui->ori_y->setText(QString::number(y, 'f', 2));
-            ui->ori_z->setText(QString::number(z, 'f', 2));
-        }
-    }, Qt::QueuedConnection);
-    connect(imuMonitor, &ImuMonitor::angularVelocityUpdated, this, [this](double x, double y, double z){
-        if (ui) {
-            ui->ang_x->setText(QString::number(x, 'f', 2));
-            ui->ang_y->setText(QString::number(y, 'f', 2));
-            ui->ang_z->setText(QString::number(z, 'f', 2));
-        }
-    }, Qt::QueuedConnection);
-    connect(imuMonitor, &ImuMonitor::linearAccelerationUpdated, this, [this](double x, double y, double z){
-        if (ui) {
-            ui->lin_x->setText(QString::number(x, 'f', 2));
-            ui->lin_y->setText(QString::number(y, 'f', 2));
-            ui->lin_z->setText(QString::number(z, 'f', 2));
-        }
-    }, Qt::QueuedConnection);
-    
-
+    // 话题统计按钮槽
+    connect(ui->metrics_Button, &QPushButton::clicked, this, &robanweb::onMetricsButtonClicked);
+    // 话题列表按钮槽
+    connect(ui->topics_Button, &QPushButton::clicked, this, &robanweb::onTopicsButtonClicked);
+    // 录制按钮槽
+    connect(ui->record_Button, &QPushButton::clicked, this, &robanweb::onRecordButtonClicked);
+    // 回放按钮槽
+    connect(ui->replay_Button, &QPushButton::clicked, this, &robanweb::onReplayButtonClicked);
+    // 机器人选择
+    connect(robotSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &robanweb::onRobotSelected);
+
+    // 连接管理器的信号（已带上机器人 url）到主线程槽
+    connect(connectionManager, &ConnectionManager::robotOpened, this, &robanweb::onRobotOpened);
+    connect(connectionManager, &ConnectionManager::robotClosing, this, &robanweb::onRobotClosing);
+    connect(connectionManager, &ConnectionManager::robotConnected, this, &robanweb::onWebSocketConnected);
+    connect(connectionManager, &ConnectionManager::robotDisconnected, this, &robanweb::onWebSocketDisconnected);
+    connect(connectionManager, &ConnectionManager::robotError, this, &robanweb::onWebSocketError);
+    // 重连由各 worker 的状态机负责，这里只更新状态显示
+    connect(connectionManager, &ConnectionManager::robotReconnecting, this, &robanweb::onWebSocketReconnecting);
 }
 // SLAM控制按钮槽函数
 void robanweb::onSlamControlButtonClicked()
 {
-    ShDialog dialog(webSocketWorker, this);
+    RobotSession *session = currentSession();
+    if (!session) {
+        qDebug() << "未连接机器人，无法打开SLAM控制";
+        return;
+    }
+    ShDialog dialog(session->worker, this);
+    dialog.setWindowTitle(dialog.windowTitle() + " - " + currentRobot);
     // connect dialog signal to main slot
     // connect(&dialog, &ShDialog::runScriptRequested, this, &robanweb::onRunScriptRequested, Qt::QueuedConnection);
     if(dialog.exec() == QDialog::Accepted){
@@ -205,16 +255,19 @@ void robanweb::onConnectSettingButtonClicked(){
         qDebug() << "连接确认";
     } else {
         // 用户点击了断开连接按钮
-        if (webSocketWorker) {
-            qDebug() << "请求 worker 关闭 WebSocket 连接...";
-            QMetaObject::invokeMethod(webSocketWorker, "closeConnection", Qt::QueuedConnection);
-            updateStatusLabel("未连接");
-        }
+        qDebug() << "请求关闭全部 WebSocket 连接...";
+        connectionManager->closeAll();
+        updateStatusLabel("未连接");
     }
 }
 
-// 语音控制按钮槽函数
+// 语音控制按钮槽函数（发送给当前选中的机器人）
 void robanweb::onVoiceControlButtonClicked(){
+    RobotSession *session = currentSession();
+    if (!session) {
+        qDebug() << "未连接机器人，忽略语音控制";
+        return;
+    }
     QString cmd = loadCmdFromConfig("voiceControlScript");
     if (!cmd.isEmpty()) {
         QJsonObject pub;
@@ -227,111 +280,189 @@ void robanweb::onVoiceControlButtonClicked(){
         QJsonDocument doc(pub);
         QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
         // 通过 worker 发送发布消息
-        QMetaObject::invokeMethod(webSocketWorker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
-        qDebug() << "Sent exec command to robot:" << cmd;
+        QMetaObject::invokeMethod(session->worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
+        qDebug() << "Sent exec command to robot" << currentRobot << ":" << cmd;
     }else{
         qDebug() << "Voice control script command is empty in config.";
     }
 }
 
-// 建立webSocket连接
-void robanweb::establishWebSocketConnection(const QString &url)
+// 话题统计按钮槽函数：非模态面板，再次点击时激活已有窗口
+void robanweb::onMetricsButtonClicked()
 {
-    wsHost = url.split(":").value(1);
-    wsPort = url.split(":").last();
-    qDebug() << "尝试连接到 WebSocket:" << url;
-    isReconnecting = true;
-    reconnectAttempts = 0;
-    updateStatusLabel("正在连接...");
-    // 通过 worker 启动连接（跨线程异步调用startConnect方法）
-    QMetaObject::invokeMethod(webSocketWorker, "startConnect", Qt::QueuedConnection, Q_ARG(QString, url));
+    if (!metricsDialog) {
+        metricsDialog = new MetricsDialog(this);
+    }
+    metricsDialog->show();
+    metricsDialog->raise();
+    metricsDialog->activateWindow();
 }
 
-// 重连
-void robanweb::tryReconnect()
+// 话题列表：查询当前机器人的话题（每次打开都按当前机器人重新查询）
+void robanweb::onTopicsButtonClicked()
 {
-    if (!wsHost.isEmpty() && !wsPort.isEmpty() && isReconnecting) {
-        QString url = QString("ws://%1:%2").arg(wsHost).arg(wsPort);
-        qDebug() << "尝试重新连接到 WebSocket:" << url << " (尝试次数:" << reconnectAttempts + 1 << ")";
-        reconnectAttempts++;
-        QMetaObject::invokeMethod(webSocketWorker, "startConnect", Qt::QueuedConnection, Q_ARG(QString, url));
-        updateStatusLabel(QString("正在重连... (尝试 %1/%2)").arg(reconnectAttempts).arg(MAX_RECONNECT_ATTEMPTS));
-    }else if (reconnectAttempts >= MAX_RECONNECT_ATTEMPTS) {
-        isReconnecting = false;
-        reconnectTimer->stop();
-        updateStatusLabel("连接失败：达到最大重试次数");
-        qDebug() << "达到最大重试次数，停止重连";
+    RobotSession *session = currentSession();
+    if (!session) {
+        qDebug() << "未连接机器人，无法查询话题";
+        return;
     }
+    if (topicBrowserDialog) topicBrowserDialog->close();
+    topicBrowserDialog = new TopicBrowserDialog(session->worker, this);
+    topicBrowserDialog->setWindowTitle(topicBrowserDialog->windowTitle() + " - " + currentRobot);
+    topicBrowserDialog->show();
 }
 
-// WebSocket 连接成功处理
-void robanweb::onWebSocketConnected()
+// 录制当前机器人的会话，文件保存在程序目录的 recordings 下，以机器人地址和开始时间命名
+void robanweb::onRecordButtonClicked()
 {
-    qDebug() << "WebSocket 连接成功";
-    isReconnecting = false;
-    reconnectTimer->stop();
-    reconnectAttempts = 0;
-    updateStatusLabel("已连接");
-    // 连接成功后启动话题订阅
-    startSubscriptions();  
-    // 启动 image pull timer (already connected in init)
-    if (imagePullTimer && cameraImageMonitor) {
-        imagePullTimer->start();
+    RobotSession *session = currentSession();
+    if (!session) {
+        qDebug() << "未连接机器人，无法录制";
+        return;
+    }
+    if (session->recording) {
+        QMetaObject::invokeMethod(session->worker, "stopRecording", Qt::QueuedConnection);
+        return;
     }
+    const QUrl url(currentRobot);
+    const QString name = QString("%1_%2_%3.rbrec").arg(url.host()).arg(url.port())
+                             .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    const QString path = QCoreApplication::applicationDirPath() + "/recordings/" + name;
+    QMetaObject::invokeMethod(session->worker, "startRecording", Qt::QueuedConnection, Q_ARG(QString, path));
 }
 
-void robanweb::startSubscriptions(){
-    qDebug() << "开始订阅话题流程...";
-    
-    // 延迟启动订阅，确保一次只启动一个订阅
-    QTimer::singleShot(100, this, [this]() {
-        // 首先启动IMU订阅
-        if(imuMonitor){
-            qDebug() << "启动IMU订阅...";
-            QMetaObject::invokeMethod(imuMonitor, "start", Qt::QueuedConnection);
-        } else {
-            qDebug() << "IMU监视器为空，无法启动订阅";
-        }
-    });
-    
-    // 延迟500毫秒后启动电量订阅
-    QTimer::singleShot(500, this, [this]() {
-        if (batteryMonitor) {
-            qDebug() << "启动电量订阅...";
-            QMetaObject::invokeMethod(batteryMonitor, "start", Qt::QueuedConnection);
-        } else {
-            qDebug() << "电池监视器为空，无法启动订阅";
-        }
+// 回放录制文件：作为一个 "replay://文件名" 的机器人加入选择框，监视器和界面与在线时相同；关闭回放窗口即结束回放
+void robanweb::onReplayButtonClicked()
+{
+    const QString path = QFileDialog::getOpenFileName(this, "选择录制文件",
+                                                      QCoreApplication::applicationDirPath() + "/recordings",
+                                                      "会话录制 (*.rbrec)");
+    if (path.isEmpty()) return;
+    ReplaySource *replay = connectionManager->openReplay(path);
+    if (!replay) return;
+    const QString url = QStringLiteral("replay://") + QFileInfo(path).fileName();
+    if (robotSelector) robotSelector->setCurrentText(url);
+
+    ReplayDialog *dialog = new ReplayDialog(replay, this);
+    dialog->setWindowTitle(dialog->windowTitle() + " - " + QFileInfo(path).fileName());
+    // 主窗口析构时连接管理器可能先于窗口被销毁（它会自行关闭全部连接）
+    QPointer<ConnectionManager> manager = connectionManager;
+    connect(dialog, &QObject::destroyed, this, [manager, url]() {
+        if (manager) manager->close(url);
     });
-    
-    // 延迟1000毫秒后启动图像订阅（如果需要）
-    QTimer::singleShot(1000, this, [this]() {
-        if(cameraImageMonitor){
-            qDebug() << "启动图像订阅...";
-            QMetaObject::invokeMethod(cameraImageMonitor, "start", Qt::QueuedConnection);
-        } else {
-            qDebug() << "相机监视器为空，无法启动订阅";
+    dialog->show();
+    QMetaObject::invokeMethod(replay, "open", Qt::QueuedConnection, Q_ARG(QString, path));
+}
+
+void robanweb::updateRecordButton()
+{
+    RobotSession *session = currentSession();
+    ui->record_Button->setText(session && session->recording ? "停止录制" : "开始录制");
+}
+
+// 建立webSocket连接：每个勾选的机器人一个连接，未勾选的已有连接断开
+void robanweb::establishWebSocketConnection(const QStringList &urls)
+{
+    const QStringList existing = connectionManager->urls();
+    for (const QString &url : existing) {
+        if (connectionManager->replay(url)) continue;   // 回放由回放窗口管理
+        if (!urls.contains(url)) {
+            connectionManager->close(url);
         }
-    });
+    }
+    for (const QString &url : urls) {
+        if (connectionManager->contains(url)) continue;
+        qDebug() << "尝试连接到 WebSocket:" << url;
+        connectionManager->open(url);
+    }
 }
 
-void robanweb::onWebSocketDisconnected()
+// 切换当前机器人：界面改为显示该机器人的状态和数据
+void robanweb::onRobotSelected(int index)
 {
-    qDebug() << "WebSocket 连接断开";
-    if (isReconnecting) {
-        reconnectTimer->start();
-        updateStatusLabel("连接断开，正在重连...");
+    currentRobot = (robotSelector && index >= 0) ? robotSelector->itemText(index) : QString();
+    qDebug() << "当前机器人:" << currentRobot;
+    if (ui->imageRawDisplay) ui->imageRawDisplay->clear();
+
+    updateRecordButton();
+
+    RobotSession *session = currentSession();
+    if (!session) {
+        if (imagePullTimer) imagePullTimer->stop();
+        updateStatusLabel("未连接");
+        return;
     }
-    if (imagePullTimer) imagePullTimer->stop();
+    updateStatusLabel(session->status);
+    if (batteryProgressBar) batteryProgressBar->setValue(session->batteryLevel);
+    // 立即显示该机器人最近的 IMU 数据，不等下一条消息
+    ImuSample sample;
+    if (session->imuMonitor && session->imuMonitor->mailbox().peek(&sample)) showImu(sample);
+    if (imagePullTimer) {
+        if (connectionManager->isConnected(currentRobot)) imagePullTimer->start();
+        else imagePullTimer->stop();
+    }
+}
+
+void robanweb::setRobotStatus(const QString &url, const QString &status)
+{
+    auto it = robots.find(url);
+    if (it != robots.end()) it->status = status;
+    if (url == currentRobot) updateStatusLabel(status);
+}
+
+// worker 进入重连退避
+void robanweb::onWebSocketReconnecting(const QString &url, int attempt, int delayMs)
+{
+    setRobotStatus(url, QString("连接断开，%1 ms 后重连... (第 %2 次)").arg(delayMs).arg(attempt));
 }
 
-void robanweb::onWebSocketError(const QString &error)
+// WebSocket 连接成功处理
+void robanweb::onWebSocketConnected(const QString &url)
 {
-    qDebug() << "WebSocket 错误:" << error;
-    if (isReconnecting) {
-        reconnectTimer->start();
-        updateStatusLabel(QString("连接错误：%1，正在重连...").arg(error));
+    qDebug() << "WebSocket 连接成功:" << url;
+    setRobotStatus(url, "已连接");
+    auto it = robots.find(url);
+    if (it == robots.end()) return;
+    // 连接成功后启动话题订阅；订阅按使用者引用计数，重复 start() 不会重复订阅，
+    // 重连时 worker 会自行重放已有订阅
+    startSubscriptions(it.value());
+    // 启动 image pull timer (already connected in init)
+    if (url == currentRobot && imagePullTimer) {
+        imagePullTimer->start();
+    }
+}
+
+// 各监视器直接启动：订阅请求在 worker 的发送队列中按批次流水线发出，无需错开
+void robanweb::startSubscriptions(const RobotSession &session){
+    qDebug() << "开始订阅话题流程...";
+    if (session.imuMonitor) {
+        QMetaObject::invokeMethod(session.imuMonitor, "start", Qt::QueuedConnection);
+    } else {
+        qDebug() << "IMU监视器为空，无法启动订阅";
+    }
+    if (session.batteryMonitor) {
+        QMetaObject::invokeMethod(session.batteryMonitor, "start", Qt::QueuedConnection);
+    } else {
+        qDebug() << "电池监视器为空，无法启动订阅";
     }
+    if (session.cameraImageMonitor) {
+        QMetaObject::invokeMethod(session.cameraImageMonitor, "start", Qt::QueuedConnection);
+    } else {
+        qDebug() << "相机监视器为空，无法启动订阅";
+    }
+}
+
+void robanweb::onWebSocketDisconnected(const QString &url)
+{
+    qDebug() << "WebSocket 连接断开:" << url;
+    setRobotStatus(url, "连接断开");
+    if (url == currentRobot && imagePullTimer) imagePullTimer->stop();
+}
+
+void robanweb::onWebSocketError(const QString &url, const QString &error)
+{
+    qDebug() << "WebSocket 错误:" << url << error;
+    setRobotStatus(url, QString("连接错误：%1").arg(error));
 }
 
 // void robanweb::onWebSocketMessageReceived(const QString &message)
@@ -395,27 +526,12 @@ void robanweb::updateStatusLabel(const QString &status)
 
 void robanweb::closeEvent(QCloseEvent *event)
 {
-    isReconnecting = false;
-    reconnectTimer->stop();
-    if (webSocketWorker) {
-        QMetaObject::invokeMethod(webSocketWorker, "closeConnection", Qt::QueuedConnection);
-        webSocketThread->quit();
-        webSocketThread->wait();
-        delete webSocketThread;
-        webSocketThread = nullptr;
-        webSocketWorker = nullptr; // worker deleted when thread finishes (connected earlier)
-    }
-    if (imageThread){
-        imageThread->quit();
-        imageThread->wait();
-        delete imageThread;
-        imageThread = nullptr;
-        cameraImageMonitor = nullptr;
-    }
     if (imagePullTimer) {
         imagePullTimer->stop();
-        delete imagePullTimer;
-        imagePullTimer = nullptr;
+    }
+    // 释放各机器人的监视器并停止 worker 线程（worker 在 thread finished 时 deleteLater）
+    if (connectionManager) {
+        connectionManager->closeAll();
     }
     event->accept();
 }
@@ -424,8 +540,10 @@ bool robanweb::eventFilter(QObject *watched, QEvent *event)
 {
     if (watched == ui->imageRawDisplay && event->type() == QEvent::Resize) {
         QSize newSize = ui->imageRawDisplay->size();
-        if (cameraImageMonitor) {
-            QMetaObject::invokeMethod(cameraImageMonitor, "setTargetSize", Qt::QueuedConnection, Q_ARG(QSize, newSize));
+        for (const RobotSession &session : robots) {
+            if (session.cameraImageMonitor) {
+                QMetaObject::invokeMethod(session.cameraImageMonitor, "setTargetSize", Qt::QueuedConnection, Q_ARG(QSize, newSize));
+            }
         }
     }
     return QMainWindow::eventFilter(watched, event);
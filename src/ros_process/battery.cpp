@@ -1,6 +1,8 @@
 #include "ros_process/battery.h"
 #include "socket_process/websocketworker.h"
 #include "util/load_param.hpp"
+#include "util/topicmetrics.h"
+#include "socket_process/typeddecoder.h"
 
 // Map voltage to percent using a simple linear mapping as placeholder
 // You can replace this with the more complex table from the python script if needed
@@ -12,7 +14,11 @@ BatteryMonitor::BatteryMonitor(WebSocketWorker *worker, QObject *parent)
 {
     battery_topic_name = loadTopicFromConfig("battery_topic");
 }
-BatteryMonitor::~BatteryMonitor() {}
+// 处理槽在解码线程池中执行，析构前从路由器注销并等待正在执行的解码结束
+BatteryMonitor::~BatteryMonitor()
+{
+    if (m_worker) m_worker->router()->removeReceiver(this);
+}
 
 // 订阅电量话题
 void BatteryMonitor::start()
@@ -30,45 +36,29 @@ void BatteryMonitor::start()
     }
     
     qDebug() << "BatteryMonitor::start() - 订阅话题: " << battery_topic_name;
+    m_worker->router()->addHandler(battery_topic_name, this);
     
     // send subscribe request for BatteryState
-    QJsonObject subscribeMsg;
-    subscribeMsg["op"] = "subscribe";
-    subscribeMsg["topic"] = battery_topic_name;
-    subscribeMsg["type"] = "sensor_msgs/BatteryState";
-    QJsonDocument doc(subscribeMsg);
-    QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-    QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
+    m_worker->subscribeTopic(this, battery_topic_name, QStringLiteral("sensor_msgs/BatteryState"));
 }
 
 
 
 
 
-void BatteryMonitor::onMessageReceived(const QString &message)
+// 路由器已完成信封解析，这里只处理电池话题的 msg
+void BatteryMonitor::onRosMessage(const RosMessage &message)
 {
-    // 解析JSON消息
-    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-    if (!doc.isObject()) return;
-    QJsonObject obj = doc.object();
-
-    // 检查操作类型
-    if (obj["op"].toString() != "publish") return;
-    
-    // 检查话题
-    QString topic = obj["topic"].toString();
-    if (topic.isEmpty()) return; // 跳过空话题
-    
     // 确保是我们关心的电池话题
-    if (topic != battery_topic_name) return;
-    
-    // 检查消息对象
-    if (!obj.contains("msg") || !obj["msg"].isObject()) return;
-    QJsonObject msgObj = obj["msg"].toObject();
+    if (message.topic != battery_topic_name) return;
+    TopicMetrics::ScopedTimer decodeTimer(message.metrics, TopicMetrics::Decode);
     
-    // 提取电压字段
-    if (!msgObj.contains("voltage")) return;
-    double voltage = msgObj["voltage"].toDouble();
+    // 提取电压字段（按 sensor_msgs/BatteryState 字段表解码）
+    rosmsg::BatteryState battery;
+    quint32 seen = 0;
+    if (!TypedDecoder::decode(message, &battery, &seen)) return;
+    if (!(seen & TypedDecoder::fieldBit<rosmsg::BatteryState>("voltage"))) return;
+    double voltage = battery.voltage;
     
     // 转换电压为百分比并发送信号
     int percent = voltageToPercent(voltage);
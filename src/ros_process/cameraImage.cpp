@@ -1,6 +1,9 @@
 #include "ros_process/cameraImage.h"
 #include "socket_process/websocketworker.h"
 #include "util/load_param.hpp"
+#include "util/topicmetrics.h"
+#include "util/tracerecorder.h"
+#include "socket_process/typeddecoder.h"
 
 CameraImageMonitor::CameraImageMonitor(WebSocketWorker *worker, QObject *parent, const QString &topic_name)
     : QObject(parent), m_worker(worker)
@@ -11,15 +14,21 @@ CameraImageMonitor::CameraImageMonitor(WebSocketWorker *worker, QObject *parent,
     topic_parse();
 }
 
-CameraImageMonitor::~CameraImageMonitor() {}
+// 处理槽在解码线程池中执行，析构前从路由器注销并等待正在执行的解码结束
+CameraImageMonitor::~CameraImageMonitor()
+{
+    if (m_worker) m_worker->router()->removeReceiver(this);
+}
 
 // 设置显示尺寸
 void CameraImageMonitor::setTargetSize(const QSize &size) {
+    QMutexLocker locker(&m_latestMutex);
     m_targetSize = size;
 }
 // 设置最大帧率
 void CameraImageMonitor::setMaxFps(int fps) {
     if (fps <= 0) return;
+    QMutexLocker locker(&m_latestMutex);
     m_frameIntervalMs = 1000 / fps;
 }
 
@@ -51,22 +60,19 @@ void CameraImageMonitor::topic_parse(){
         qDebug() << "正在从配置文件加载话题: " << configPath;
     }
 
-    // cameraCompressed_topic_name = loadTopicFromConfig("cameraCompressed_topic");
-    cameraCompressed_topic_name = "/camera/color/image_raw/compressed"   ;
-    // cameraCompressed_topic_type = loadTopicFromConfig("cameraCompressed_topic_type");
-    cameraCompressed_topic_type = "sensor_msgs/CompressedImage";
-    // cameraRaw_topic_name = loadTopicFromConfig("cameraRaw_topic");
-    // cameraRaw_topic_type = loadTopicFromConfig("cameraRaw_topic_type");
-    cameraRaw_topic_name =  "/camera/color/image_raw"  ;
-    cameraRaw_topic_type = "sensor_msgs/Image";
-    // featureImageRaw_topic_name = loadTopicFromConfig("featureImageRaw_topic");
-    // featureImageRaw_topic_type = loadTopicFromConfig("featureImageRaw_topic_type");
-    featureImageRaw_topic_name = "/SLAM/FeaturePoint/Image";
-    featureImageRaw_topic_type = "sensor_msgs/Image";
-    // featureImageCompressed_topic_name = loadTopicFromConfig("featureImageCompressed_topic");
-    // featureImageCompressed_topic_type = loadTopicFromConfig("featureImageCompressed_topic_type");
-    featureImageCompressed_topic_name =  "/SLAM/FeaturePoint/Image/compressed"    ;
-    featureImageCompressed_topic_type =  "sensor_msgs/CompressedImage";
+    // 配置文件缺少某项时使用默认话题
+    auto topicOrDefault = [](const char *key, const QString &fallback) {
+        const QString value = loadTopicFromConfig(QString::fromLatin1(key));
+        return value.isEmpty() ? fallback : value;
+    };
+    cameraCompressed_topic_name = topicOrDefault("cameraCompressed_topic", "/camera/color/image_raw/compressed");
+    cameraCompressed_topic_type = topicOrDefault("cameraCompressed_topic_type", "sensor_msgs/CompressedImage");
+    cameraRaw_topic_name = topicOrDefault("cameraRaw_topic", "/camera/color/image_raw");
+    cameraRaw_topic_type = topicOrDefault("cameraRaw_topic_type", "sensor_msgs/Image");
+    featureImageRaw_topic_name = topicOrDefault("featureImageRaw_topic", "/SLAM/FeaturePoint/Image");
+    featureImageRaw_topic_type = topicOrDefault("featureImageRaw_topic_type", "sensor_msgs/Image");
+    featureImageCompressed_topic_name = topicOrDefault("featureImageCompressed_topic", "/SLAM/FeaturePoint/Image/compressed");
+    featureImageCompressed_topic_type = topicOrDefault("featureImageCompressed_topic_type", "sensor_msgs/CompressedImage");
     // 打印调试信息，检查配置是否成功加载
     qDebug() << "话题解析结果:";
     qDebug() << "相机压缩话题: " << (cameraCompressed_topic_name.isEmpty() ? "空" : cameraCompressed_topic_name) 
@@ -84,24 +90,23 @@ void CameraImageMonitor::topic_parse(){
         qDebug() << "使用默认话题: " << act_topic_name;
     }
     
-    // 根据话题名称设置对应的类型
-    if(!act_topic_name.isEmpty()) {
-        if(act_topic_name == cameraCompressed_topic_name || act_topic_name == featureImageCompressed_topic_name){
-            act_topic_type = cameraCompressed_topic_type;
-        }else if(act_topic_name == cameraRaw_topic_name || act_topic_name == featureImageRaw_topic_name){
-            act_topic_type = cameraRaw_topic_type;  
-        }else{
-            // 默认使用压缩图像话题
-            if(!cameraCompressed_topic_name.isEmpty()) {
-                act_topic_name = cameraCompressed_topic_name;
-                act_topic_type = cameraCompressed_topic_type;
-                qDebug() << "使用默认压缩图像话题: " << act_topic_name;
-            }
-        }
+    // 根据话题名称设置对应的类型；不在配置中的话题按名称后缀判断
+    if (act_topic_name == cameraCompressed_topic_name) {
+        act_topic_type = cameraCompressed_topic_type;
+    } else if (act_topic_name == featureImageCompressed_topic_name) {
+        act_topic_type = featureImageCompressed_topic_type;
+    } else if (act_topic_name == cameraRaw_topic_name) {
+        act_topic_type = cameraRaw_topic_type;
+    } else if (act_topic_name == featureImageRaw_topic_name) {
+        act_topic_type = featureImageRaw_topic_type;
+    } else if (!act_topic_name.isEmpty()) {
+        act_topic_type = act_topic_name.endsWith("/compressed") ? QString("sensor_msgs/CompressedImage") : QString("sensor_msgs/Image");
     } else {
         qDebug() << "警告: 无法设置有效的话题名称";
     }
-    
+    // 解码方式由话题类型决定：CompressedImage 按 JPEG/PNG 解码，Image 按原始像素解码
+    m_compressedMode = act_topic_type == "sensor_msgs/CompressedImage";
+
     qDebug() << "最终使用的话题: " << act_topic_name << ", 类型: " << act_topic_type;
 }
 
@@ -121,39 +126,15 @@ void CameraImageMonitor::start(){
     qDebug() << "正在检查要订阅的话题...";
     qDebug() << "当前设置的实际话题: " << (act_topic_name.isEmpty() ? "空" : act_topic_name)
              << ", 类型: " << (act_topic_type.isEmpty() ? "空" : act_topic_type);
-    
-    // 只订阅IMU话题
 
-    if(!cameraCompressed_topic_name.isEmpty()) {
-        // 订阅IMU话题
-        QJsonObject subscribeMsg;
-        subscribeMsg["op"] = "subscribe";
-        subscribeMsg["topic"] = cameraCompressed_topic_name;
-        subscribeMsg["type"] = cameraCompressed_topic_type;
-        QJsonDocument doc(subscribeMsg);
-        QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-        // qDebug() << "订阅IMU话题: " << imu_topic;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
-    } else {
-        qDebug() << "IMU话题为空，跳过订阅";
+    if (act_topic_name.isEmpty()) {
+        qDebug() << "错误: 话题名称为空，无法订阅";
+        return;
     }
 
-    if(!featureImageCompressed_topic_name.isEmpty()) {
-        // 订阅IMU话题
-        QJsonObject subscribeMsg;
-        subscribeMsg["op"] = "subscribe";
-        subscribeMsg["topic"] = featureImageCompressed_topic_name;
-        subscribeMsg["type"] = featureImageCompressed_topic_type;
-        QJsonDocument doc(subscribeMsg);
-        QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-        // qDebug() << "订阅IMU话题: " << imu_topic;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
-    } else {
-        qDebug() << "IMU话题为空，跳过订阅";
-    }
-    
-    // 暂时不订阅相机话题，直到我们解决空话题问题
-    qDebug() << "跳过相机话题订阅，专注于修复空话题错误";
+    // 只订阅实际显示的话题，限频/传输方式等QoS由配置文件的 topic_qos 决定
+    m_worker->router()->addHandler(act_topic_name, this);
+    m_worker->subscribeTopic(this, act_topic_name, act_topic_type);
 }
 
 void CameraImageMonitor::stop() {
@@ -164,32 +145,13 @@ void CameraImageMonitor::stop() {
         return;
     }
     
-    // QString imu_topic = loadTopicFromConfig("imu_topic");
-    
-    // 暂时不取消订阅相机话题，因为我们也没有订阅它
-    qDebug() << "跳过取消订阅相机话题";
-    
-    // 检查IMU话题是否为空，不为空则取消订阅
-    if(!cameraCompressed_topic_name.isEmpty()) {
-        QJsonObject unsub;
-        unsub["op"] = "unsubscribe";
-        unsub["topic"] = cameraCompressed_topic_name;
-        QJsonDocument doc(unsub);
-        QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-        // qDebug() << "取消订阅IMU话题: " << cameraCompressed_topic_name;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
-    }
+    // 先从路由器注销，立即停止接收消息
+    m_worker->router()->removeReceiver(this);
 
-    if(!featureImageCompressed_topic_name.isEmpty()) {
-        QJsonObject unsub;
-        unsub["op"] = "unsubscribe";
-        unsub["topic"] = featureImageCompressed_topic_name;
-        QJsonDocument doc(unsub);
-        QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-        // qDebug() << "取消订阅IMU话题: " << cameraCompressed_topic_name;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
+    if (!act_topic_name.isEmpty()) {
+        m_worker->unsubscribeTopic(this, act_topic_name);
     }
-    
+
     // clear cached image
     {
         QMutexLocker locker(&m_latestMutex);
@@ -198,195 +160,220 @@ void CameraImageMonitor::stop() {
     }
 }
 
-// 转换 JSON 为 QByteArray
-static QByteArray jsonDataToByteArray(const QJsonValue &dataVal) {
-    if (dataVal.isString()) {
-        // base64 encoded string (could be compressed image like JPEG)
-        QString s = dataVal.toString();
-        return QByteArray::fromBase64(s.toUtf8());
-    } else if (dataVal.isArray()) {
-        QJsonArray arr = dataVal.toArray();
-        QByteArray out;
-        out.reserve(arr.size());
-        for (const QJsonValue &v : arr) {
-            int iv = v.toInt();
-            out.append(static_cast<char>(iv & 0xFF));
-        }
-        return out;
+// 处理接收数据（路由器已解析信封，只会收到注册话题的 msg）
+void CameraImageMonitor::onRosMessage(const RosMessage &message) {
+    const QString &topic = message.topic;
+    if (!message.hasJson() && message.msg.isEmpty()) {
+        qDebug() << "CameraImageMonitor: 接收到的消息没有内容，话题: " << topic;
+        return;
     }
-    return QByteArray();
-}
 
-// 处理接收数据
-void CameraImageMonitor::onMessageReceived(const QString &message) {
-    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-    if (!doc.isObject()) {
-        qDebug() << "CameraImageMonitor: 接收到无效的JSON数据";
+    //qDebug() << "收到话题消息: " << topic;
+
+    // 检查是否是当前订阅的话题
+    if (topic != act_topic_name) {
+        // 忽略不是当前订阅的话题
         return;
     }
-    QJsonObject obj = doc.object();
+    TopicMetrics::ScopedTimer decodeTimer(message.metrics, TopicMetrics::Decode);
+
+    // 显示尺寸和帧率由界面线程设置，解码在线程池中进行，先取一份快照
+    QSize targetSize;
+    int frameIntervalMs;
+    {
+        QMutexLocker locker(&m_latestMutex);
+        targetSize = m_targetSize;
+        frameIntervalMs = m_frameIntervalMs;
+    }
 
-    if (obj["op"].toString() == "publish") {
-        QString topic = obj["topic"].toString();
-        if (topic.isEmpty()) {
-            qDebug() << "CameraImageMonitor: 接收到的消息没有话题名";
+    // 按 sensor_msgs/CompressedImage 或 Image 的字段表解码：JSON 文本帧直接在帧字节上读取，
+    // base64 的 data 解码到逐帧复用的缓冲区；cbor 帧的原始字节已在 message.data 中，无需 base64 解码
+    const bool compressed = m_compressedMode;
+    QString format, encoding;
+    int width = 0, height = 0;
+    bool decoded = false;
+    if (compressed) {
+        decoded = TypedDecoder::decode(message, &m_compressed);
+        if (!message.data.isEmpty()) m_compressed.data = message.data;
+        format = m_compressed.format;
+    } else {
+        decoded = TypedDecoder::decode(message, &m_raw);
+        if (!message.data.isEmpty()) m_raw.data = message.data;
+        encoding = m_raw.encoding;
+        width = int(m_raw.width);
+        height = int(m_raw.height);
+    }
+    if (!decoded) {
+        qDebug() << "CameraImageMonitor: 图像消息解析失败，话题: " << topic;
+        return;
+    }
+    const QByteArray &bytes = compressed ? m_compressed.data : m_raw.data;
+    // 机器人时间戳换算到本机时钟，随图像缓存，界面取走时记录端到端延迟
+    const MessageStamps stamps = m_worker->clockSync()->stampMessage(message.metrics, compressed ? m_compressed.header : m_raw.header, message.receivedUs);
+
+    // compressed image path: 处理压缩图像消息
+    if (compressed) {
+        // sensor_msgs/CompressedImage: has fields 'format' and 'data'
+        if (bytes.isEmpty()) {
+            qDebug() << "CameraImageMonitor: 压缩图像数据为空，话题: " << topic;
             return;
         }
-        
-        QJsonObject msgObj = obj["msg"].toObject();
-        if (msgObj.isEmpty()) {
-            qDebug() << "CameraImageMonitor: 接收到的消息没有内容，话题: " << topic;
+
+        QImage img;
+        {
+            TraceRecorder::Zone zone("camera.decodeImage", bytes.size());
+            img = QImage::fromData(bytes);
+        }
+        if (img.isNull()) {
+            qDebug() << "CameraImageMonitor: 解码压缩图像失败，格式 = " << format << " 字节数 = " << bytes.size();
             return;
         }
 
-        //qDebug() << "收到话题消息: " << topic;
-
-        // 检查是否是当前订阅的话题
-        if (topic != act_topic_name) {
-            // 忽略不是当前订阅的话题
+        // throttle and store scaled image in cache (worker thread)
+        qint64 elapsed = m_lastDecodeTimer.elapsed();
+        if (elapsed < frameIntervalMs) {
+            TopicMetrics::instance().recordSkip(message.metrics);   // 超过最大帧率的帧跳过
             return;
         }
+        m_lastDecodeTimer.restart();
 
-        // compressed image path: 处理压缩图像消息
-        if (act_topic_type.contains("CompressedImage")) {
-            // sensor_msgs/CompressedImage: has fields 'format' and 'data'
-            QString format = msgObj.value("format").toString();
-            QJsonValue dataVal = msgObj.value("data");
-            QByteArray bytes = jsonDataToByteArray(dataVal);
-            if (bytes.isEmpty()) {
-                qDebug() << "CameraImageMonitor: 压缩图像数据为空，话题: " << topic;
-                return;
-            }
+        QImage toStore;
+        if (!targetSize.isEmpty() && img.size() != targetSize) {
+            TraceRecorder::Zone zone("camera.scale");
+            toStore = img.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        } else {
+            toStore = img;
+        }
+        // normalize pixel format to avoid rendering artifacts and dangling buffers
+        {
+            TraceRecorder::Zone zone("camera.convertToFormat");
+            toStore = toStore.convertToFormat(QImage::Format_RGBA8888);
+        }
+        {
+            TraceRecorder::Zone zone("camera.storeLatest");
+            QMutexLocker locker(&m_latestMutex);
+            m_latestImage = toStore;
+            m_latestStamps = stamps;
+            qDebug() << "成功处理压缩图像，话题: " << topic << " 尺寸: " << toStore.width() << "x" << toStore.height();
+        }
+        return;
+    } 
+    // 处理原始图像消息
+    else {
+        if (width <= 0 || height <= 0) {
+            qDebug() << "CameraImageMonitor: 无效的图像尺寸，宽: " << width << " 高: " << height;
+            return;
+        }
+        
+        // 图像数据（二进制传输时直接使用原始字节）
+        if (bytes.isEmpty()) {
+            qDebug() << "CameraImageMonitor: 原始图像数据为空";
+            return;
+        }
 
-            QImage img = QImage::fromData(bytes);
-            if (img.isNull()) {
-                qDebug() << "CameraImageMonitor: 解码压缩图像失败，格式 = " << format << " 字节数 = " << bytes.size();
+        // First try to decode as compressed image (JPEG/PNG) even for raw topic payloads
+        QImage img;
+        {
+            TraceRecorder::Zone zone("camera.decodeImage", bytes.size());
+            img = QImage::fromData(bytes);
+        }
+        if (!img.isNull()) {
+            // throttle by max FPS (avoid excessive decoding)
+            qint64 elapsed = m_lastDecodeTimer.elapsed();
+            if (elapsed < frameIntervalMs) {
+                TopicMetrics::instance().recordSkip(message.metrics);   // 超过最大帧率的帧跳过
                 return;
             }
-
-            // throttle and store scaled image in cache (worker thread)
-            qint64 elapsed = m_lastDecodeTimer.elapsed();
-            if (elapsed < m_frameIntervalMs) return;
             m_lastDecodeTimer.restart();
 
+            // scale in worker thread if requested and store into latest cache
             QImage toStore;
-            if (!m_targetSize.isEmpty() && img.size() != m_targetSize) {
-                toStore = img.scaled(m_targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            if (!targetSize.isEmpty() && img.size() != targetSize) {
+                TraceRecorder::Zone zone("camera.scale");
+                toStore = img.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
             } else {
                 toStore = img;
             }
-            // normalize pixel format to avoid rendering artifacts and dangling buffers
-            toStore = toStore.convertToFormat(QImage::Format_RGBA8888);
             {
+                TraceRecorder::Zone zone("camera.convertToFormat");
+                toStore = toStore.convertToFormat(QImage::Format_RGBA8888);
+            }
+            {
+                TraceRecorder::Zone zone("camera.storeLatest");
                 QMutexLocker locker(&m_latestMutex);
                 m_latestImage = toStore;
-                qDebug() << "成功处理压缩图像，话题: " << topic << " 尺寸: " << toStore.width() << "x" << toStore.height();
+                m_latestStamps = stamps;
+                qDebug() << "成功处理压缩格式的原始图像，话题: " << topic << " 尺寸: " << toStore.width() << "x" << toStore.height();
             }
             return;
-        } 
-        // 处理原始图像消息
-        else if (act_topic_type.contains("Image")) {
-            int width = msgObj.value("width").toInt();
-            int height = msgObj.value("height").toInt();
-            QString encoding = msgObj.value("encoding").toString();
-            QJsonValue dataVal = msgObj.value("data");
-            
-            if (width <= 0 || height <= 0) {
-                qDebug() << "CameraImageMonitor: 无效的图像尺寸，宽: " << width << " 高: " << height;
-                return;
-            }
-            
-            // 将图像数据转为 QByteArray
-            QByteArray bytes = jsonDataToByteArray(dataVal);
-            if (bytes.isEmpty()) {
-                qDebug() << "CameraImageMonitor: 原始图像数据为空";
-                return;
-            }
+        }
 
-            // First try to decode as compressed image (JPEG/PNG) even for raw topic payloads
-            QImage img = QImage::fromData(bytes);
-            if (!img.isNull()) {
-                // throttle by max FPS (avoid excessive decoding)
-                qint64 elapsed = m_lastDecodeTimer.elapsed();
-                if (elapsed < m_frameIntervalMs) return;
-                m_lastDecodeTimer.restart();
+        // Otherwise interpret as raw pixel buffer. Determine bytes per pixel
+        int bpp = 3;
+        QImage::Format fmt = QImage::Format_Invalid;
+        if (encoding == "mono8" || encoding == "gray" || encoding == "mono") {
+            bpp = 1;
+            fmt = QImage::Format_Grayscale8;
+        } else if (encoding == "rgb8" || encoding == "rgb24") {
+            bpp = 3;
+            fmt = QImage::Format_RGB888;
+        } else if (encoding == "bgr8") {
+            bpp = 3;
+            // we'll construct as BGR and swap
+            fmt = QImage::Format_BGR888;
+        } else if (encoding == "rgba8" || encoding == "rgba32") {
+            bpp = 4;
+            fmt = QImage::Format_RGBA8888;
+        } else {
+            // fallback assume RGB888
+            bpp = 3;
+            fmt = QImage::Format_RGB888;
+            qDebug() << "CameraImageMonitor: 未知编码格式，默认使用RGB888: " << encoding;
+        }
 
-                // scale in worker thread if requested and store into latest cache
-                QImage toStore;
-                if (!m_targetSize.isEmpty() && img.size() != m_targetSize) {
-                    toStore = img.scaled(m_targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                } else {
-                    toStore = img;
-                }
-                toStore = toStore.convertToFormat(QImage::Format_RGBA8888);
-                {
-                    QMutexLocker locker(&m_latestMutex);
-                    m_latestImage = toStore;
-                    qDebug() << "成功处理压缩格式的原始图像，话题: " << topic << " 尺寸: " << toStore.width() << "x" << toStore.height();
-                }
-                return;
-            }
+        int expected = width * height * bpp;
+        if (bytes.size() < expected) {
+            qDebug() << "CameraImageMonitor: 原始缓冲区太小: " << bytes.size() << " 期望: " << expected << " 编码: " << encoding;
+            return;
+        }
 
-            // Otherwise interpret as raw pixel buffer. Determine bytes per pixel
-            int bpp = 3;
-            QImage::Format fmt = QImage::Format_Invalid;
-            if (encoding == "mono8" || encoding == "gray" || encoding == "mono") {
-                bpp = 1;
-                fmt = QImage::Format_Grayscale8;
-            } else if (encoding == "rgb8" || encoding == "rgb24") {
-                bpp = 3;
-                fmt = QImage::Format_RGB888;
-            } else if (encoding == "bgr8") {
-                bpp = 3;
-                // we'll construct as BGR and swap
-                fmt = QImage::Format_BGR888;
-            } else if (encoding == "rgba8" || encoding == "rgba32") {
-                bpp = 4;
-                fmt = QImage::Format_RGBA8888;
-            } else {
-                // fallback assume RGB888
-                bpp = 3;
-                fmt = QImage::Format_RGB888;
-                qDebug() << "CameraImageMonitor: 未知编码格式，默认使用RGB888: " << encoding;
-            }
+        int bytesPerLine = width * bpp;
+        if (fmt == QImage::Format_BGR888) {
+            QImage tmp(reinterpret_cast<const uchar*>(bytes.constData()), width, height, bytesPerLine, fmt);
+            img = tmp.rgbSwapped().copy();
+        } else {
+            QImage tmp(reinterpret_cast<const uchar*>(bytes.constData()), width, height, bytesPerLine, fmt);
+            img = tmp.copy();
+        }
 
-            int expected = width * height * bpp;
-            if (bytes.size() < expected) {
-                qDebug() << "CameraImageMonitor: 原始缓冲区太小: " << bytes.size() << " 期望: " << expected << " 编码: " << encoding;
+        if (!img.isNull()) {
+            qint64 elapsed = m_lastDecodeTimer.elapsed();
+            if (elapsed < frameIntervalMs) {
+                TopicMetrics::instance().recordSkip(message.metrics);   // 超过最大帧率的帧跳过
                 return;
             }
+            m_lastDecodeTimer.restart();
 
-            int bytesPerLine = width * bpp;
-            if (fmt == QImage::Format_BGR888) {
-                QImage tmp(reinterpret_cast<const uchar*>(bytes.constData()), width, height, bytesPerLine, fmt);
-                img = tmp.rgbSwapped().copy();
+            QImage toStore;
+            if (!targetSize.isEmpty() && img.size() != targetSize) {
+                TraceRecorder::Zone zone("camera.scale");
+                toStore = img.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
             } else {
-                QImage tmp(reinterpret_cast<const uchar*>(bytes.constData()), width, height, bytesPerLine, fmt);
-                img = tmp.copy();
+                toStore = img;
             }
-
-            if (!img.isNull()) {
-                qint64 elapsed = m_lastDecodeTimer.elapsed();
-                if (elapsed < m_frameIntervalMs) return;
-                m_lastDecodeTimer.restart();
-
-                QImage toStore;
-                if (!m_targetSize.isEmpty() && img.size() != m_targetSize) {
-                    toStore = img.scaled(m_targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-                } else {
-                    toStore = img;
-                }
+            {
+                TraceRecorder::Zone zone("camera.convertToFormat");
                 toStore = toStore.convertToFormat(QImage::Format_RGBA8888);
-                {
-                    QMutexLocker locker(&m_latestMutex);
-                    m_latestImage = toStore;
-                    qDebug() << "成功处理原始图像，话题: " << topic << " 编码: " << encoding << " 尺寸: " << toStore.width() << "x" << toStore.height();
-                }
-            } else {
-                qDebug() << "CameraImageMonitor: 创建图像失败，编码: " << encoding;
+            }
+            {
+                TraceRecorder::Zone zone("camera.storeLatest");
+                QMutexLocker locker(&m_latestMutex);
+                m_latestImage = toStore;
+                m_latestStamps = stamps;
+                qDebug() << "成功处理原始图像，话题: " << topic << " 编码: " << encoding << " 尺寸: " << toStore.width() << "x" << toStore.height();
             }
         } else {
-            qDebug() << "CameraImageMonitor: 未知的消息类型: " << act_topic_type << " 话题: " << topic;
+            qDebug() << "CameraImageMonitor: 创建图像失败，编码: " << encoding;
         }
     }
 }
@@ -394,13 +381,18 @@ void CameraImageMonitor::onMessageReceived(const QString &message) {
 void CameraImageMonitor::requestFrame()
 {
     QImage snapshot;
+    MessageStamps stamps;
     {
+        TraceRecorder::Zone zone("camera.takeLatest");
         QMutexLocker locker(&m_latestMutex);
         if (m_latestImage.isNull()) return;
         snapshot = m_latestImage;
+        stamps = m_latestStamps;
         // clear to avoid re-sending same frame repeatedly
         m_latestImage = QImage();
     }
     // emit from whichever thread called requestFrame; UI will receive via queued connection
     emit imageReceived(snapshot);
+    // requestFrame 由界面的拉取定时器调用，此时即为交给界面显示的时间
+    stamps.markDisplayed(act_topic_name);
 }
@@ -1,14 +1,21 @@
 #include "ros_process/imu.h"
 #include "socket_process/websocketworker.h"
 #include "util/load_param.hpp"
+#include "util/topicmetrics.h"
+#include "socket_process/typeddecoder.h"
 
 ImuMonitor::ImuMonitor(WebSocketWorker *worker, QObject *parent)
     : QObject(parent), m_worker(worker)
 {
     imu_topic_name = loadTopicFromConfig("imu_topic");
+    m_mailbox.setTopic(imu_topic_name);
 }
 
-ImuMonitor::~ImuMonitor() {}
+// 处理槽在解码线程池中执行，析构前从路由器注销并等待正在执行的解码结束
+ImuMonitor::~ImuMonitor()
+{
+    if (m_worker) m_worker->router()->removeReceiver(this);
+}
 
 // 订阅IMU话题
 void ImuMonitor::start(){
@@ -25,62 +32,20 @@ void ImuMonitor::start(){
     }
     
     qDebug() << "ImuMonitor::start() - 订阅话题: " << imu_topic_name;
+    m_worker->router()->addHandler(imu_topic_name, this);
     
     // send subscribe request for IMU
-    QJsonObject subscribeMsg;
-    subscribeMsg["op"] = "subscribe";
-    subscribeMsg["topic"] = imu_topic_name;
-    subscribeMsg["type"] = "sensor_msgs/Imu";
-    QJsonDocument doc(subscribeMsg);
-    QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
-    QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
+    m_worker->subscribeTopic(this, imu_topic_name, QStringLiteral("sensor_msgs/Imu"));
 }
 
-void ImuMonitor::onMessageReceived(const QString &message){
-    // 解析JSON消息
-    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-    if(!doc.isObject()) return;
-    QJsonObject obj = doc.object();
-
-    // 检查操作类型
-    if (obj["op"].toString() != "publish") return;
-    
-    // 检查话题
-    QString topic = obj["topic"].toString();
-    if (topic.isEmpty()) return; // 跳过空话题
-    
+// 路由器已完成信封解析，这里只处理IMU话题的 msg
+// 按 sensor_msgs/Imu 的字段表解码到结构体，JSON 文本帧直接在帧字节上读取，不构建 QJsonObject
+void ImuMonitor::onRosMessage(const RosMessage &message){
     // 确保是我们关心的IMU话题
-    if (topic != imu_topic_name) return;
-    
-    // 检查消息对象
-    if (!obj.contains("msg") || !obj["msg"].isObject()) return;
-    QJsonObject msgObj = obj["msg"].toObject();
-    
-    // 处理方向信息
-    if (msgObj.contains("orientation") && msgObj["orientation"].isObject()) {
-        QJsonObject ori = msgObj["orientation"].toObject();
-        double w = ori.value("w").toDouble();
-        double x = ori.value("x").toDouble();
-        double y = ori.value("y").toDouble();
-        double z = ori.value("z").toDouble();
-        emit orientationUpdated(w, x, y, z);
-    }
+    if (message.topic != imu_topic_name) return;
+    TopicMetrics::ScopedTimer decodeTimer(message.metrics, TopicMetrics::Decode);
 
-    // 处理角速度信息
-    if (msgObj.contains("angular_velocity") && msgObj["angular_velocity"].isObject()) {
-        QJsonObject ang = msgObj["angular_velocity"].toObject();
-        double ax = ang.value("x").toDouble();
-        double ay = ang.value("y").toDouble();
-        double az = ang.value("z").toDouble();
-        emit angularVelocityUpdated(ax, ay, az);
-    }
-
-    // 处理线性加速度信息
-    if (msgObj.contains("linear_acceleration") && msgObj["linear_acceleration"].isObject()) {
-        QJsonObject lin = msgObj["linear_acceleration"].toObject();
-        double lx = lin.value("x").toDouble();
-        double ly = lin.value("y").toDouble();
-        double lz = lin.value("z").toDouble();
-        emit linearAccelerationUpdated(lx, ly, lz);
-    }
+    ImuSample sample;
+    if (!TypedDecoder::decode(message, &sample.imu, &sample.seen)) return;
+    m_mailbox.post(sample, m_worker->clockSync()->stampMessage(message.metrics, sample.imu.header, message.receivedUs));
 }
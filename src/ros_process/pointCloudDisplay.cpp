@@ -1,4 +1,5 @@
 #include "ros_process/pointCloudDisplay.h"
+#include "util/tracerecorder.h"
 
 
 PointCloudDisplay::PointCloudDisplay(QWidget *parent)
@@ -56,6 +57,7 @@ void PointCloudDisplay::resizeGL(int w, int h)
 
 void PointCloudDisplay::paintGL()
 {
+    TraceRecorder::Zone zone("gl.paint");
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     QList<QVector3D> pts;
@@ -295,6 +297,7 @@ void PointCloudDisplay::clearCameraMatrix()
 void PointCloudDisplay::drawPointCloud(const QList<QVector3D> &pts)
 {
     if (pts.isEmpty()) return;
+    TraceRecorder::Zone zone("gl.uploadPoints", pts.size());
     glBegin(GL_POINTS);
     glColor3f(1.0f, 0.0f, 0.0f); // red points
     for (const QVector3D &p : pts) {
@@ -1,15 +1,25 @@
 #include "ros_process/slamMapPoint.h"
 #include "socket_process/websocketworker.h"
 #include "util/load_param.hpp"
+#include "util/topicmetrics.h"
+#include "socket_process/typeddecoder.h"
 
 
 SlamMapMonitor::SlamMapMonitor(WebSocketWorker *worker, QObject *parent)
     : QObject(parent), m_worker(worker)
 {
     loadTopicFromParams();
+    m_pointCloudMailbox.setTopic(slamPoint_topic_name);
+    m_keyFrameMailbox.setTopic(slamKeyFrame_topic_name);
+    m_cameraMatrixMailbox.setTopic(cameraOpenGLMatrix_topic_name);
+    m_cameraPoseMailbox.setTopic(cameraPose_topic_name);
 }
 
-SlamMapMonitor::~SlamMapMonitor() {}
+// 处理槽在解码线程池中执行，析构前从路由器注销并等待正在执行的解码结束
+SlamMapMonitor::~SlamMapMonitor()
+{
+    if (m_worker) m_worker->router()->removeReceiver(this);
+}
 
 void SlamMapMonitor::loadTopicFromParams(){
     // 检查配置文件是否存在
@@ -131,18 +141,19 @@ void SlamMapMonitor::start()
     qDebug() << "  关键帧话题: " << slamKeyFrame_topic_name << ", 类型: " << slamKeyFrame_topic_type;
     qDebug() << "  相机矩阵话题: " << cameraOpenGLMatrix_topic_name << ", 类型: " << cameraOpenGLMatrix_topic_type;
     qDebug() << "  相机位置话题: " << cameraPose_topic_name << ", 类型: " << cameraPose_topic_type;
+
+    // 在路由器上注册关心的话题
+    TopicRouter *router = m_worker->router();
+    router->addHandler(slamPoint_topic_name, this);
+    router->addHandler(slamKeyFrame_topic_name, this);
+    router->addHandler(cameraOpenGLMatrix_topic_name, this);
+    router->addHandler(cameraPose_topic_name, this);
     
     // 订阅地图点云PointCloud2数据
     if(!slamPoint_topic_name.isEmpty() && !slamPoint_topic_type.isEmpty())
     {
-        QJsonObject subscribeMsg;
-        subscribeMsg["op"] = "subscribe";
-        subscribeMsg["topic"] = slamPoint_topic_name;
-        subscribeMsg["type"] = slamPoint_topic_type;
-        QJsonDocument doc(subscribeMsg);
-        QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
         qDebug() << "订阅点云话题: " << slamPoint_topic_name << ", 类型: " << slamPoint_topic_type;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
+        m_worker->subscribeTopic(this, slamPoint_topic_name, slamPoint_topic_type);
     } else {
         qDebug() << "警告: 点云话题或类型为空，跳过订阅";
     }
@@ -150,14 +161,8 @@ void SlamMapMonitor::start()
     // 订阅keyframe topic
     if (!slamKeyFrame_topic_name.isEmpty() && !slamKeyFrame_topic_type.isEmpty())
     {
-        QJsonObject sub2;
-        sub2["op"] = "subscribe";
-        sub2["topic"] = slamKeyFrame_topic_name;
-        sub2["type"] = slamKeyFrame_topic_type;
-        QJsonDocument d2(sub2);
-        QString p2 = QString::fromUtf8(d2.toJson(QJsonDocument::Compact));
         qDebug() << "订阅关键帧话题: " << slamKeyFrame_topic_name << ", 类型: " << slamKeyFrame_topic_type;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, p2));
+        m_worker->subscribeTopic(this, slamKeyFrame_topic_name, slamKeyFrame_topic_type);
     } else {
         qDebug() << "警告: 关键帧话题或类型为空，跳过订阅";
     }
@@ -165,14 +170,8 @@ void SlamMapMonitor::start()
     // 订阅相机OpenGL矩阵topic
     if(!cameraOpenGLMatrix_topic_name.isEmpty() && !cameraOpenGLMatrix_topic_type.isEmpty())
     {
-        QJsonObject sub3;
-        sub3["op"] = "subscribe";
-        sub3["topic"] = cameraOpenGLMatrix_topic_name;
-        sub3["type"] = cameraOpenGLMatrix_topic_type;
-        QJsonDocument d3(sub3);
-        QString p3 = QString::fromUtf8(d3.toJson(QJsonDocument::Compact));
         qDebug() << "订阅相机矩阵话题: " << cameraOpenGLMatrix_topic_name << ", 类型: " << cameraOpenGLMatrix_topic_type;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, p3));
+        m_worker->subscribeTopic(this, cameraOpenGLMatrix_topic_name, cameraOpenGLMatrix_topic_type);
     } else {
         qDebug() << "警告: 相机矩阵话题或类型为空，跳过订阅";
     }
@@ -180,14 +179,8 @@ void SlamMapMonitor::start()
     // 订阅相机位置
     if(!cameraPose_topic_name.isEmpty() && !cameraPose_topic_type.isEmpty())
     {
-        QJsonObject sub4;
-        sub4["op"] = "subscribe";
-        sub4["topic"] = cameraPose_topic_name;
-        sub4["type"] = cameraPose_topic_type;  // 添加类型
-        QJsonDocument d4(sub4);
-        QString p4 = QString::fromUtf8(d4.toJson(QJsonDocument::Compact));
         qDebug() << "订阅相机位置话题: " << cameraPose_topic_name << ", 类型: " << cameraPose_topic_type;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, p4));
+        m_worker->subscribeTopic(this, cameraPose_topic_name, cameraPose_topic_type);
     } else {
         qDebug() << "警告: 相机位置话题或类型为空，跳过订阅";
     }
@@ -200,89 +193,42 @@ void SlamMapMonitor::stop()
         return;
     
     qDebug() << "SlamMapMonitor::stop() - 取消SLAM数据订阅";
+    m_worker->router()->removeReceiver(this);
     
     // 取消点云数据订阅
     if (!slamPoint_topic_name.isEmpty())
     {
-        QJsonObject unsub;
-        unsub["op"] = "unsubscribe";
-        unsub["topic"] = slamPoint_topic_name;
-        QJsonDocument doc(unsub);
-        QString payload = QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
         qDebug() << "取消订阅点云话题: " << slamPoint_topic_name;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, payload));
+        m_worker->unsubscribeTopic(this, slamPoint_topic_name);
     }
     
     // 取消keyframe订阅
     if (!slamKeyFrame_topic_name.isEmpty())
     {
-        QJsonObject unsub2;
-        unsub2["op"] = "unsubscribe";
-        unsub2["topic"] = slamKeyFrame_topic_name;
-        QJsonDocument d2(unsub2);
-        QString p2 = QString::fromUtf8(d2.toJson(QJsonDocument::Compact));
         qDebug() << "取消订阅关键帧话题: " << slamKeyFrame_topic_name;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, p2));
+        m_worker->unsubscribeTopic(this, slamKeyFrame_topic_name);
     }
 
     // 取消相机OpenGL矩阵订阅
     if (!cameraOpenGLMatrix_topic_name.isEmpty())
     {
-        QJsonObject unsub3;
-        unsub3["op"] = "unsubscribe";
-        unsub3["topic"] = cameraOpenGLMatrix_topic_name;
-        QJsonDocument d3(unsub3);
-        QString p3 = QString::fromUtf8(d3.toJson(QJsonDocument::Compact));
         qDebug() << "取消订阅相机矩阵话题: " << cameraOpenGLMatrix_topic_name;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, p3));
+        m_worker->unsubscribeTopic(this, cameraOpenGLMatrix_topic_name);
     }
 
     // 取消相机位置订阅
     if (!cameraPose_topic_name.isEmpty())
     {
-        QJsonObject unsub4;
-        unsub4["op"] = "unsubscribe";
-        unsub4["topic"] = cameraPose_topic_name;
-        QJsonDocument d4(unsub4);
-        QString p4 = QString::fromUtf8(d4.toJson(QJsonDocument::Compact));
         qDebug() << "取消订阅相机位置话题: " << cameraPose_topic_name;
-        QMetaObject::invokeMethod(m_worker, "sendText", Qt::QueuedConnection, Q_ARG(QString, p4));
+        m_worker->unsubscribeTopic(this, cameraPose_topic_name);
     }
 }
 
-// 接收到SLAM点云消息处理
-void SlamMapMonitor::onMessageReceived(const QString &message)
+// 接收到SLAM点云消息处理（路由器已解析信封，只会收到注册话题的 msg）
+void SlamMapMonitor::onRosMessage(const RosMessage &message)
 {
-    // 解析JSON消息
-    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-    if (!doc.isObject())
-        return;
-    QJsonObject obj = doc.object();
-
-    // 只处理发布类型的消息
-    if (obj["op"].toString() != "publish")
-        return;
-
-    // 获取话题名称和消息内容
-    QString topic = obj["topic"].toString();
-    if(topic.isEmpty())
-        return;
-        
-    // 只有当收到的消息是我们关注的话题时才处理
-    if(topic != slamPoint_topic_name && 
-       topic != slamKeyFrame_topic_name && 
-       topic != cameraOpenGLMatrix_topic_name && 
-       topic != cameraPose_topic_name) {
-        return;
-    }
-    
-    // 检查消息对象是否存在
-    if(!obj.contains("msg") || !obj["msg"].isObject()) {
-        qDebug() << "SlamMapMonitor::onMessageReceived - 消息格式错误，无法找到msg字段，话题:" << topic;
-        return;
-    }
-    
-    QJsonObject msgObj = obj["msg"].toObject();
+    const QString &topic = message.topic;
+    TopicMetrics::ScopedTimer decodeTimer(message.metrics, TopicMetrics::Decode);
     
     // 根据话题类型处理不同的消息
     if(topic == slamPoint_topic_name) { 
@@ -298,28 +244,15 @@ void SlamMapMonitor::onMessageReceived(const QString &message)
             pcTimer.restart();
         }
         
-        // 检查消息结构是否完整
-        if (!msgObj.contains("fields") || !msgObj["fields"].isArray()) {
-            qDebug() << "点云消息格式错误，缺少fields数组字段，话题:" << topic;
-            return;
-        }
-        
-        if (!msgObj.contains("data")) {
-            qDebug() << "点云消息格式错误，缺少data字段，话题:" << topic;
-            return;
-        }
-        
-        // 解析点云数据
-        QList<QVector3D> points;
-        points = parsePointCloud(msgObj);
+        // 解析点云数据（按字段表解码，不构建 QJsonObject）
+        QList<QVector3D> points = parsePointCloud(message);
         
         // 打印调试信息
         qDebug() << "解析到点云数据点数:" << points.size();
         
         if (!points.isEmpty()) {
-            // 将解析成功的数据发送信号
-            qDebug() << "发送点云数据到显示组件，点数:" << points.size();
-            emit pointCloudReceived(points);
+            // 放入信箱，显示组件按自己的刷新节奏取最新的一帧
+            m_pointCloudMailbox.post(points, m_worker->clockSync()->stampMessage(message.metrics, m_cloud.header, message.receivedUs));
         } else {
             // 点云解析失败，可能数据格式有问题
             static QElapsedTimer failTimer;
@@ -330,8 +263,8 @@ void SlamMapMonitor::onMessageReceived(const QString &message)
                 qDebug() << "点云解析失败，可能数据格式有问题，话题:" << topic;
                 
                 // 打印详细的消息结构，帮助调试
-                QJsonDocument msgDoc(msgObj);
-                QString msgStr = QString::fromUtf8(msgDoc.toJson(QJsonDocument::Compact));
+                QString msgStr = message.hasJson() ? QString::fromUtf8(message.msgJson().data(), message.msgJson().size())
+                                                   : QString::fromUtf8(QJsonDocument(message.msg).toJson(QJsonDocument::Compact));
                 if (msgStr.length() > 500) {
                     msgStr = msgStr.left(500) + "..."; // 限制长度，避免日志过长
                 }
@@ -354,6 +287,7 @@ void SlamMapMonitor::onMessageReceived(const QString &message)
         }
         
         // 检查关键帧消息格式是否正确
+        const QJsonObject msgObj = message.msgObject();
         if (msgObj.contains("markers") && msgObj["markers"].isArray()) {
             parseKeyFrame(msgObj);
         } else {
@@ -380,7 +314,7 @@ void SlamMapMonitor::onMessageReceived(const QString &message)
             matrixTimer.restart();
         }
         
-        parseOpenGLMatrix(msgObj);
+        parseOpenGLMatrix(message);
     } else if(topic == cameraPose_topic_name) {
         // 收到相机位置消息
         static QElapsedTimer poseTimer;
@@ -393,87 +327,62 @@ void SlamMapMonitor::onMessageReceived(const QString &message)
             poseTimer.restart();
         }
         
-        parseCameraPose(msgObj);
+        parseCameraPose(message);
     }
 }
 
-// 解析PointCloud2数据
-QList<QVector3D> SlamMapMonitor::parsePointCloud(const QJsonObject &msgObj)
+// 按 x/y/z 偏移从 PointCloud2 的原始字节中取出 float32 坐标
+static QList<QVector3D> pointsFromRaw(const char *raw, qsizetype size, int point_step, int x_offset, int y_offset, int z_offset)
 {
-    // 解析PointCloud2数据结构
     QList<QVector3D> points;
-    // fields: array of {name, offset, datatype, count}
-    QJsonArray fields = msgObj["fields"].toArray(); // fields数组
-    int x_offset = -1, y_offset = -1, z_offset = -1;
-    int point_step = msgObj["point_step"].toInt(0); // 每个点占用的字节数
-    // locate x,y,z offsets
-    for (int i = 0; i < static_cast<int>(fields.size()); ++i)
-    {
-        QJsonObject f = fields[i].toObject();
-        QString name = f["name"].toString();
-        int offset = f["offset"].toInt();
-        // int datatype = f["datatype"].toInt(); // 不需要使用datatype
-        if (name == "x")
-            x_offset = offset;
-        if (name == "y")
-            y_offset = offset;
-        if (name == "z")
-            z_offset = offset;
-    }
-
-    // data might be an array of numbers or a base64 string depending on rosbridge config
-    if (msgObj.contains("data") && msgObj["data"].isArray())
+    if (point_step <= 0)
+        point_step = 12; // 3 floats
+    const int point_count = static_cast<int>(size / point_step);
+    points.reserve(point_count);
+    for (int p = 0; p < point_count; ++p)
     {
-        QJsonArray dataArr = msgObj["data"].toArray();
-        int total = static_cast<int>(dataArr.size());
-        if (point_step <= 0 && x_offset < 0)
-        {
-            // fallback: assume packed triples
-            for (int i = 0; i + 2 < total; i += 3)
-            {
-                float vx = float(dataArr[i].toDouble());
-                float vy = float(dataArr[i + 1].toDouble());
-                float vz = float(dataArr[i + 2].toDouble());
-                points.append(QVector3D(vx, vy, vz));
-            }
-        }
-        else
-        {
-            int point_count = total / point_step;
-            for (int p = 0; p < point_count; ++p)
-            {
-                int base = p * point_step;
-                float vx = x_offset >= 0 ? float(dataArr[base + x_offset].toDouble()) : 0.0f;
-                float vy = y_offset >= 0 ? float(dataArr[base + y_offset].toDouble()) : 0.0f;
-                float vz = z_offset >= 0 ? float(dataArr[base + z_offset].toDouble()) : 0.0f;
-                points.append(QVector3D(vx, vy, vz));
-            }
-        }
-    }
-    else if (msgObj.contains("data") && msgObj["data"].isString())
-    {
-        // data is base64 string
-        QString b64 = msgObj["data"].toString();
-        QByteArray raw = QByteArray::fromBase64(b64.toUtf8());
-        if (point_step <= 0)
-            point_step = 12; // 3 floats
-        int point_count = static_cast<int>(raw.size() / point_step);
-        for (int p = 0; p < point_count; ++p)
-        {
-            int base = p * point_step;
-            float vx = 0, vy = 0, vz = 0;
-            if (x_offset >= 0)
-                memcpy(&vx, raw.constData() + base + x_offset, sizeof(float));
-            if (y_offset >= 0)
-                memcpy(&vy, raw.constData() + base + y_offset, sizeof(float));
-            if (z_offset >= 0)
-                memcpy(&vz, raw.constData() + base + z_offset, sizeof(float));
-            points.append(QVector3D(vx, vy, vz));
-        }
+        const char *base = raw + qsizetype(p) * point_step;
+        float vx = 0, vy = 0, vz = 0;
+        if (x_offset >= 0 && x_offset + 4 <= point_step)
+            memcpy(&vx, base + x_offset, sizeof(float));
+        if (y_offset >= 0 && y_offset + 4 <= point_step)
+            memcpy(&vy, base + y_offset, sizeof(float));
+        if (z_offset >= 0 && z_offset + 4 <= point_step)
+            memcpy(&vz, base + z_offset, sizeof(float));
+        points.append(QVector3D(vx, vy, vz));
     }
     return points;
 }
 
+// 按 sensor_msgs/PointCloud2 字段表解码（JSON 文本帧在帧字节上读取，data 解码到 m_cloud 复用的缓冲区），
+// 再按 fields 中 x/y/z 的偏移取出坐标；cbor 帧的 data 已是原始字节，在 message.data 中
+QList<QVector3D> SlamMapMonitor::parsePointCloud(const RosMessage &message)
+{
+    quint32 seen = 0;
+    if (!TypedDecoder::decode(message, &m_cloud, &seen)) {
+        qDebug() << "点云消息格式错误";
+        return {};
+    }
+    if (!(seen & TypedDecoder::fieldBit<rosmsg::PointCloud2>("fields"))) {
+        qDebug() << "点云消息格式错误，缺少fields数组字段";
+        return {};
+    }
+    if (!message.data.isEmpty()) {
+        m_cloud.data = message.data;
+    } else if (!(seen & TypedDecoder::fieldBit<rosmsg::PointCloud2>("data"))) {
+        qDebug() << "点云消息格式错误，缺少data字段";
+        return {};
+    }
+
+    int x_offset = -1, y_offset = -1, z_offset = -1;
+    for (const rosmsg::PointField &f : m_cloud.fields) {
+        if (f.name == QLatin1String("x")) x_offset = int(f.offset);
+        else if (f.name == QLatin1String("y")) y_offset = int(f.offset);
+        else if (f.name == QLatin1String("z")) z_offset = int(f.offset);
+    }
+    return pointsFromRaw(m_cloud.data.constData(), m_cloud.data.size(), int(m_cloud.point_step), x_offset, y_offset, z_offset);
+}
+
 // 解析 MarkerArray 消息并提取 POINTS 与 LINE_LIST/LINE_STRIP 标记
 void SlamMapMonitor::parseKeyFrame(const QJsonObject &msgObj)
 {
@@ -546,37 +455,34 @@ void SlamMapMonitor::parseKeyFrame(const QJsonObject &msgObj)
 
     if (!points.isEmpty() || !lines.isEmpty()) {
         // qDebug() << "SlamMapMonitor::parseKeyFrame parsed" << points.size() << "points," << lines.size() << "line endpoints";
-        emit keyFrameMarkers(points, lines);
+        m_keyFrameMailbox.post(KeyFrameMarkers{points, lines});
     }
 }
 
-// 解析相机OpenGL矩阵消息
-void SlamMapMonitor::parseOpenGLMatrix(const QJsonObject &msgObj){
-    // Expecting std_msgs/Float64MultiArray-like JSON: { layout:..., data: [ ... ] }
-    if (!msgObj.contains("data")) return;
-    QList<double> mat;
-    if (msgObj["data"].isArray()){
-        QJsonArray arr = msgObj["data"].toArray();
-        mat.reserve(arr.size());
-        for (int i=0;i<static_cast<int>(arr.size());++i){
-            mat.append(arr[i].toDouble());
-        }
-    } else if (msgObj["data"].isString()){
-        // if data is encoded as base64 of doubles (unlikely), attempt to decode
-        QByteArray b = QByteArray::fromBase64(msgObj["data"].toString().toUtf8());
-        int n = static_cast<int>(b.size()/sizeof(double));
-        mat.reserve(n);
-        const double *ptr = reinterpret_cast<const double*>(b.constData());
-        for (int i=0;i<n;++i) mat.append(ptr[i]);
-    }
+// 解析相机OpenGL矩阵消息（std_msgs/Float64MultiArray，data 为数组或 base64 编码的 double）
+void SlamMapMonitor::parseOpenGLMatrix(const RosMessage &message){
+    rosmsg::Float64MultiArray matrix;
+    if (!TypedDecoder::decode(message, &matrix)) return;
 
-    if (!mat.isEmpty()){
-        emit cameraMatrixReceived(mat);
+    if (!matrix.data.isEmpty()){
+        m_cameraMatrixMailbox.post(matrix.data);
     }
 }
 
 // 解析相机位置消息
-void SlamMapMonitor::parseCameraPose(const QJsonObject &msgObj){
+void SlamMapMonitor::parseCameraPose(const RosMessage &message){
+    // geometry_msgs/PoseStamped 按字段表解码；其他类型（PoseWithCovarianceStamped、PointStamped 等）按键名逐层查找
+    if (cameraPose_topic_type == QLatin1String("geometry_msgs/PoseStamped")) {
+        rosmsg::PoseStamped stamped;
+        quint32 seen = 0;
+        if (!TypedDecoder::decode(message, &stamped, &seen)) return;
+        if (!(seen & TypedDecoder::fieldBit<rosmsg::PoseStamped>("pose"))) return;
+        const rosmsg::Vector3 &p = stamped.pose.position;
+        m_cameraPoseMailbox.post(CameraPose{QVector3D(float(p.x), float(p.y), float(p.z)), QVector3D(0, 0, 1)});
+        return;
+    }
+
+    const QJsonObject msgObj = message.msgObject();
     QJsonObject poseObj;
     if (msgObj.contains("pose") && msgObj["pose"].isObject()) {
         // could be PoseStamped: msgObj["pose"]["pose"] or Pose geometry directly
@@ -638,5 +544,5 @@ void SlamMapMonitor::parseCameraPose(const QJsonObject &msgObj){
     // }
 
     QVector3D posf{static_cast<float>(px), static_cast<float>(py), static_cast<float>(pz)};
-    emit cameraPoseReceived(posf, dir);
+    m_cameraPoseMailbox.post(CameraPose{posf, dir});
 }
\ No newline at end of file
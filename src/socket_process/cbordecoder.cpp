@@ -0,0 +1,214 @@
+#include "socket_process/cbordecoder.h"
+#include "util/tracerecorder.h"
+
+#include <QtEndian>
+#include <cstring>
+
+// RFC 8746 类型化数组标签（rosbridge 在小端机器上使用 LE 标签）
+enum TypedArrayTag {
+    TagUint8 = 64, TagUint16LE = 69, TagUint32LE = 70, TagUint64LE = 71,
+    TagInt8 = 72, TagInt16LE = 77, TagInt32LE = 78, TagInt64LE = 79,
+    TagFloat32LE = 85, TagFloat64LE = 86
+};
+
+template <typename T>
+static QJsonArray typedArrayToJson(const QByteArray &bytes)
+{
+    QJsonArray arr;
+    const int n = static_cast<int>(bytes.size() / sizeof(T));
+    const char *p = bytes.constData();
+    for (int i = 0; i < n; ++i) {
+        T v;
+        memcpy(&v, p + i * sizeof(T), sizeof(T));
+        arr.append(static_cast<double>(qFromLittleEndian(v)));
+    }
+    return arr;
+}
+
+// CBOR -> JSON，类型化数组展开为数值数组，使现有的 QJsonObject 解析逻辑保持不变
+QJsonValue CborDecoder::toJson(const QCborValue &value)
+{
+    if (value.isMap()) {
+        QJsonObject obj;
+        const QCborMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            obj.insert(it.key().toString(), toJson(it.value()));
+        }
+        return obj;
+    }
+    if (value.isArray()) {
+        QJsonArray arr;
+        const QCborArray a = value.toArray();
+        for (const QCborValue &v : a) arr.append(toJson(v));
+        return arr;
+    }
+    if (value.isTag()) {
+        const QCborValue inner = value.taggedValue();
+        if (inner.isByteArray()) {
+            const QByteArray b = inner.toByteArray();
+            switch (static_cast<quint64>(value.tag())) {
+            case TagUint8:     return typedArrayToJson<quint8>(b);
+            case TagUint16LE:  return typedArrayToJson<quint16>(b);
+            case TagUint32LE:  return typedArrayToJson<quint32>(b);
+            case TagUint64LE:  return typedArrayToJson<quint64>(b);
+            case TagInt8:      return typedArrayToJson<qint8>(b);
+            case TagInt16LE:   return typedArrayToJson<qint16>(b);
+            case TagInt32LE:   return typedArrayToJson<qint32>(b);
+            case TagInt64LE:   return typedArrayToJson<qint64>(b);
+            case TagFloat32LE: return typedArrayToJson<float>(b);
+            case TagFloat64LE: return typedArrayToJson<double>(b);
+            default: break;
+            }
+        }
+        return toJson(inner);
+    }
+    if (value.isByteArray()) {
+        // 嵌套的字节串与 rosbridge JSON 模式保持一致，使用 base64 字符串
+        return QString::fromLatin1(value.toByteArray().toBase64());
+    }
+    return value.toJsonValue();
+}
+
+bool CborDecoder::decode(const QByteArray &frame, const QHash<QString, QString> &topicTypes, RosMessage *out)
+{
+    TraceRecorder::Zone zone("cbor.decode", frame.size());
+    QCborParserError err;
+    QCborValue root = QCborValue::fromCbor(frame, &err);
+    if (err.error != QCborError::NoError || !root.isMap()) {
+        qDebug() << "CborDecoder: 无效的CBOR数据:" << err.errorString();
+        return false;
+    }
+    const QCborMap map = root.toMap();
+    if (map.value(QStringLiteral("op")).toString() != "publish") return false;
+
+    out->topic = map.value(QStringLiteral("topic")).toString();
+    if (out->topic.isEmpty()) return false;
+
+    const QCborValue msgVal = map.value(QStringLiteral("msg"));
+    if (!msgVal.isMap()) return false;
+    const QCborMap msg = msgVal.toMap();
+
+    // cbor-raw: {secs, nsecs, bytes}
+    if (msg.contains(QStringLiteral("bytes")) && msg.value(QStringLiteral("bytes")).isByteArray()
+        && msg.contains(QStringLiteral("secs"))) {
+        const QString type = topicTypes.value(out->topic);
+        return decodeRaw(msg.value(QStringLiteral("bytes")).toByteArray(), type, out);
+    }
+
+    // cbor: msg.data 为字节串时直接交给监视器
+    QJsonObject obj;
+    for (auto it = msg.constBegin(); it != msg.constEnd(); ++it) {
+        const QString key = it.key().toString();
+        if (key == QLatin1String("data") && it.value().isByteArray()) {
+            out->data = it.value().toByteArray();
+            continue;
+        }
+        obj.insert(key, toJson(it.value()));
+    }
+    out->msg = obj;
+    return true;
+}
+
+// ROS1 序列化读取（小端，string/数组前缀为 uint32 长度）
+namespace {
+class RawReader
+{
+public:
+    explicit RawReader(const QByteArray &b) : m_data(b), m_pos(0), m_ok(true) {}
+
+    bool ok() const { return m_ok; }
+
+    quint32 u32() {
+        if (!need(4)) return 0;
+        quint32 v = qFromLittleEndian<quint32>(m_data.constData() + m_pos);
+        m_pos += 4;
+        return v;
+    }
+    quint8 u8() {
+        if (!need(1)) return 0;
+        return static_cast<quint8>(m_data.at(m_pos++));
+    }
+    QString string() {
+        quint32 len = u32();
+        if (!need(len)) return QString();
+        QString s = QString::fromUtf8(m_data.constData() + m_pos, len);
+        m_pos += len;
+        return s;
+    }
+    QByteArray bytes() {
+        quint32 len = u32();
+        if (!need(len)) return QByteArray();
+        QByteArray b = m_data.mid(m_pos, len);
+        m_pos += len;
+        return b;
+    }
+    QJsonObject header() {
+        QJsonObject h;
+        h["seq"] = static_cast<double>(u32());
+        QJsonObject stamp;
+        stamp["secs"] = static_cast<double>(u32());
+        stamp["nsecs"] = static_cast<double>(u32());
+        h["stamp"] = stamp;
+        h["frame_id"] = string();
+        return h;
+    }
+
+private:
+    bool need(qsizetype n) {
+        if (!m_ok || m_pos + n > m_data.size()) { m_ok = false; return false; }
+        return true;
+    }
+    const QByteArray &m_data;
+    qsizetype m_pos;
+    bool m_ok;
+};
+} // namespace
+
+// cbor-raw 只支持需要大块数据的消息类型：CompressedImage / Image / PointCloud2
+bool CborDecoder::decodeRaw(const QByteArray &bytes, const QString &type, RosMessage *out)
+{
+    RawReader r(bytes);
+    QJsonObject obj;
+    if (type == "sensor_msgs/CompressedImage") {
+        obj["header"] = r.header();
+        obj["format"] = r.string();
+        out->data = r.bytes();
+    } else if (type == "sensor_msgs/Image") {
+        obj["header"] = r.header();
+        obj["height"] = static_cast<double>(r.u32());
+        obj["width"] = static_cast<double>(r.u32());
+        obj["encoding"] = r.string();
+        obj["is_bigendian"] = r.u8();
+        obj["step"] = static_cast<double>(r.u32());
+        out->data = r.bytes();
+    } else if (type == "sensor_msgs/PointCloud2") {
+        obj["header"] = r.header();
+        obj["height"] = static_cast<double>(r.u32());
+        obj["width"] = static_cast<double>(r.u32());
+        QJsonArray fields;
+        quint32 n = r.u32();
+        for (quint32 i = 0; i < n && r.ok(); ++i) {
+            QJsonObject f;
+            f["name"] = r.string();
+            f["offset"] = static_cast<double>(r.u32());
+            f["datatype"] = r.u8();
+            f["count"] = static_cast<double>(r.u32());
+            fields.append(f);
+        }
+        obj["fields"] = fields;
+        obj["is_bigendian"] = r.u8() != 0;
+        obj["point_step"] = static_cast<double>(r.u32());
+        obj["row_step"] = static_cast<double>(r.u32());
+        out->data = r.bytes();
+        obj["is_dense"] = r.u8() != 0;
+    } else {
+        qDebug() << "CborDecoder: cbor-raw 不支持的消息类型:" << type << "话题:" << out->topic;
+        return false;
+    }
+    if (!r.ok()) {
+        qDebug() << "CborDecoder: cbor-raw 数据长度不足，话题:" << out->topic;
+        return false;
+    }
+    out->msg = obj;
+    return true;
+}
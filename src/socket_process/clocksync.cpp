@@ -0,0 +1,160 @@
+#include "socket_process/clocksync.h"
+#include "socket_process/websocketworker.h"
+
+#include <QtMath>
+
+// 最小二乘估计漂移所需的样本跨度；跨度太短时漂移的误差比偏差本身还大
+static const qint64 MIN_DRIFT_SPAN_US = 10 * 1000 * 1000;
+// 估计出的漂移超过该值（500 ppm）视为样本异常，按无漂移处理
+static const double MAX_DRIFT = 500e-6;
+
+ClockSync::ClockSync(WebSocketWorker *worker)
+    : QObject(worker), m_worker(worker)
+{
+}
+
+void ClockSync::start()
+{
+    if (!m_timer) {
+        m_timer = new QTimer(this);
+        connect(m_timer, &QTimer::timeout, this, &ClockSync::poll);
+    }
+    m_samples.clear();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_estimate = Estimate();
+    }
+    m_burstLeft = BURST_SAMPLES;
+    m_timer->start(BURST_INTERVAL_MS);
+    poll();
+}
+
+void ClockSync::stop()
+{
+    if (m_timer) m_timer->stop();
+}
+
+// 同一时刻只有一个 get_time 在途，避免排队的请求拉长往返时间
+void ClockSync::poll()
+{
+    if (m_inFlight || !m_worker) return;
+    m_inFlight = true;
+    RosApi::getTime(m_worker).then(this, [this](const RosApi::Time &time) {
+        m_inFlight = false;
+        addSample(time);
+        if (m_burstLeft > 0 && --m_burstLeft == 0 && m_timer && m_timer->isActive()) {
+            m_timer->setInterval(SAMPLE_INTERVAL_MS);
+        }
+    });
+}
+
+void ClockSync::addSample(const RosApi::Time &time)
+{
+    if (!time.ok) {
+        if (!m_unavailableLogged) {
+            qDebug() << "ClockSync: /rosapi/get_time unavailable (" << time.error << "), latency will not be measured";
+            m_unavailableLogged = true;
+        }
+        return;
+    }
+    m_unavailableLogged = false;
+
+    Sample s;
+    s.rttUs = time.elapsedUs;
+    s.localUs = time.sentAtUs + (time.receivedAtUs - time.sentAtUs) / 2;
+    s.offsetUs = time.stamp.sec * 1000000 + time.stamp.nanosec / 1000 - s.localUs;
+    m_samples.append(s);
+    if (m_samples.size() > MAX_SAMPLES) m_samples.removeFirst();
+    updateEstimate();
+}
+
+// 只用往返时间接近最短值的样本：往返越长，请求或应答在某一方向上排队的可能越大，偏差越不准
+void ClockSync::updateEstimate()
+{
+    if (m_samples.isEmpty()) return;
+    qint64 minRtt = m_samples.first().rttUs;
+    for (const Sample &s : m_samples) minRtt = qMin(minRtt, s.rttUs);
+    const qint64 limit = qMax(minRtt * 2, minRtt + 2000);
+
+    QVector<Sample> good;
+    const Sample *best = nullptr;
+    for (const Sample &s : m_samples) {
+        if (s.rttUs > limit) continue;
+        good.append(s);
+        if (!best || s.rttUs < best->rttUs) best = &s;
+    }
+
+    Estimate e;
+    e.valid = true;
+    e.rttUs = minRtt;
+    e.samples = good.size();
+    e.referenceUs = m_samples.last().localUs;
+    e.offsetUs = best->offsetUs;
+    e.drift = 0;
+
+    const qint64 span = good.last().localUs - good.first().localUs;
+    if (good.size() >= 4 && span >= MIN_DRIFT_SPAN_US) {
+        // offset = a + b * (local - reference)
+        double meanX = 0, meanY = 0;
+        for (const Sample &s : good) {
+            meanX += double(s.localUs - e.referenceUs);
+            meanY += double(s.offsetUs);
+        }
+        meanX /= good.size();
+        meanY /= good.size();
+        double sxy = 0, sxx = 0;
+        for (const Sample &s : good) {
+            const double dx = double(s.localUs - e.referenceUs) - meanX;
+            sxy += dx * (double(s.offsetUs) - meanY);
+            sxx += dx * dx;
+        }
+        const double b = sxx > 0 ? sxy / sxx : 0;
+        if (qAbs(b) <= MAX_DRIFT) {
+            e.drift = b;
+            e.offsetUs = qint64(meanY - b * meanX);
+        }
+    }
+
+    bool first = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        first = !m_estimate.valid;
+        m_estimate = e;
+    }
+    if (first) {
+        qDebug() << "ClockSync: offset" << e.offsetUs / 1000.0 << "ms, rtt" << e.rttUs / 1000.0 << "ms";
+    }
+}
+
+ClockSync::Estimate ClockSync::estimate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_estimate;
+}
+
+qint64 ClockSync::toLocalUs(qint64 robotUs) const
+{
+    const Estimate e = estimate();
+    if (!e.valid) return 0;
+    const qint64 approxLocal = robotUs - e.offsetUs;
+    const qint64 offset = e.offsetUs + qint64(e.drift * double(approxLocal - e.referenceUs));
+    return robotUs - offset;
+}
+
+qint64 ClockSync::toLocalUs(const rosmsg::Time &stamp) const
+{
+    if (stamp.sec == 0 && stamp.nanosec == 0) return 0;
+    return toLocalUs(stamp.sec * 1000000 + stamp.nanosec / 1000);
+}
+
+MessageStamps ClockSync::stampMessage(TopicMetrics::Entry *metrics, const rosmsg::Header &header, qint64 receivedUs) const
+{
+    MessageStamps stamps;
+    stamps.receivedUs = receivedUs;
+    stamps.robotUs = toLocalUs(header.stamp);
+    stamps.metrics = metrics;
+    if (stamps.robotUs > 0 && receivedUs > 0) {
+        TopicMetrics::instance().recordTime(metrics, TopicMetrics::Transport, (receivedUs - stamps.robotUs) * 1000);
+    }
+    return stamps;
+}
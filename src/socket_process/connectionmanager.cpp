@@ -0,0 +1,120 @@
+#include "socket_process/connectionmanager.h"
+
+#include <QFileInfo>
+
+ConnectionManager::ConnectionManager(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ConnectionManager::~ConnectionManager()
+{
+    closeAll();
+}
+
+WebSocketWorker *ConnectionManager::open(const QString &url)
+{
+    if (url.isEmpty()) return nullptr;
+    auto it = m_connections.find(url);
+    if (it != m_connections.end()) {
+        return it->worker;
+    }
+
+    Connection c = createConnection(url);
+    // 跨线程异步调用 startConnect
+    QMetaObject::invokeMethod(c.worker, "startConnect", Qt::QueuedConnection, Q_ARG(QString, url));
+    return c.worker;
+}
+
+// 回放录制文件：同样是一个 worker 和线程，帧由 ReplaySource 注入而不是来自 socket
+ReplaySource *ConnectionManager::openReplay(const QString &path)
+{
+    const QString url = QStringLiteral("replay://") + QFileInfo(path).fileName();
+    auto it = m_connections.find(url);
+    if (it != m_connections.end()) {
+        return it->replay;
+    }
+
+    return createConnection(url, true).replay;
+}
+
+// 创建 worker 和线程，把该机器人的 WebSocket 操作放到独立子线程
+ConnectionManager::Connection ConnectionManager::createConnection(const QString &url, bool replay)
+{
+    Connection c;
+    c.worker = new WebSocketWorker();
+    // 回放源是 worker 的子对象，随 worker 一起移到子线程并一起销毁
+    if (replay) c.replay = new ReplaySource(c.worker);
+    c.thread = new QThread(this);
+    c.thread->setObjectName(QStringLiteral("ws:") + url);
+    c.worker->moveToThread(c.thread);
+    connect(c.thread, &QThread::finished, c.worker, &QObject::deleteLater);
+
+    // worker 信号带上 url 转发到主线程
+    connect(c.worker, &WebSocketWorker::connected, this, [this, url]() {
+        auto it = m_connections.find(url);
+        if (it != m_connections.end()) it->connected = true;
+        emit robotConnected(url);
+    });
+    connect(c.worker, &WebSocketWorker::disconnected, this, [this, url]() {
+        auto it = m_connections.find(url);
+        if (it != m_connections.end()) it->connected = false;
+        emit robotDisconnected(url);
+    });
+    connect(c.worker, &WebSocketWorker::reconnecting, this, [this, url](int attempt, int delayMs) {
+        emit robotReconnecting(url, attempt, delayMs);
+    });
+    connect(c.worker, &WebSocketWorker::errorOccurred, this, [this, url](const QString &error) {
+        emit robotError(url, error);
+    });
+
+    c.thread->start();
+    m_connections.insert(url, c);
+    qDebug() << "ConnectionManager: opening" << url << "robots:" << m_connections.size();
+    emit robotOpened(url, c.worker);
+    return c;
+}
+
+void ConnectionManager::close(const QString &url)
+{
+    auto it = m_connections.find(url);
+    if (it == m_connections.end()) return;
+    Connection c = it.value();
+    m_connections.erase(it);
+
+    qDebug() << "ConnectionManager: closing" << url;
+    emit robotClosing(url, c.worker);
+
+    // 等待 worker 发出退订和关闭帧后再结束线程；排队方式下事件循环可能先于 closeConnection 退出
+    QMetaObject::invokeMethod(c.worker, "closeConnection", Qt::BlockingQueuedConnection);
+    c.thread->quit();
+    c.thread->wait();
+    // worker 在线程 finished 时 deleteLater
+    delete c.thread;
+}
+
+void ConnectionManager::closeAll()
+{
+    const QStringList all = m_connections.keys();
+    for (const QString &url : all) {
+        close(url);
+    }
+}
+
+WebSocketWorker *ConnectionManager::worker(const QString &url) const
+{
+    auto it = m_connections.constFind(url);
+    return it == m_connections.constEnd() ? nullptr : it->worker;
+}
+
+ReplaySource *ConnectionManager::replay(const QString &url) const
+{
+    auto it = m_connections.constFind(url);
+    return it == m_connections.constEnd() ? nullptr : it->replay;
+}
+
+bool ConnectionManager::isConnected(const QString &url) const
+{
+    auto it = m_connections.constFind(url);
+    return it != m_connections.constEnd() && it->connected;
+}
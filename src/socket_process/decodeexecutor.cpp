@@ -0,0 +1,137 @@
+#include "socket_process/decodeexecutor.h"
+#include "util/topicmetrics.h"
+#include "util/tracerecorder.h"
+
+#include <QDebug>
+
+DecodeExecutor &DecodeExecutor::instance()
+{
+    static DecodeExecutor executor;
+    return executor;
+}
+
+DecodeExecutor::DecodeExecutor()
+{
+    m_pool.setObjectName("DecodeExecutor");    // 池内线程沿用该名称，追踪导出时作为线程名
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+    m_pool.setExpiryTimeout(-1);    // 线程常驻，避免高频话题反复创建线程
+    qDebug() << "DecodeExecutor: 解码线程数" << m_pool.maxThreadCount();
+}
+
+int DecodeExecutor::threadCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+void DecodeExecutor::setMaxPending(const QString &topic, int maxPending)
+{
+    QMutexLocker locker(&m_mutex);
+    maxPending = qMax(0, maxPending);
+    if (maxPending > 0) m_maxPending.insert(topic, maxPending);
+    else m_maxPending.remove(topic);
+    for (Strand *strand : m_strands) {
+        if (strand->topic == topic) strand->maxPending = maxPending;
+    }
+}
+
+void DecodeExecutor::post(QObject *owner, const QString &topic, std::function<void()> job)
+{
+    if (!owner || !job) return;
+
+    int dropped = 0;
+    TopicMetrics::Entry *metrics = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        Strand *&strand = m_strands[StrandKey(owner, topic)];
+        if (!strand) {
+            strand = new Strand;
+            strand->owner = owner;
+            strand->topic = topic;
+            strand->maxPending = m_maxPending.value(topic, 0);
+            strand->metrics = TopicMetrics::instance().entry(topic);
+        }
+        while (strand->maxPending > 0 && strand->jobs.size() >= strand->maxPending) {
+            strand->jobs.dequeue();
+            ++dropped;
+        }
+        metrics = strand->metrics;
+        strand->jobs.enqueue(std::move(job));
+        if (!strand->scheduled) {
+            strand->scheduled = true;
+            Strand *s = strand;
+            m_pool.start([this, s]() { drain(s); });
+        }
+    }
+    if (dropped > 0) TopicMetrics::instance().recordDrop(metrics, dropped);
+}
+
+// 在线程池线程中执行一个队列的任务；一次最多 MAX_BATCH 个，仍有积压时重新排队，避免一个高频话题占住线程
+void DecodeExecutor::drain(Strand *strand)
+{
+    for (int n = 0; n < MAX_BATCH; ++n) {
+        std::function<void()> job;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (strand->cancelled || strand->jobs.isEmpty()) {
+                strand->scheduled = false;
+                strand->runner = nullptr;
+                if (strand->cancelled) delete strand;   // cancel() 已将其移出 m_strands
+                m_jobFinished.wakeAll();
+                return;
+            }
+            job = strand->jobs.dequeue();
+            strand->runner = QThread::currentThread();
+        }
+        {
+            TraceRecorder::Zone zone("decode.job");
+            job();
+        }
+        {
+            QMutexLocker locker(&m_mutex);
+            strand->runner = nullptr;
+            m_jobFinished.wakeAll();
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!strand->cancelled && !strand->jobs.isEmpty()) {
+        m_pool.start([this, strand]() { drain(strand); });
+        return;
+    }
+    strand->scheduled = false;
+    if (strand->cancelled) delete strand;
+    m_jobFinished.wakeAll();
+}
+
+void DecodeExecutor::cancel(QObject *owner)
+{
+    QMutexLocker locker(&m_mutex);
+    QList<Strand *> owned;
+    for (auto it = m_strands.begin(); it != m_strands.end();) {
+        Strand *strand = it.value();
+        if (strand->owner != owner) {
+            ++it;
+            continue;
+        }
+        strand->jobs.clear();
+        owned.append(strand);
+        it = m_strands.erase(it);
+    }
+
+    // 等待其他线程中正在执行的任务结束，之后 owner 不会再被访问
+    QThread *self = QThread::currentThread();
+    for (;;) {
+        bool busy = false;
+        for (Strand *strand : owned) {
+            if (strand->runner && strand->runner != self) busy = true;
+        }
+        if (!busy) break;
+        m_jobFinished.wait(&m_mutex);
+    }
+
+    // 已排队但未开始（或在本线程执行中）的队列由 drain() 在看到 cancelled 后释放
+    for (Strand *strand : owned) {
+        if (strand->scheduled) strand->cancelled = true;
+        else delete strand;
+    }
+}
@@ -0,0 +1,133 @@
+#include "socket_process/envelopeprefilter.h"
+
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENVELOPE_PREFILTER_SSE2
+#endif
+
+// rosbridge 的 op/topic 总在消息开头（json.dumps 保留插入顺序），只需扫描前面一小段
+static const qsizetype HEAD_CHARS = 512;
+static const qsizetype HEAD_BYTES = 512;
+
+// 查找下一个双引号，SSE2 一次比较 8 个 UTF-16 字符
+static qsizetype findQuote(const char16_t *s, qsizetype from, qsizetype n)
+{
+    qsizetype i = from;
+#ifdef ENVELOPE_PREFILTER_SSE2
+    const __m128i quote = _mm_set1_epi16('"');
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(v, quote));
+        if (mask) return i + (qCountTrailingZeroBits(quint32(mask)) >> 1);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (s[i] == u'"') return i;
+    }
+    return -1;
+}
+
+static qsizetype skipSpaces(const char16_t *s, qsizetype i, qsizetype n)
+{
+    while (i < n && (s[i] == u' ' || s[i] == u'\t' || s[i] == u'\n' || s[i] == u'\r')) ++i;
+    return i;
+}
+
+bool EnvelopePrefilter::peek(QStringView frame, QStringView *op, QStringView *topic)
+{
+    *op = QStringView();
+    *topic = QStringView();
+    const char16_t *s = frame.utf16();
+    const qsizetype n = qMin(frame.size(), HEAD_CHARS);
+
+    QStringView key;        // 最近一个键（只记录 op/topic）
+    qsizetype pos = 0;
+    while (pos < n) {
+        qsizetype b = findQuote(s, pos, n);
+        if (b < 0) break;
+        qsizetype e = b + 1;
+        for (;;) {
+            e = findQuote(s, e, n);
+            if (e < 0) return !op->isEmpty();
+            if (s[e - 1] != u'\\') break;
+            ++e;
+        }
+        QStringView tok(s + b + 1, e - b - 1);
+        pos = skipSpaces(s, e + 1, n);
+
+        if (pos < n && s[pos] == u':') {
+            // 键：op/topic 之外的键忽略；msg 之后不再属于信封
+            if (tok == QLatin1String("msg")) break;
+            key = (tok == QLatin1String("op") || tok == QLatin1String("topic")) ? tok : QStringView();
+            ++pos;
+        } else {
+            // 字符串值
+            if (key == QLatin1String("op")) {
+                *op = tok;
+                if (tok != QLatin1String("publish")) break;     // 只有 publish 需要 topic
+            } else if (key == QLatin1String("topic")) {
+                *topic = tok;
+            }
+            key = QStringView();
+            if (!op->isEmpty() && !topic->isEmpty()) break;
+        }
+    }
+    return !op->isEmpty();
+}
+
+// 在 [hay, hay+n) 中查找 needle，首字节用 memchr（libc 内部向量化）定位
+static qsizetype findBytes(const char *hay, qsizetype n, const char *needle, qsizetype m)
+{
+    qsizetype i = 0;
+    while (i + m <= n) {
+        const void *p = memchr(hay + i, needle[0], size_t(n - i - m + 1));
+        if (!p) return -1;
+        i = static_cast<const char *>(p) - hay;
+        if (memcmp(hay + i, needle, size_t(m)) == 0) return i;
+        ++i;
+    }
+    return -1;
+}
+
+// 读取 key 之后的 CBOR 文本串（major type 3，长度 < 65536）
+static QLatin1String cborTextAfter(const char *s, qsizetype n, qsizetype at)
+{
+    if (at >= n) return QLatin1String();
+    const quint8 b = static_cast<quint8>(s[at]);
+    if ((b >> 5) != 3) return QLatin1String();
+    qsizetype len = b & 0x1f;
+    qsizetype start = at + 1;
+    if (len == 24) {
+        if (start >= n) return QLatin1String();
+        len = static_cast<quint8>(s[start]);
+        start += 1;
+    } else if (len == 25) {
+        if (start + 1 >= n) return QLatin1String();
+        len = (qsizetype(static_cast<quint8>(s[start])) << 8) | static_cast<quint8>(s[start + 1]);
+        start += 2;
+    } else if (len > 25) {
+        return QLatin1String();
+    }
+    if (start + len > n) return QLatin1String();
+    return QLatin1String(s + start, len);
+}
+
+bool EnvelopePrefilter::peekCbor(const QByteArray &frame, QLatin1String *op, QLatin1String *topic)
+{
+    *op = QLatin1String();
+    *topic = QLatin1String();
+    const char *s = frame.constData();
+    const qsizetype n = qMin(frame.size(), HEAD_BYTES);
+    if (n < 1 || (static_cast<quint8>(s[0]) >> 5) != 5) return false;   // 必须是 map
+
+    static const char opKey[] = "\x62op";
+    static const char topicKey[] = "\x65topic";
+    qsizetype i = findBytes(s, n, opKey, 3);
+    if (i >= 0) *op = cborTextAfter(s, n, i + 3);
+    i = findBytes(s, n, topicKey, 6);
+    if (i >= 0) *topic = cborTextAfter(s, n, i + 6);
+    return !op->isEmpty();
+}
@@ -0,0 +1,103 @@
+#include "socket_process/fragmentassembler.h"
+
+#include <algorithm>
+
+// 单条消息的分片数与总长度上限，防止异常数据造成超大分配
+static const int MAX_FRAGMENTS = 100000;
+static const qsizetype MAX_MESSAGE_CHARS = qsizetype(256) * 1024 * 1024;
+
+FragmentAssembler::FragmentAssembler(int timeoutMs)
+    : m_timeoutMs(timeoutMs)
+{
+}
+
+// 把分片拷贝到缓冲区中的固定位置
+void FragmentAssembler::place(Pending &p, int num, const QString &data)
+{
+    std::copy(data.constBegin(), data.constEnd(), p.buffer.begin() + num * p.chunk);
+    if (num == p.total - 1) p.lastLen = data.size();
+}
+
+bool FragmentAssembler::add(const QString &id, int num, int total, const QString &data, QString *complete)
+{
+    if (total <= 0 || total > MAX_FRAGMENTS || num < 0 || num >= total) {
+        qDebug() << "FragmentAssembler: 无效的分片, id:" << id << "num:" << num << "total:" << total;
+        return false;
+    }
+    if (total == 1) {
+        *complete = data;
+        return true;
+    }
+
+    auto it = m_pending.find(id);
+    if (it == m_pending.end()) {
+        it = m_pending.insert(id, Pending());
+        it->total = total;
+        it->received.fill(false, total);
+        it->age.start();
+    }
+    Pending &p = it.value();
+    if (p.total != total || p.received[num]) {
+        qDebug() << "FragmentAssembler: 分片不一致，丢弃 id:" << id;
+        m_pending.erase(it);
+        return false;
+    }
+    p.received[num] = true;
+    p.count++;
+
+    bool isLast = (num == total - 1);
+    if (p.chunk < 0) {
+        if (isLast) {
+            // 还不知道分片长度，先暂存
+            p.early.insert(num, data);
+        } else {
+            // 第一个非最后分片确定分片长度，按最大可能长度一次性分配
+            p.chunk = data.size();
+            if (p.chunk <= 0 || p.chunk * total > MAX_MESSAGE_CHARS) {
+                qDebug() << "FragmentAssembler: 分片长度异常，丢弃 id:" << id;
+                m_pending.erase(it);
+                return false;
+            }
+            p.buffer.resize(p.chunk * total);
+            place(p, num, data);
+            for (auto e = p.early.constBegin(); e != p.early.constEnd(); ++e) {
+                if (e.value().size() > p.chunk) {
+                    m_pending.erase(it);
+                    return false;
+                }
+                place(p, e.key(), e.value());
+            }
+            p.early.clear();
+        }
+    } else {
+        if ((!isLast && data.size() != p.chunk) || (isLast && data.size() > p.chunk)) {
+            qDebug() << "FragmentAssembler: 分片长度不一致，丢弃 id:" << id;
+            m_pending.erase(it);
+            return false;
+        }
+        place(p, num, data);
+    }
+
+    if (p.count < p.total) return false;
+
+    // 收齐：截掉最后分片未用满的部分
+    p.buffer.truncate(p.chunk * (p.total - 1) + p.lastLen);
+    *complete = std::move(p.buffer);
+    m_pending.erase(it);
+    return true;
+}
+
+int FragmentAssembler::purgeExpired()
+{
+    int dropped = 0;
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->age.elapsed() > m_timeoutMs) {
+            qDebug() << "FragmentAssembler: 分片超时，丢弃 id:" << it.key() << "已收到" << it->count << "/" << it->total;
+            it = m_pending.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    return dropped;
+}
@@ -0,0 +1,476 @@
+#include "socket_process/jsonreader.h"
+
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <cstring>
+
+// 10^0 .. 10^22 都能被 double 精确表示，尾数不超过 2^53 时一次乘/除即可得到正确舍入的结果
+static const double POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool JsonReader::equals(QByteArrayView view, const char *literal)
+{
+    const qsizetype n = qsizetype(std::strlen(literal));
+    return view.size() == n && std::memcmp(view.data(), literal, size_t(n)) == 0;
+}
+
+bool JsonReader::fail()
+{
+    m_error = true;
+    m_p = m_end;
+    return false;
+}
+
+void JsonReader::skipSpace()
+{
+    while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) ++m_p;
+}
+
+void JsonReader::skipSeparator()
+{
+    skipSpace();
+    if (m_p < m_end && *m_p == ',') {
+        ++m_p;
+        skipSpace();
+    }
+}
+
+JsonReader::Type JsonReader::peek()
+{
+    skipSeparator();
+    if (m_error || m_p >= m_end) return Invalid;
+    switch (*m_p) {
+    case '{': return Object;
+    case '[': return Array;
+    case '"': return String;
+    case 't':
+    case 'f': return Bool;
+    case 'n': return Null;
+    default:
+        return (*m_p == '-' || isDigit(*m_p)) ? Number : Invalid;
+    }
+}
+
+bool JsonReader::beginObject()
+{
+    skipSeparator();
+    if (m_p >= m_end || *m_p != '{') return fail();
+    ++m_p;
+    return true;
+}
+
+bool JsonReader::nextKey(QByteArrayView *key)
+{
+    skipSeparator();
+    if (m_p >= m_end) return fail();
+    if (*m_p == '}') {
+        ++m_p;
+        return false;
+    }
+    const char *b = nullptr, *e = nullptr;
+    if (!scanString(&b, &e)) return false;
+    skipSpace();
+    if (m_p >= m_end || *m_p != ':') return fail();
+    ++m_p;
+    if (key) *key = QByteArrayView(b, e - b);
+    return true;
+}
+
+bool JsonReader::findKey(const char *key)
+{
+    QByteArrayView k;
+    while (nextKey(&k)) {
+        if (equals(k, key)) return true;
+        if (!skipValue()) return false;
+    }
+    return false;
+}
+
+bool JsonReader::beginArray()
+{
+    skipSeparator();
+    if (m_p >= m_end || *m_p != '[') return fail();
+    ++m_p;
+    return true;
+}
+
+bool JsonReader::nextElement()
+{
+    skipSeparator();
+    if (m_p >= m_end) return fail();
+    if (*m_p == ']') {
+        ++m_p;
+        return false;
+    }
+    return true;
+}
+
+// 定位字符串的起止位置（不含引号），m_p 移到结束引号之后；用 memchr 查找引号，长 base64 字符串也很快
+bool JsonReader::scanString(const char **begin, const char **end)
+{
+    if (m_p >= m_end || *m_p != '"') return fail();
+    const char *b = ++m_p;
+    const char *q = b;
+    for (;;) {
+        q = static_cast<const char *>(std::memchr(q, '"', size_t(m_end - q)));
+        if (!q) return fail();
+        // 前面连续反斜杠为奇数个时该引号被转义
+        const char *s = q;
+        while (s > b && s[-1] == '\\') --s;
+        if (((q - s) & 1) == 0) break;
+        ++q;
+    }
+    *begin = b;
+    *end = q;
+    m_p = q + 1;
+    return true;
+}
+
+bool JsonReader::readString(QByteArrayView *raw)
+{
+    skipSeparator();
+    const char *b = nullptr, *e = nullptr;
+    if (!scanString(&b, &e)) return false;
+    if (raw) *raw = QByteArrayView(b, e - b);
+    return true;
+}
+
+bool JsonReader::readString(QString *out)
+{
+    QByteArrayView raw;
+    if (!readString(&raw)) return false;
+    if (out) *out = unescape(raw);
+    return true;
+}
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool readHex4(const char *p, const char *end, uint *out)
+{
+    if (end - p < 4) return false;
+    uint v = 0;
+    for (int i = 0; i < 4; ++i) {
+        int h = hexValue(p[i]);
+        if (h < 0) return false;
+        v = (v << 4) | uint(h);
+    }
+    *out = v;
+    return true;
+}
+
+QString JsonReader::unescape(QByteArrayView raw)
+{
+    const char *p = raw.data();
+    const char *end = p + raw.size();
+    if (!std::memchr(p, '\\', size_t(raw.size()))) {
+        return QString::fromUtf8(p, raw.size());
+    }
+
+    QByteArray utf8;
+    utf8.reserve(raw.size());
+    while (p < end) {
+        const char *bs = static_cast<const char *>(std::memchr(p, '\\', size_t(end - p)));
+        if (!bs) {
+            utf8.append(p, end - p);
+            break;
+        }
+        utf8.append(p, bs - p);
+        p = bs + 1;
+        if (p >= end) break;
+        const char c = *p++;
+        switch (c) {
+        case 'b': utf8.append('\b'); break;
+        case 'f': utf8.append('\f'); break;
+        case 'n': utf8.append('\n'); break;
+        case 'r': utf8.append('\r'); break;
+        case 't': utf8.append('\t'); break;
+        case 'u': {
+            uint cp = 0;
+            if (!readHex4(p, end, &cp)) return QString::fromUtf8(utf8);
+            p += 4;
+            // 代理对
+            if (cp >= 0xD800 && cp <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                uint lo = 0;
+                if (readHex4(p + 2, end, &lo) && lo >= 0xDC00 && lo <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    p += 6;
+                }
+            }
+            if (cp < 0x80) {
+                utf8.append(char(cp));
+            } else if (cp < 0x800) {
+                utf8.append(char(0xC0 | (cp >> 6)));
+                utf8.append(char(0x80 | (cp & 0x3F)));
+            } else if (cp < 0x10000) {
+                utf8.append(char(0xE0 | (cp >> 12)));
+                utf8.append(char(0x80 | ((cp >> 6) & 0x3F)));
+                utf8.append(char(0x80 | (cp & 0x3F)));
+            } else {
+                utf8.append(char(0xF0 | (cp >> 18)));
+                utf8.append(char(0x80 | ((cp >> 12) & 0x3F)));
+                utf8.append(char(0x80 | ((cp >> 6) & 0x3F)));
+                utf8.append(char(0x80 | (cp & 0x3F)));
+            }
+            break;
+        }
+        default:    // '"'、'\\'、'/'
+            utf8.append(c);
+            break;
+        }
+    }
+    return QString::fromUtf8(utf8);
+}
+
+// 数值解析：有效数字不超过 19 位且指数在 ±22 内时走快速路径，否则交给 QByteArray::toDouble（与区域设置无关）
+bool JsonReader::scanNumber(double *out)
+{
+    const char *start = m_p;
+    const char *p = m_p;
+    bool negative = false;
+    if (p < m_end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    int significant = 0;
+    int exp10 = 0;
+    bool anyDigit = false;
+    bool exact = true;      // 有效数字未被截断
+
+    while (p < m_end && isDigit(*p)) {
+        const int d = *p++ - '0';
+        anyDigit = true;
+        if (mantissa == 0 && d == 0) continue;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + quint64(d);
+            ++significant;
+        } else {
+            ++exp10;
+            if (d) exact = false;
+        }
+    }
+    if (p < m_end && *p == '.') {
+        ++p;
+        while (p < m_end && isDigit(*p)) {
+            const int d = *p++ - '0';
+            anyDigit = true;
+            if (mantissa == 0 && d == 0) {
+                --exp10;
+                continue;
+            }
+            if (significant < 19) {
+                mantissa = mantissa * 10 + quint64(d);
+                ++significant;
+                --exp10;
+            } else if (d) {
+                exact = false;
+            }
+        }
+    }
+    if (!anyDigit) return fail();
+    if (p < m_end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool expNegative = false;
+        if (p < m_end && (*p == '+' || *p == '-')) {
+            expNegative = (*p == '-');
+            ++p;
+        }
+        if (p >= m_end || !isDigit(*p)) return fail();
+        int e = 0;
+        while (p < m_end && isDigit(*p)) {
+            if (e < 100000) e = e * 10 + (*p - '0');
+            ++p;
+        }
+        exp10 += expNegative ? -e : e;
+    }
+    m_p = p;
+
+    double v;
+    if (mantissa == 0) {
+        v = 0.0;
+    } else if (exact && mantissa <= (quint64(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+        v = double(mantissa);
+        v = exp10 < 0 ? v / POW10[-exp10] : v * POW10[exp10];
+    } else {
+        bool ok = false;
+        v = QByteArray(start, p - start).toDouble(&ok);
+        if (!ok) return fail();
+        *out = v;
+        return true;
+    }
+    *out = negative ? -v : v;
+    return true;
+}
+
+bool JsonReader::readDouble(double *out)
+{
+    skipSeparator();
+    double v = 0;
+    if (!scanNumber(&v)) return false;
+    if (out) *out = v;
+    return true;
+}
+
+bool JsonReader::readInt(qint64 *out)
+{
+    skipSeparator();
+    // 纯整数直接累加，带小数或指数时按 double 解析后截断
+    const char *p = m_p;
+    bool negative = false;
+    if (p < m_end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+    const char *digits = p;
+    quint64 v = 0;
+    while (p < m_end && isDigit(*p) && p - digits < 18) v = v * 10 + quint64(*p++ - '0');
+    if (p > digits && (p >= m_end || (*p != '.' && *p != 'e' && *p != 'E' && !isDigit(*p)))) {
+        m_p = p;
+        if (out) *out = negative ? -qint64(v) : qint64(v);
+        return true;
+    }
+    double d = 0;
+    if (!scanNumber(&d)) return false;
+    if (out) *out = d >= 9.2e18 ? Q_INT64_C(9200000000000000000) : (d <= -9.2e18 ? -Q_INT64_C(9200000000000000000) : qint64(d));
+    return true;
+}
+
+// uint8[] 中不会嵌套括号，先用 memchr 定位 ']' 确定输出上界（每个元素至少占数字和分隔符 2 个字符），
+// 再一次性扩容并逐个写入字节；超过 255 的值按低 8 位截断，与 QJsonArray 的 toInt() & 0xFF 一致
+// 元素后还有 8 个以上字符时一次读入 8 字节，用 SWAR 找出第一个非数字字符得到位数，无分支地拼出 1~3 位数值
+bool JsonReader::readByteArray(QByteArray *out)
+{
+    if (!beginArray()) return false;
+    const char *close = static_cast<const char *>(std::memchr(m_p, ']', size_t(m_end - m_p)));
+    if (!close) return fail();
+
+    const qsizetype base = out->size();
+    out->resize(base + (close - m_p) / 2 + 1);
+    uchar *const begin = reinterpret_cast<uchar *>(out->data()) + base;
+    uchar *o = begin;
+    const char *p = m_p;
+    while (p < close) {
+        uint d = uint(uchar(*p)) - '0';
+        if (d > 9) {
+            if (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') {
+                ++p;
+                continue;
+            }
+            out->resize(base);
+            return fail();
+        }
+
+        uint v = d;
+        int len = 0;
+        if (close - p >= 8) {
+            const quint64 w = qFromLittleEndian<quint64>(p);
+            // 字节 < '0' 时减法借位、> '9' 时加法进位都会置最高位；借位/进位只影响更高的字节，不影响第一个非数字的位置
+            const quint64 nondigit = ((w + Q_UINT64_C(0x4646464646464646)) | (w - Q_UINT64_C(0x3030303030303030)))
+                                     & Q_UINT64_C(0x8080808080808080);
+            len = nondigit ? int(qCountTrailingZeroBits(nondigit) >> 3) : 8;
+            if (len <= 3) {
+                // 把 len 位数字右对齐到 3 个字节（高位补 0），再按 100/10/1 加权
+                const quint64 digits = (w - Q_UINT64_C(0x3030303030303030)) & ((Q_UINT64_C(1) << (8 * len)) - 1);
+                const quint64 x = digits << (8 * (3 - len));
+                v = uint(x & 0xFF) * 100 + uint((x >> 8) & 0xFF) * 10 + uint((x >> 16) & 0xFF);
+                p += len;
+            }
+        }
+        if (len == 0 || len > 3) {
+            // *close 为 ']'，越过最后一个数字时读到的是它，不会越界
+            while ((d = uint(uchar(*++p)) - '0') <= 9) v = v * 10 + d;
+        }
+        *o++ = uchar(v);
+
+        if (*p == ',') {
+            ++p;
+            if (*p == ' ') ++p;     // Python json.dumps 默认的 ", " 分隔
+            continue;
+        }
+        while (*p == ' ') ++p;
+        if (*p == ',') {
+            ++p;
+        } else if (p < close && *p != '\n' && *p != '\r' && *p != '\t') {
+            out->resize(base);
+            return fail();
+        }
+    }
+    out->resize(base + (o - begin));
+    m_p = close + 1;
+    return true;
+}
+
+bool JsonReader::expectLiteral(const char *literal, qsizetype length)
+{
+    if (m_end - m_p < length || std::memcmp(m_p, literal, size_t(length)) != 0) return fail();
+    m_p += length;
+    return true;
+}
+
+bool JsonReader::readBool(bool *out)
+{
+    skipSeparator();
+    if (m_p < m_end && *m_p == 't') {
+        if (!expectLiteral("true", 4)) return false;
+        if (out) *out = true;
+        return true;
+    }
+    if (!expectLiteral("false", 5)) return false;
+    if (out) *out = false;
+    return true;
+}
+
+bool JsonReader::readNull()
+{
+    skipSeparator();
+    return expectLiteral("null", 4);
+}
+
+bool JsonReader::skipValue()
+{
+    switch (peek()) {
+    case String:
+        return readString(static_cast<QByteArrayView *>(nullptr));
+    case Number: {
+        double v;
+        return readDouble(&v);
+    }
+    case Bool:
+        return readBool(nullptr);
+    case Null:
+        return readNull();
+    case Object:
+    case Array: {
+        // 只跟踪括号深度，字符串整体跳过（其中的括号不计）
+        int depth = 0;
+        while (m_p < m_end) {
+            const char c = *m_p;
+            if (c == '"') {
+                const char *b, *e;
+                if (!scanString(&b, &e)) return false;
+                continue;
+            }
+            ++m_p;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) return true;
+            }
+        }
+        return fail();
+    }
+    default:
+        return fail();
+    }
+}
@@ -0,0 +1,53 @@
+#include "socket_process/pngdecoder.h"
+#include "socket_process/jsonreader.h"
+#include "util/base64decoder.h"
+
+#include <QImage>
+#include <QDebug>
+#include <cstring>
+
+bool PngDecoder::decode(const QString &frame, QString *json)
+{
+    const QByteArray utf8 = frame.toUtf8();
+    JsonReader reader(utf8);
+    if (!reader.beginObject() || !reader.findKey("data")) {
+        qDebug() << "PngDecoder: png frame without data";
+        return false;
+    }
+    QByteArrayView data;
+    if (!reader.readString(&data)) return false;
+
+    QByteArray bytes;
+    if (!decodeData(data, &bytes)) return false;
+    *json = QString::fromUtf8(bytes);
+    return true;
+}
+
+bool PngDecoder::decodeData(QByteArrayView base64, QByteArray *json)
+{
+    QByteArray png;
+    Base64Decoder::decode(base64, &png);
+
+    QImage image;
+    if (!image.loadFromData(png, "PNG")) {
+        qDebug() << "PngDecoder: invalid png payload," << png.size() << "bytes";
+        return false;
+    }
+    if (image.format() != QImage::Format_RGB888) {
+        image = image.convertToFormat(QImage::Format_RGB888);
+    }
+
+    // 每行 width*3 字节为有效数据，scanLine 的行尾可能有 4 字节对齐的填充
+    const qsizetype rowBytes = qsizetype(image.width()) * 3;
+    json->resize(rowBytes * image.height());
+    char *out = json->data();
+    for (int y = 0; y < image.height(); ++y) {
+        memcpy(out + rowBytes * y, image.constScanLine(y), size_t(rowBytes));
+    }
+
+    // 去掉补齐用的换行
+    qsizetype size = json->size();
+    while (size > 0 && json->at(size - 1) == '\n') --size;
+    json->resize(size);
+    return size > 0;
+}
@@ -0,0 +1,148 @@
+#include "socket_process/replaysource.h"
+#include "socket_process/websocketworker.h"
+
+#include <QFileInfo>
+
+ReplaySource::ReplaySource(WebSocketWorker *worker)
+    : QObject(worker), m_worker(worker), m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ReplaySource::pump);
+}
+
+void ReplaySource::open(const QString &path)
+{
+    pause();
+    if (!m_reader.open(path)) {
+        qDebug() << "ReplaySource: cannot open" << path << m_reader.errorString();
+        emit openFailed(m_reader.errorString());
+        return;
+    }
+    m_chunk = -1;
+    m_frames.clear();
+    m_next = 0;
+    loadChunk(0);
+    m_positionUs = m_reader.firstUs();
+
+    // worker 按已连接处理，使用者照常启动订阅；回放帧会经过与在线时相同的话题预过滤
+    if (m_worker) m_worker->beginReplay(QStringLiteral("replay://") + QFileInfo(path).fileName());
+    emit opened(m_reader.url(), m_reader.lastUs() - m_reader.firstUs(), m_reader.frameCount(), m_reader.topics());
+    reportPosition(true);
+}
+
+void ReplaySource::play()
+{
+    if (m_playing || m_reader.chunks().isEmpty()) return;
+    if (atEnd()) seek(0);
+    m_playing = true;
+    m_stats = Stats();
+    m_playTimer.start();
+    anchor();
+    emit playingChanged(true);
+    m_timer->start(0);
+}
+
+void ReplaySource::pause()
+{
+    if (!m_playing) return;
+    m_playing = false;
+    m_timer->stop();
+    reportPosition(true);
+    emit playingChanged(false);
+}
+
+void ReplaySource::setSpeed(double speed)
+{
+    m_speed = qMax(0.0, speed);
+    if (m_playing) anchor();
+}
+
+void ReplaySource::seek(qint64 offsetUs)
+{
+    if (m_reader.chunks().isEmpty()) return;
+    const qint64 target = m_reader.firstUs() + qMax<qint64>(0, offsetUs);
+    int index = m_reader.chunkAt(target);
+    if (index < 0) index = m_reader.chunks().size() - 1;
+    if (index != m_chunk) loadChunk(index);
+    m_next = 0;
+    while (m_next < m_frames.size() && m_frames.at(m_next).receivedUs < target) ++m_next;
+    m_positionUs = m_next < m_frames.size() ? m_frames.at(m_next).receivedUs : m_reader.lastUs();
+    if (m_playing) anchor();
+    reportPosition(true);
+}
+
+bool ReplaySource::loadChunk(int index)
+{
+    m_next = 0;
+    m_chunk = index;
+    if (!m_reader.readChunk(index, &m_frames)) {
+        qDebug() << "ReplaySource: cannot read chunk" << index << m_reader.errorString();
+        return false;
+    }
+    return true;
+}
+
+void ReplaySource::anchor()
+{
+    m_anchorUs = m_next < m_frames.size() ? m_frames.at(m_next).receivedUs : m_positionUs;
+    m_clock.start();
+}
+
+// 注入所有已到时间的帧；原速/倍速下等到下一帧的时间再继续，最快速度下每 MAX_SLICE_MS 让出一次事件循环，
+// 使 worker 线程中排队的订阅、服务应答等仍能得到处理
+void ReplaySource::pump()
+{
+    if (!m_playing) return;
+    QElapsedTimer slice;
+    slice.start();
+
+    for (;;) {
+        if (m_next >= m_frames.size()) {
+            if (m_chunk + 1 >= m_reader.chunks().size()) break;
+            // 读下一块（4 MiB 左右），落后的时间在下一帧计入 maxLagMs
+            loadChunk(m_chunk + 1);
+            continue;
+        }
+        const SessionReader::Frame &frame = m_frames.at(m_next);
+        if (m_speed > 0) {
+            const qint64 dueUs = qint64(double(frame.receivedUs - m_anchorUs) / m_speed);
+            const qint64 nowUs = m_clock.nsecsElapsed() / 1000;
+            if (dueUs > nowUs) {
+                reportPosition(false);
+                m_timer->start(int((dueUs - nowUs) / 1000));
+                return;
+            }
+            m_stats.maxLagMs = qMax(m_stats.maxLagMs, (nowUs - dueUs) / 1000);
+        }
+
+        m_positionUs = frame.receivedUs;
+        ++m_stats.frames;
+        m_stats.bytes += quint64(frame.data.size());
+        ++m_next;
+        if (m_worker) m_worker->injectFrame(frame.data, frame.kind == SessionRecorder::BinaryFrame);
+
+        if (slice.elapsed() >= MAX_SLICE_MS) {
+            reportPosition(false);
+            m_timer->start(0);
+            return;
+        }
+    }
+
+    m_playing = false;
+    m_stats.elapsedMs = m_playTimer.elapsed();
+    reportPosition(true);
+    const double seconds = qMax<qint64>(1, m_stats.elapsedMs) / 1000.0;
+    qDebug() << "ReplaySource: finished," << m_stats.frames << "frames in" << m_stats.elapsedMs << "ms,"
+             << m_stats.frames / seconds << "frames/s," << m_stats.bytes / seconds / (1024 * 1024) << "MiB/s,"
+             << "max lag" << m_stats.maxLagMs << "ms";
+    emit playingChanged(false);
+    emit finished(m_stats.frames, m_stats.bytes, m_stats.elapsedMs, m_stats.maxLagMs);
+}
+
+void ReplaySource::reportPosition(bool force)
+{
+    if (!force && m_progressTimer.isValid() && m_progressTimer.elapsed() < PROGRESS_INTERVAL_MS) return;
+    m_progressTimer.start();
+    emit positionChanged(m_positionUs - m_reader.firstUs());
+}
@@ -0,0 +1,70 @@
+#include "socket_process/rosapi.h"
+#include "socket_process/websocketworker.h"
+#include "socket_process/typeddecoder.h"
+
+#include <QJsonArray>
+
+// 应答 values 的解析在 socket 线程中完成（QFuture::then 不带 context 时在完成 promise 的线程执行）
+
+QFuture<RosApi::TopicList> RosApi::topics(WebSocketWorker *worker, int timeoutMs)
+{
+    return worker->callService(QStringLiteral("/rosapi/topics"), QJsonObject(), timeoutMs)
+        .then([](const ServiceResponse &response) {
+            TopicList list;
+            list.ok = response.ok;
+            list.error = response.error;
+            list.elapsedUs = response.elapsedUs;
+            if (!response.ok) return list;
+
+            // {"topics": [...], "types": [...]}，较老的 rosapi 没有 types
+            const QJsonObject values = response.values.toObject();
+            const QJsonArray names = values.value("topics").toArray();
+            const QJsonArray types = values.value("types").toArray();
+            list.topics.reserve(names.size());
+            for (qsizetype i = 0; i < names.size(); ++i) {
+                RosTopicInfo info;
+                info.name = names.at(i).toString();
+                if (i < types.size()) info.type = types.at(i).toString();
+                list.topics.append(info);
+            }
+            return list;
+        });
+}
+
+QFuture<RosApi::TopicType> RosApi::topicType(WebSocketWorker *worker, const QString &topic, int timeoutMs)
+{
+    QJsonObject args;
+    args["topic"] = topic;
+    return worker->callService(QStringLiteral("/rosapi/topic_type"), args, timeoutMs)
+        .then([topic](const ServiceResponse &response) {
+            TopicType result;
+            result.ok = response.ok;
+            result.error = response.error;
+            result.topic = topic;
+            result.type = response.values.toObject().value("type").toString();
+            return result;
+        });
+}
+
+QFuture<RosApi::Time> RosApi::getTime(WebSocketWorker *worker, int timeoutMs)
+{
+    return worker->callService(QStringLiteral("/rosapi/get_time"), QJsonObject(), timeoutMs)
+        .then([](const ServiceResponse &response) {
+            Time result;
+            result.ok = response.ok;
+            result.error = response.error;
+            result.sentAtUs = response.sentAtUs;
+            result.receivedAtUs = response.receivedAtUs;
+            result.elapsedUs = response.elapsedUs;
+            if (!response.ok) return result;
+
+            // {"time": {"secs", "nsecs"}}（ROS1）或 {"time": {"sec", "nanosec"}}（ROS2）
+            const QJsonObject time = response.values.toObject().value("time").toObject();
+            quint32 seen = 0;
+            if (!TypedDecoder::decode(time, &result.stamp, &seen) || seen == 0) {
+                result.ok = false;
+                result.error = QStringLiteral("get_time response without time");
+            }
+            return result;
+        });
+}
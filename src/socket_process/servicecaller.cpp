@@ -0,0 +1,83 @@
+#include "socket_process/servicecaller.h"
+
+#include "util/messagestamps.h"
+
+#include <QJsonDocument>
+#include <QDebug>
+
+QString ServiceCaller::add(const QString &service, const QJsonObject &args, int timeoutMs, const Promise &promise, QString *request)
+{
+    const QString id = QStringLiteral("call_service:%1:%2").arg(service).arg(++m_nextId);
+
+    QJsonObject call;
+    call["op"] = "call_service";
+    call["id"] = id;
+    call["service"] = service;
+    if (!args.isEmpty()) call["args"] = args;
+    *request = QString::fromUtf8(QJsonDocument(call).toJson(QJsonDocument::Compact));
+
+    Pending pending;
+    pending.promise = promise;
+    pending.service = service;
+    pending.sentAtUs = MessageStamps::nowUs();
+    pending.age.start();
+    pending.timeoutMs = timeoutMs;
+    m_pending.insert(id, pending);
+    return id;
+}
+
+void ServiceCaller::finish(Pending &pending, ServiceResponse response)
+{
+    response.service = pending.service;
+    response.sentAtUs = pending.sentAtUs;
+    response.receivedAtUs = MessageStamps::nowUs();
+    response.elapsedUs = pending.age.nsecsElapsed() / 1000;
+    pending.promise->addResult(response);
+    pending.promise->finish();
+}
+
+// 服务应答：{"op": "service_response", "id": ..., "service": ..., "values": {...}, "result": true}
+// 失败时 result 为 false，values 为错误信息字符串
+bool ServiceCaller::complete(const QJsonObject &response)
+{
+    auto it = m_pending.find(response.value("id").toString());
+    if (it == m_pending.end()) return false;
+
+    ServiceResponse r;
+    r.ok = response.value("result").toBool(true);
+    r.values = response.value("values");
+    if (!r.ok) {
+        r.error = r.values.isString() ? r.values.toString() : QStringLiteral("service call failed");
+    }
+    finish(it.value(), r);
+    m_pending.erase(it);
+    return true;
+}
+
+int ServiceCaller::expire()
+{
+    int expired = 0;
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->age.elapsed() < it->timeoutMs) {
+            ++it;
+            continue;
+        }
+        qDebug() << "ServiceCaller:" << it->service << "timed out after" << it->timeoutMs << "ms";
+        ServiceResponse r;
+        r.error = QStringLiteral("timeout");
+        finish(it.value(), r);
+        it = m_pending.erase(it);
+        ++expired;
+    }
+    return expired;
+}
+
+void ServiceCaller::failAll(const QString &error)
+{
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+        ServiceResponse r;
+        r.error = error;
+        finish(it.value(), r);
+    }
+    m_pending.clear();
+}
@@ -0,0 +1,257 @@
+#include "socket_process/sessionreader.h"
+
+#include <QtEndian>
+
+// 块头：4 字节标签 + u32 内容长度
+static const int BLOCK_HEADER_BYTES = 8;
+// CHNK 内容开头：u32 帧数 | i64 首帧时间 | i64 末帧时间
+static const int CHUNK_HEADER_BYTES = 4 + 8 + 8;
+// 帧头：i64 接收时间 | u8 类型 | u16 话题编号 | u32 长度
+static const int FRAME_HEADER_BYTES = 8 + 1 + 2 + 4;
+// 文件尾：u64 TRLR 偏移 | "RBWEND01"，正常结束的录制才有
+static const int TAIL_BYTES = 8 + 8;
+// TRLR 中每块一项：u64 CHNK 偏移 | u64 INDX 偏移 | i64 首帧时间 | i64 末帧时间 | u32 帧数
+static const int TRAILER_ENTRY_BYTES = 8 + 8 + 8 + 8 + 4;
+
+template <typename T>
+static T getLE(const char *p) { return qFromLittleEndian<T>(p); }
+
+bool SessionReader::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    const QByteArray header = m_file.read(8 + 8 + 4);
+    if (header.size() != 20 || !header.startsWith("RBWREC01")) {
+        m_error = QStringLiteral("not a session recording");
+        close();
+        return false;
+    }
+    m_startUs = getLE<qint64>(header.constData() + 8);
+    const quint32 urlLength = getLE<quint32>(header.constData() + 16);
+    m_url = QString::fromUtf8(m_file.read(urlLength));
+
+    if (!scan()) {
+        close();
+        return false;
+    }
+    qDebug() << "SessionReader:" << path << m_chunks.size() << "chunks," << m_frameCount << "frames,"
+             << m_topics.size() << "topics," << (lastUs() - firstUs()) / 1000 << "ms";
+    return true;
+}
+
+void SessionReader::close()
+{
+    m_file.close();
+    m_url.clear();
+    m_startUs = 0;
+    m_frameCount = 0;
+    m_chunks.clear();
+    m_topics.clear();
+    m_topicCounts.clear();
+}
+
+void SessionReader::addTopic(const QByteArray &data)
+{
+    if (data.size() >= 2) {
+        m_topics.insert(getLE<quint16>(data.constData()), QString::fromUtf8(data.mid(2)));
+    }
+}
+
+// INDX 内容：u64 CHNK 偏移 | u32 话题数 | 每个话题：u16 编号 | u32 帧数 | i64 | i64 | u32 × 帧数
+void SessionReader::addIndex(const QByteArray &data)
+{
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    if (data.size() < 12) return;
+    const quint32 entries = getLE<quint32>(p + 8);
+    p += 12;
+    for (quint32 i = 0; i < entries && p + 22 <= end; ++i) {
+        const quint16 id = getLE<quint16>(p);
+        const quint32 count = getLE<quint32>(p + 2);
+        m_topicCounts[id] += count;
+        p += 22 + qint64(count) * 4;
+    }
+}
+
+bool SessionReader::scan()
+{
+    qint64 size = m_file.size();
+    const qint64 start = m_file.pos();
+    // 正常结束的录制以文件尾结束，它不是块，不参与扫描；按其中的 TRLR 偏移直接读块表
+    if (size - start >= TAIL_BYTES && m_file.seek(size - TAIL_BYTES)) {
+        const QByteArray tail = m_file.read(TAIL_BYTES);
+        if (tail.size() == TAIL_BYTES && tail.endsWith("RBWEND01")) {
+            size -= TAIL_BYTES;
+            const quint64 trailerOffset = getLE<quint64>(tail.constData());
+            if (trailerOffset <= quint64(size) && readTrailer(start, qint64(trailerOffset), size)) return true;
+            qDebug() << "SessionReader: trailer does not match the file, scanning blocks";
+            m_chunks.clear();
+            m_topics.clear();
+            m_topicCounts.clear();
+            m_frameCount = 0;
+        }
+    }
+    return scanBlocks(start, size);
+}
+
+// 正常关闭的录制：块表来自 TRLR，只读各块的 INDX 和写在块前的 TOPC（都很小），不逐块扫描块头
+// TRLR 与文件内容对不上时返回 false，由调用方改为顺序扫描
+bool SessionReader::readTrailer(qint64 start, qint64 trailerOffset, qint64 size)
+{
+    if (trailerOffset < start || !m_file.seek(trailerOffset)) return false;
+    const QByteArray head = m_file.read(BLOCK_HEADER_BYTES);
+    if (head.size() != BLOCK_HEADER_BYTES || !head.startsWith("TRLR")) return false;
+    const qint64 length = getLE<quint32>(head.constData() + 4);
+    if (length < 4 || trailerOffset + BLOCK_HEADER_BYTES + length != size) return false;
+    const QByteArray trailer = m_file.read(length);
+    if (trailer.size() != length) return false;
+    const quint32 count = getLE<quint32>(trailer.constData());
+    if (qint64(count) * TRAILER_ENTRY_BYTES != length - 4) return false;
+
+    m_chunks.reserve(int(count));
+    qint64 previousEnd = start;     // 上一块 INDX 的结尾，到本块 CHNK 之间只有 TOPC
+    const char *p = trailer.constData() + 4;
+    for (quint32 i = 0; i < count; ++i, p += TRAILER_ENTRY_BYTES) {
+        const qint64 chunkOffset = qint64(getLE<quint64>(p));
+        const qint64 indexOffset = qint64(getLE<quint64>(p + 8));
+        if (chunkOffset < previousEnd || indexOffset < chunkOffset + BLOCK_HEADER_BYTES + CHUNK_HEADER_BYTES
+            || indexOffset + BLOCK_HEADER_BYTES > trailerOffset) {
+            return false;
+        }
+
+        if (chunkOffset > previousEnd) {
+            if (!m_file.seek(previousEnd)) return false;
+            const QByteArray blocks = m_file.read(chunkOffset - previousEnd);
+            if (blocks.size() != chunkOffset - previousEnd) return false;
+            qint64 pos = 0;
+            while (pos + BLOCK_HEADER_BYTES <= blocks.size()) {
+                const qint64 blockLength = getLE<quint32>(blocks.constData() + pos + 4);
+                if (pos + BLOCK_HEADER_BYTES + blockLength > blocks.size()) return false;
+                if (blocks.mid(pos, 4) == "TOPC") addTopic(blocks.mid(pos + BLOCK_HEADER_BYTES, blockLength));
+                pos += BLOCK_HEADER_BYTES + blockLength;
+            }
+        }
+
+        if (!m_file.seek(indexOffset)) return false;
+        const QByteArray indexHead = m_file.read(BLOCK_HEADER_BYTES);
+        if (indexHead.size() != BLOCK_HEADER_BYTES || !indexHead.startsWith("INDX")) return false;
+        const qint64 indexLength = getLE<quint32>(indexHead.constData() + 4);
+        if (indexOffset + BLOCK_HEADER_BYTES + indexLength > trailerOffset) return false;
+        const QByteArray index = m_file.read(indexLength);
+        if (index.size() != indexLength || index.size() < 8 || qint64(getLE<quint64>(index.constData())) != chunkOffset) return false;
+        addIndex(index);
+
+        Chunk chunk;
+        chunk.offset = chunkOffset + BLOCK_HEADER_BYTES + CHUNK_HEADER_BYTES;
+        chunk.length = indexOffset - chunk.offset;
+        chunk.firstUs = getLE<qint64>(p + 16);
+        chunk.lastUs = getLE<qint64>(p + 24);
+        chunk.count = getLE<quint32>(p + 32);
+        m_chunks.append(chunk);
+        m_frameCount += chunk.count;
+        previousEnd = indexOffset + BLOCK_HEADER_BYTES + indexLength;
+    }
+
+    if (m_chunks.isEmpty()) {
+        m_error = QStringLiteral("recording contains no frames");
+        return false;
+    }
+    return true;
+}
+
+// 未正常关闭的录制（或 TRLR 损坏）：顺序扫描块头，TOPC 和 INDX 读入（都很小），CHNK 只读开头的帧数和时间范围
+bool SessionReader::scanBlocks(qint64 pos, qint64 size)
+{
+    while (pos + BLOCK_HEADER_BYTES <= size) {
+        if (!m_file.seek(pos)) break;
+        const QByteArray head = m_file.read(BLOCK_HEADER_BYTES);
+        if (head.size() != BLOCK_HEADER_BYTES) break;
+        const QByteArray tag = head.left(4);
+        const qint64 length = getLE<quint32>(head.constData() + 4);
+        const qint64 body = pos + BLOCK_HEADER_BYTES;
+        if (body + length > size) {
+            qDebug() << "SessionReader: truncated" << tag << "block at" << pos << ", ignoring the rest";
+            break;
+        }
+
+        if (tag == "TOPC") {
+            addTopic(m_file.read(length));
+        } else if (tag == "CHNK") {
+            const QByteArray data = m_file.read(CHUNK_HEADER_BYTES);
+            if (data.size() == CHUNK_HEADER_BYTES) {
+                Chunk chunk;
+                chunk.count = getLE<quint32>(data.constData());
+                chunk.firstUs = getLE<qint64>(data.constData() + 4);
+                chunk.lastUs = getLE<qint64>(data.constData() + 12);
+                chunk.offset = body + CHUNK_HEADER_BYTES;
+                chunk.length = length - CHUNK_HEADER_BYTES;
+                m_chunks.append(chunk);
+                m_frameCount += chunk.count;
+            }
+        } else if (tag == "INDX") {
+            addIndex(m_file.read(length));
+        }
+        // TRLR 及不认识的块直接跳过；块表已由扫描得到
+        pos = body + length;
+    }
+
+    if (m_chunks.isEmpty()) {
+        m_error = QStringLiteral("recording contains no frames");
+        return false;
+    }
+    return true;
+}
+
+QStringList SessionReader::topics() const
+{
+    QStringList names = m_topics.values();
+    names.sort();
+    return names;
+}
+
+bool SessionReader::readChunk(int index, QVector<Frame> *out)
+{
+    out->clear();
+    if (index < 0 || index >= m_chunks.size()) return false;
+    const Chunk &chunk = m_chunks.at(index);
+    if (!m_file.seek(chunk.offset)) return false;
+    const QByteArray data = m_file.read(chunk.length);
+    if (data.size() != chunk.length) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    // 帧数来自文件，按块长度能容纳的最多帧数封顶，损坏的文件不会导致超大分配
+    out->reserve(int(qMin<qint64>(chunk.count, chunk.length / FRAME_HEADER_BYTES)));
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    while (p + FRAME_HEADER_BYTES <= end) {
+        Frame frame;
+        frame.receivedUs = getLE<qint64>(p);
+        frame.kind = SessionRecorder::FrameKind(quint8(p[8]));
+        frame.topicId = getLE<quint16>(p + 9);
+        const quint32 length = getLE<quint32>(p + 11);
+        p += FRAME_HEADER_BYTES;
+        if (qint64(length) > end - p) break;
+        frame.data = QByteArray(p, length);
+        p += length;
+        out->append(frame);
+    }
+    return true;
+}
+
+int SessionReader::chunkAt(qint64 us) const
+{
+    int lo = 0, hi = m_chunks.size();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (m_chunks.at(mid).lastUs < us) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < m_chunks.size() ? lo : -1;
+}
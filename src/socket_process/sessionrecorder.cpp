@@ -0,0 +1,272 @@
+#include "socket_process/sessionrecorder.h"
+
+#include "util/messagestamps.h"
+#include "util/topicmetrics.h"
+
+#include <QtEndian>
+#include <QFileInfo>
+#include <QDir>
+
+static void putU8(QByteArray &out, quint8 v) { out.append(char(v)); }
+
+static void putU16(QByteArray &out, quint16 v)
+{
+    char b[2];
+    qToLittleEndian(v, b);
+    out.append(b, 2);
+}
+
+static void putU32(QByteArray &out, quint32 v)
+{
+    char b[4];
+    qToLittleEndian(v, b);
+    out.append(b, 4);
+}
+
+static void putU64(QByteArray &out, quint64 v)
+{
+    char b[8];
+    qToLittleEndian(v, b);
+    out.append(b, 8);
+}
+
+static void putI64(QByteArray &out, qint64 v) { putU64(out, quint64(v)); }
+
+// 块头：4 字节标签 + u32 内容长度
+static void putBlockHeader(QByteArray &out, const char *tag, quint32 length)
+{
+    out.append(tag, 4);
+    putU32(out, length);
+}
+
+SessionRecorder::SessionRecorder()
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+bool SessionRecorder::start(const QString &path, const QString &url)
+{
+    if (m_thread) stop();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "SessionRecorder: cannot open" << path << m_file.errorString();
+        return false;
+    }
+
+    m_path = path;
+    m_pending.clear();
+    m_pendingBytes = 0;
+    m_stopping = false;
+    m_chunk.resize(0);
+    m_chunk.reserve(CHUNK_BYTES + 64 * 1024);
+    m_topicBlocks.clear();
+    m_chunkCount = 0;
+    m_topicIds.clear();
+    m_chunkIndex.clear();
+    m_chunks.clear();
+    m_writeFailed = false;
+    m_framesWritten.storeRelaxed(0);
+    m_bytesWritten.storeRelaxed(0);
+    m_framesDropped.storeRelaxed(0);
+
+    QByteArray header("RBWREC01", 8);
+    const QByteArray urlUtf8 = url.toUtf8();
+    putI64(header, MessageStamps::nowUs());
+    putU32(header, quint32(urlUtf8.size()));
+    header.append(urlUtf8);
+    writeAll(header);
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName("SessionRecorder");
+    m_thread->start(QThread::LowPriority);
+    qDebug() << "SessionRecorder: recording to" << path;
+    return true;
+}
+
+void SessionRecorder::stop()
+{
+    if (!m_thread) return;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+    }
+    m_wake.wakeOne();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_file.close();
+    qDebug() << "SessionRecorder: stopped," << framesWritten() << "frames," << bytesWritten() << "bytes,"
+             << framesDropped() << "dropped ->" << m_path;
+}
+
+void SessionRecorder::record(FrameKind kind, qint64 receivedUs, const QString &topic, const QByteArray &data)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_stopping) return;
+        if (m_pendingBytes + data.size() > MAX_PENDING_BYTES) {
+            locker.unlock();
+            m_framesDropped.fetchAndAddRelaxed(1);
+            TopicMetrics::instance().recordDrop("<recorder>");
+            return;
+        }
+        m_pending.append(Frame{receivedUs, kind, topic, data});
+        m_pendingBytes += data.size();
+    }
+    m_wake.wakeOne();
+}
+
+// 每次取走队列中的全部帧，编码进当前块；块够大或够久时整块写出
+void SessionRecorder::run()
+{
+    QVector<Frame> batch;
+    for (;;) {
+        bool stopping = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_pending.isEmpty() && !m_stopping) {
+                m_wake.wait(&m_mutex, CHUNK_MAX_AGE_MS);
+            }
+            batch.swap(m_pending);
+            m_pendingBytes = 0;
+            stopping = m_stopping;
+        }
+
+        for (const Frame &frame : batch) {
+            append(frame);
+            if (m_chunk.size() >= CHUNK_BYTES) flushChunk();
+        }
+        batch.clear();
+
+        if (m_chunkCount > 0 && (stopping || m_chunkAge.elapsed() >= CHUNK_MAX_AGE_MS)) flushChunk();
+        if (stopping) break;
+    }
+    writeTrailer();
+    m_file.flush();
+}
+
+quint16 SessionRecorder::topicId(const QString &topic)
+{
+    if (topic.isEmpty()) return 0;
+    auto it = m_topicIds.constFind(topic);
+    if (it != m_topicIds.constEnd()) return it.value();
+    if (m_topicIds.size() >= 0xFFFF) return 0;
+
+    const quint16 id = quint16(m_topicIds.size() + 1);
+    m_topicIds.insert(topic, id);
+    const QByteArray name = topic.toUtf8();
+    putBlockHeader(m_topicBlocks, "TOPC", quint32(2 + name.size()));
+    putU16(m_topicBlocks, id);
+    m_topicBlocks.append(name);
+    return id;
+}
+
+void SessionRecorder::append(const Frame &frame)
+{
+    if (m_chunkCount == 0) {
+        m_chunkFirstUs = frame.receivedUs;
+        m_chunkAge.start();
+    }
+    m_chunkLastUs = frame.receivedUs;
+
+    const quint16 id = topicId(frame.topic);
+    TopicIndex &index = m_chunkIndex[id];
+    if (index.offsets.isEmpty()) index.firstUs = frame.receivedUs;
+    index.lastUs = frame.receivedUs;
+    index.offsets.append(quint32(m_chunk.size()));
+
+    putI64(m_chunk, frame.receivedUs);
+    putU8(m_chunk, frame.kind);
+    putU16(m_chunk, id);
+    putU32(m_chunk, quint32(frame.data.size()));
+    m_chunk.append(frame.data);
+    ++m_chunkCount;
+}
+
+// 依次写出新话题的 TOPC、CHNK 和它的 INDX：块头和索引拼在复用的 m_blockBuffer 中，
+// 帧内容直接从 m_chunk 写出，不再把整个块（约 4 MiB）复制到临时缓冲区
+void SessionRecorder::flushChunk()
+{
+    if (m_chunkCount == 0) return;
+
+    const quint64 start = quint64(m_file.pos());
+    m_blockBuffer.resize(0);
+    m_blockBuffer.append(m_topicBlocks);
+
+    ChunkInfo info;
+    info.chunkOffset = start + quint64(m_blockBuffer.size());
+    info.firstUs = m_chunkFirstUs;
+    info.lastUs = m_chunkLastUs;
+    info.count = m_chunkCount;
+
+    putBlockHeader(m_blockBuffer, "CHNK", quint32(4 + 8 + 8 + m_chunk.size()));
+    putU32(m_blockBuffer, m_chunkCount);
+    putI64(m_blockBuffer, m_chunkFirstUs);
+    putI64(m_blockBuffer, m_chunkLastUs);
+    info.indexOffset = start + quint64(m_blockBuffer.size()) + quint64(m_chunk.size());
+    bool ok = writeAll(m_blockBuffer) && writeAll(m_chunk);
+
+    m_blockBuffer.resize(0);
+    quint32 indexLength = 8 + 4;
+    for (auto it = m_chunkIndex.constBegin(); it != m_chunkIndex.constEnd(); ++it) {
+        indexLength += 2 + 4 + 8 + 8 + quint32(it->offsets.size()) * 4;
+    }
+    putBlockHeader(m_blockBuffer, "INDX", indexLength);
+    putU64(m_blockBuffer, info.chunkOffset);
+    putU32(m_blockBuffer, quint32(m_chunkIndex.size()));
+    for (auto it = m_chunkIndex.constBegin(); it != m_chunkIndex.constEnd(); ++it) {
+        putU16(m_blockBuffer, it.key());
+        putU32(m_blockBuffer, quint32(it->offsets.size()));
+        putI64(m_blockBuffer, it->firstUs);
+        putI64(m_blockBuffer, it->lastUs);
+        for (quint32 offset : it->offsets) putU32(m_blockBuffer, offset);
+    }
+    ok = ok && writeAll(m_blockBuffer);
+
+    if (ok) {
+        m_chunks.append(info);
+        m_framesWritten.fetchAndAddRelaxed(m_chunkCount);
+    }
+
+    // resize(0) 保留已分配的容量，下一个块不必重新分配 4 MiB
+    m_topicBlocks.resize(0);
+    m_chunk.resize(0);
+    m_chunkIndex.clear();
+    m_chunkCount = 0;
+}
+
+void SessionRecorder::writeTrailer()
+{
+    const quint64 trailerOffset = quint64(m_file.pos());
+    QByteArray out;
+    putBlockHeader(out, "TRLR", quint32(4 + m_chunks.size() * (8 + 8 + 8 + 8 + 4)));
+    putU32(out, quint32(m_chunks.size()));
+    for (const ChunkInfo &info : m_chunks) {
+        putU64(out, info.chunkOffset);
+        putU64(out, info.indexOffset);
+        putI64(out, info.firstUs);
+        putI64(out, info.lastUs);
+        putU32(out, info.count);
+    }
+    putU64(out, trailerOffset);
+    out.append("RBWEND01", 8);
+    writeAll(out);
+}
+
+bool SessionRecorder::writeAll(const QByteArray &bytes)
+{
+    if (m_writeFailed) return false;
+    if (m_file.write(bytes) != bytes.size()) {
+        qDebug() << "SessionRecorder: write failed," << m_file.errorString() << ", recording stopped";
+        m_writeFailed = true;
+        return false;
+    }
+    m_bytesWritten.fetchAndAddRelaxed(quint64(bytes.size()));
+    return true;
+}
@@ -0,0 +1,40 @@
+#include "socket_process/subscriptionregistry.h"
+
+bool SubscriptionRegistry::acquire(quint64 consumer, const QString &topic, const QString &type)
+{
+    if (topic.isEmpty()) return false;
+    // 后订阅的使用者给出了类型时以其为准，避免类型为空导致 cbor-raw 无法解码
+    if (!type.isEmpty() || !m_types.contains(topic)) {
+        m_types.insert(topic, type);
+    }
+    QSet<quint64> &consumers = m_consumers[topic];
+    const bool first = consumers.isEmpty();
+    consumers.insert(consumer);
+    return first;
+}
+
+bool SubscriptionRegistry::release(quint64 consumer, const QString &topic)
+{
+    auto it = m_consumers.find(topic);
+    if (it == m_consumers.end()) return false;
+    if (!it->remove(consumer)) return false;
+    if (!it->isEmpty()) return false;
+    m_consumers.erase(it);
+    m_types.remove(topic);
+    return true;
+}
+
+QStringList SubscriptionRegistry::releaseConsumer(quint64 consumer)
+{
+    QStringList released;
+    for (auto it = m_consumers.begin(); it != m_consumers.end();) {
+        if (it->remove(consumer) && it->isEmpty()) {
+            released.append(it.key());
+            m_types.remove(it.key());
+            it = m_consumers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return released;
+}
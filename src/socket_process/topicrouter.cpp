@@ -0,0 +1,148 @@
+#include "socket_process/topicrouter.h"
+#include "socket_process/jsonreader.h"
+#include "socket_process/decodeexecutor.h"
+#include "util/topicmetrics.h"
+#include "util/messagestamps.h"
+#include "util/tracerecorder.h"
+
+#include <QElapsedTimer>
+
+TopicRouter::TopicRouter(QObject *parent)
+    : QObject(parent)
+{
+    // 排队调用需要能按名字找到 RosMessage 类型
+    qRegisterMetaType<RosMessage>("RosMessage");
+}
+
+TopicRouter::~TopicRouter() {}
+
+// 注册话题处理对象（同一对象对同一话题只注册一次）
+void TopicRouter::addHandler(const QString &topic, QObject *receiver, const char *method)
+{
+    if (topic.isEmpty() || !receiver || !method) return;
+
+    QMutexLocker locker(&m_mutex);
+    QList<Handler> &list = m_handlers[topic];
+    for (const Handler &h : list) {
+        if (h.receiver == receiver && h.method == method) return;
+    }
+    list.append(Handler{receiver, QByteArray(method)});
+    if (list.size() == 1) publishTopics();
+
+    // 对象销毁时自动注销，避免向已删除的对象投递消息
+    if (!m_watched.contains(receiver)) {
+        m_watched.insert(receiver);
+        connect(receiver, &QObject::destroyed, this, [this](QObject *obj) {
+            removeReceiver(obj);
+            QMutexLocker l(&m_mutex);
+            m_watched.remove(obj);
+        }, Qt::DirectConnection);
+    }
+}
+
+void TopicRouter::removeReceiver(QObject *receiver)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        bool erased = false;
+        for (auto it = m_handlers.begin(); it != m_handlers.end();) {
+            QList<Handler> &list = it.value();
+            for (int i = list.size() - 1; i >= 0; --i) {
+                if (list[i].receiver == receiver) list.removeAt(i);
+            }
+            if (list.isEmpty()) {
+                it = m_handlers.erase(it);
+                erased = true;
+            } else {
+                ++it;
+            }
+        }
+        if (erased) publishTopics();
+    }
+    // 丢弃已提交但未执行的解码任务，并等待正在执行的结束
+    DecodeExecutor::instance().cancel(receiver);
+}
+
+void TopicRouter::publishTopics()
+{
+    auto topics = std::make_shared<TopicSnapshot>();
+    topics->names = m_handlers.keys();  // 先填满再取视图，之后不再修改
+    topics->entries.reserve(topics->names.size());
+    for (const QString &name : topics->names) {
+        topics->entries.insert(QStringView(name), TopicMetrics::instance().entry(name));
+    }
+    std::atomic_store(&m_topics, std::shared_ptr<const TopicSnapshot>(std::move(topics)));
+}
+
+TopicMetrics::Entry *TopicRouter::metrics(QStringView topic) const
+{
+    const std::shared_ptr<const TopicSnapshot> topics = std::atomic_load(&m_topics);
+    return topics->entries.value(topic, nullptr);
+}
+
+// 解析一次信封：在 UTF-8 字节上用 JsonReader 读出 op/topic，并记录 msg 字段的位置，不构建 QJsonObject
+void TopicRouter::route(const QString &message)
+{
+    routeUtf8(message.toUtf8());
+}
+
+void TopicRouter::routeUtf8(const QByteArray &json)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    RosMessage m;
+    m.receivedUs = MessageStamps::nowUs();
+    if (!parseEnvelope(json, &m)) return;
+    m.metrics = metrics(m.topic);
+    TopicMetrics::instance().recordTime(m.metrics, TopicMetrics::Parse, timer.nsecsElapsed());
+    dispatch(m);
+}
+
+bool TopicRouter::parseEnvelope(const QByteArray &json, RosMessage *out)
+{
+    TraceRecorder::Zone zone("router.parseEnvelope", json.size());
+    bool isPublish = false;
+    JsonReader reader(json);
+    if (!reader.beginObject()) return false;
+    QByteArrayView key;
+    while (reader.nextKey(&key)) {
+        if (JsonReader::equals(key, "op")) {
+            QByteArrayView op;
+            if (!reader.readString(&op)) return false;
+            if (!JsonReader::equals(op, "publish")) return false;
+            isPublish = true;
+        } else if (JsonReader::equals(key, "topic")) {
+            if (!reader.readString(&out->topic)) return false;
+        } else if (JsonReader::equals(key, "msg")) {
+            if (reader.peek() != JsonReader::Object) return false;
+            out->msgOffset = reader.offset();
+            if (!reader.skipValue()) return false;
+            out->msgLength = reader.offset() - out->msgOffset;
+        } else if (!reader.skipValue()) {
+            return false;
+        }
+    }
+    if (reader.hasError() || !isPublish || out->topic.isEmpty() || !out->hasJson()) return false;
+    out->json = json;
+    return true;
+}
+
+// 把消息作为解码任务交给 DecodeExecutor：同一处理对象的同一话题按到达顺序执行，其他话题在别的核上并行
+// 处理槽在线程池线程中被直接调用，不经过处理对象所在线程的事件循环
+void TopicRouter::dispatch(const RosMessage &m)
+{
+    RosMessage msg = m;
+    if (!msg.metrics) msg.metrics = metrics(msg.topic);
+    // 持锁投递：对象析构时 removeReceiver 会等待这里结束，再取消已投递的任务，之后不会再被访问
+    QMutexLocker locker(&m_mutex);
+    auto it = m_handlers.constFind(msg.topic);
+    if (it == m_handlers.constEnd()) return;
+    for (const Handler &h : it.value()) {
+        QObject *receiver = h.receiver;
+        const QByteArray method = h.method;
+        DecodeExecutor::instance().post(receiver, msg.topic, [receiver, method, msg]() {
+            QMetaObject::invokeMethod(receiver, method.constData(), Qt::DirectConnection, Q_ARG(RosMessage, msg));
+        });
+    }
+}
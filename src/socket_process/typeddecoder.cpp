@@ -0,0 +1,128 @@
+#include "socket_process/typeddecoder.h"
+#include "util/base64decoder.h"
+
+#include <QtNumeric>
+
+#include <cstring>
+
+// rosbridge 把 NaN/Inf 编码为 null（JSON 没有 NaN），浮点字段的 null 解码为 NaN，不让整条消息失败
+bool TypedDecoder::read(JsonReader &reader, double *out)
+{
+    if (reader.peek() == JsonReader::Null) {
+        *out = qQNaN();
+        return reader.readNull();
+    }
+    return reader.readDouble(out);
+}
+
+bool TypedDecoder::read(JsonReader &reader, qint64 *out)
+{
+    return reader.readInt(out);
+}
+
+bool TypedDecoder::read(JsonReader &reader, bool *out)
+{
+    return reader.readBool(out);
+}
+
+bool TypedDecoder::read(JsonReader &reader, QString *out)
+{
+    return reader.readString(out);
+}
+
+// uint8[]：rosbridge 默认编码为 base64 字符串，部分版本为整数数组
+bool TypedDecoder::read(JsonReader &reader, QByteArray *out)
+{
+    out->resize(0);
+    if (reader.peek() == JsonReader::String) {
+        QByteArrayView b64;
+        if (!reader.readString(&b64)) return false;
+        Base64Decoder::decode(b64, out);
+        return true;
+    }
+    return reader.readByteArray(out);
+}
+
+// base64 字符串按本机字节序的 double 数组解释
+static void doublesFromBytes(const QByteArray &bytes, QVector<double> *out)
+{
+    out->resize(bytes.size() / qsizetype(sizeof(double)));
+    std::memcpy(out->data(), bytes.constData(), size_t(out->size()) * sizeof(double));
+}
+
+bool TypedDecoder::read(JsonReader &reader, QVector<double> *out)
+{
+    out->resize(0);
+    if (reader.peek() == JsonReader::String) {
+        QByteArrayView b64;
+        if (!reader.readString(&b64)) return false;
+        QByteArray bytes;
+        Base64Decoder::decode(b64, &bytes);
+        doublesFromBytes(bytes, out);
+        return true;
+    }
+    return reader.readNumberArray(out);
+}
+
+bool TypedDecoder::read(const QJsonValue &value, double *out)
+{
+    if (value.isNull()) {
+        *out = qQNaN();
+        return true;
+    }
+    if (!value.isDouble()) return false;
+    *out = value.toDouble();
+    return true;
+}
+
+bool TypedDecoder::read(const QJsonValue &value, qint64 *out)
+{
+    if (!value.isDouble()) return false;
+    *out = value.toInteger();
+    return true;
+}
+
+bool TypedDecoder::read(const QJsonValue &value, bool *out)
+{
+    if (!value.isBool()) return false;
+    *out = value.toBool();
+    return true;
+}
+
+bool TypedDecoder::read(const QJsonValue &value, QString *out)
+{
+    if (!value.isString()) return false;
+    *out = value.toString();
+    return true;
+}
+
+bool TypedDecoder::read(const QJsonValue &value, QByteArray *out)
+{
+    out->resize(0);
+    if (value.isString()) {
+        Base64Decoder::decode(value.toString().toUtf8(), out);
+        return true;
+    }
+    if (!value.isArray()) return false;
+    const QJsonArray arr = value.toArray();
+    out->resize(arr.size());
+    char *o = out->data();
+    for (const QJsonValue &v : arr) *o++ = char(v.toInt() & 0xFF);
+    return true;
+}
+
+bool TypedDecoder::read(const QJsonValue &value, QVector<double> *out)
+{
+    out->resize(0);
+    if (value.isString()) {
+        QByteArray bytes;
+        Base64Decoder::decode(value.toString().toUtf8(), &bytes);
+        doublesFromBytes(bytes, out);
+        return true;
+    }
+    if (!value.isArray()) return false;
+    const QJsonArray arr = value.toArray();
+    out->reserve(arr.size());
+    for (const QJsonValue &v : arr) out->append(v.toDouble());
+    return true;
+}
@@ -1,8 +1,18 @@
 #include "socket_process/websocketworker.h"
+#include "util/load_param.hpp"
+#include "util/topicmetrics.h"
+#include "util/messagestamps.h"
+#include "util/tracerecorder.h"
+#include "socket_process/decodeexecutor.h"
+
+#include <QRandomGenerator>
+#include <QThreadPool>
 
 WebSocketWorker::WebSocketWorker(QObject *parent)
-    : QObject(parent), m_webSocket(nullptr), m_reconnectTimer(nullptr), m_isReconnecting(false), m_reconnectAttempts(0)
+    : QObject(parent), m_webSocket(nullptr), m_router(new TopicRouter(this)), m_reconnectTimer(nullptr), m_isReconnecting(false), m_reconnectAttempts(0)
 {
+    m_clockSync = new ClockSync(this);
+    m_unroutedMetrics = TopicMetrics::instance().entry(QStringLiteral("<unrouted>"));
 
 }
 
@@ -17,6 +27,20 @@ WebSocketWorker::~WebSocketWorker()
         m_reconnectTimer->deleteLater();
         m_reconnectTimer = nullptr;
     }
+    if (m_connectTimeoutTimer) {
+        m_connectTimeoutTimer->deleteLater();
+        m_connectTimeoutTimer = nullptr;
+    }
+    if (m_fragmentTimer) {
+        m_fragmentTimer->deleteLater();
+        m_fragmentTimer = nullptr;
+    }
+    if (m_serviceTimer) {
+        m_serviceTimer->deleteLater();
+        m_serviceTimer = nullptr;
+    }
+    m_services.failAll(QStringLiteral("worker destroyed"));
+    stopRecording();
 }
 // url 规范化处理
 static QUrl normalizeUrl(const QString &in)
@@ -27,6 +51,12 @@ static QUrl normalizeUrl(const QString &in)
     }
     return url;
 }
+// 重连退避：RECONNECT_BASE_MS * 2^n，上限 RECONNECT_MAX_MS，再乘以 [0.5, 1.0) 的随机抖动，
+// 避免多个客户端在机器人网络恢复时同时重连
+static const int RECONNECT_BASE_MS = 250;
+static const int RECONNECT_MAX_MS = 10000;
+static const int CONNECT_TIMEOUT_MS = 5000;
+
 // 初始化设置websocket和定时器
 void WebSocketWorker::init()
 {
@@ -36,79 +66,659 @@ void WebSocketWorker::init()
         connect(m_webSocket, &QWebSocket::connected, this, &WebSocketWorker::onConnected);
         connect(m_webSocket, &QWebSocket::disconnected, this, &WebSocketWorker::onDisconnected);
         connect(m_webSocket, &QWebSocket::textMessageReceived, this, &WebSocketWorker::onTextMessageReceived);
+        connect(m_webSocket, &QWebSocket::binaryMessageReceived, this, &WebSocketWorker::onBinaryMessageReceived);
         connect(m_webSocket, &QWebSocket::errorOccurred, this, &WebSocketWorker::onErrorOccurred);
     }
 
     if (!m_reconnectTimer) {
         m_reconnectTimer = new QTimer(this);
-        m_reconnectTimer->setInterval(3000);
         m_reconnectTimer->setSingleShot(true);
-        connect(m_reconnectTimer, &QTimer::timeout, this, [this]() {
-            if (!m_url.isEmpty() && m_webSocket) {
-                QUrl q = normalizeUrl(m_url);
-                qDebug() << "WebSocketWorker: reconnecting to" << q.toString();
-                m_webSocket->open(q);
-                m_reconnectAttempts++;
+        connect(m_reconnectTimer, &QTimer::timeout, this, &WebSocketWorker::openSocket);
+    }
+
+    if (!m_connectTimeoutTimer) {
+        m_connectTimeoutTimer = new QTimer(this);
+        m_connectTimeoutTimer->setInterval(CONNECT_TIMEOUT_MS);
+        m_connectTimeoutTimer->setSingleShot(true);
+        connect(m_connectTimeoutTimer, &QTimer::timeout, this, [this]() {
+            if (m_webSocket && m_state == Connecting) {
+                qDebug() << "WebSocketWorker: connect timed out";
+                m_webSocket->abort();
+                // abort 在未建立连接时不一定发出 disconnected，这里直接进入退避
+                scheduleReconnect();
             }
         });
     }
+
+    // 网络恢复（如 Wi-Fi 重连）时立即重试，不必等退避结束
+    if (QNetworkInformation::load(QNetworkInformation::Feature::Reachability)) {
+        QNetworkInformation *info = QNetworkInformation::instance();
+        connect(info, &QNetworkInformation::reachabilityChanged, this, &WebSocketWorker::onReachabilityChanged, Qt::UniqueConnection);
+    } else {
+        qDebug() << "WebSocketWorker: no network information backend, relying on backoff only";
+    }
+
+    initTimers();
 }
+
+// 分片清理和服务调用超时的定时器，在线和回放都需要
+void WebSocketWorker::initTimers()
+{
+    if (!m_fragmentTimer) {
+        m_fragmentTimer = new QTimer(this);
+        m_fragmentTimer->setInterval(1000);
+        connect(m_fragmentTimer, &QTimer::timeout, this, [this]() {
+            // 分片中不含话题名，超时丢弃的分片组统一记在 <fragment> 下
+            TopicMetrics::instance().recordDrop(QStringLiteral("<fragment>"), m_fragments.purgeExpired());
+        });
+        m_fragmentTimer->start();
+    }
+}
+// 回放：不打开 socket，按已连接处理，使用者照常订阅；帧由 ReplaySource 通过 injectFrame 注入
+void WebSocketWorker::beginReplay(const QString &name)
+{
+    qDebug() << "WebSocketWorker: replaying" << name << "on thread" << QThread::currentThread();
+    m_url = name;
+    m_isReconnecting = false;
+    initTimers();
+    m_state = Connected;
+    m_sessionTimer.start();
+    const QStringList topics = m_subscriptions.activeTopics();
+    m_awaitingFirst = QSet<QString>(topics.begin(), topics.end());
+    emit connected();
+}
+
+void WebSocketWorker::injectFrame(const QByteArray &frame, bool binary)
+{
+    if (binary) processBinaryFrame(frame);
+    else processTextFrame(QString::fromUtf8(frame));
+}
+
 // 从主线程调用，启动连接
 void WebSocketWorker::startConnect(const QString &url)
 {
     m_url = url;
     m_isReconnecting = true;
     m_reconnectAttempts = 0;
-    QUrl q = normalizeUrl(url);
-    qDebug() << "WebSocketWorker: startConnect" << q.toString() << " on thread " << QThread::currentThread();
+    qDebug() << "WebSocketWorker: startConnect" << normalizeUrl(url).toString() << " on thread " << QThread::currentThread();
     if (!m_webSocket) init();
-    if (m_webSocket) {
-        m_webSocket->open(q);
+    if (m_reconnectTimer) m_reconnectTimer->stop();
+    if (m_webSocket && m_webSocket->state() != QAbstractSocket::UnconnectedState) {
+        // 切换地址：先断开旧连接（此时不进入退避），再按新地址立即连接
+        m_isReconnecting = false;
+        m_webSocket->abort();
+        m_isReconnecting = true;
+    }
+    openSocket();
+}
+
+void WebSocketWorker::openSocket()
+{
+    if (!m_webSocket || m_url.isEmpty()) return;
+    if (m_webSocket->state() != QAbstractSocket::UnconnectedState) return;
+    QUrl q = normalizeUrl(m_url);
+    if (m_reconnectAttempts > 0) {
+        qDebug() << "WebSocketWorker: reconnecting to" << q.toString() << "attempt" << m_reconnectAttempts;
+    }
+    m_state = Connecting;
+    m_connectTimeoutTimer->start();
+    m_webSocket->open(q);
+}
+
+// 进入退避状态，按抖动指数退避安排下一次重连
+void WebSocketWorker::scheduleReconnect()
+{
+    if (m_connectTimeoutTimer) m_connectTimeoutTimer->stop();
+    if (!m_isReconnecting || !m_reconnectTimer) {
+        m_state = Disconnected;
+        return;
+    }
+    if (m_state == Backoff && m_reconnectTimer->isActive()) return;  // error 与 disconnected 都会走到这里
+
+    const int shift = qMin(m_reconnectAttempts, 16);
+    const qint64 ceiling = qMin<qint64>(RECONNECT_MAX_MS, qint64(RECONNECT_BASE_MS) << shift);
+    const int delay = int(ceiling / 2 + QRandomGenerator::global()->bounded(ceiling / 2 + 1));
+    m_reconnectAttempts++;
+    m_state = Backoff;
+    qDebug() << "WebSocketWorker: reconnect attempt" << m_reconnectAttempts << "in" << delay << "ms";
+    emit reconnecting(m_reconnectAttempts, delay);
+    m_reconnectTimer->start(delay);
+}
+
+// 网络由不可用变为可用时，跳过剩余退避时间立即重连
+void WebSocketWorker::onReachabilityChanged(QNetworkInformation::Reachability reachability)
+{
+    if (reachability != QNetworkInformation::Reachability::Online &&
+        reachability != QNetworkInformation::Reachability::Site) {
+        return;
+    }
+    if (m_state == Backoff && m_isReconnecting) {
+        qDebug() << "WebSocketWorker: network is up, reconnecting immediately";
+        m_reconnectTimer->stop();
+        m_reconnectAttempts = 0;
+        openSocket();
     }
 }
+
 // 断开连接
 void WebSocketWorker::closeConnection()
 {
     m_isReconnecting = false;
+    // 主动断开后不会再收到应答，在途的服务调用立即失败，排队中的请求不再发出
+    failServiceCalls(QStringLiteral("closed"));
+    // 已连接时先发出排队中的订阅变更（监视器销毁时的退订等），再退订仍活跃的话题，让 rosbridge 立即停止发送
+    if (isConnected()) {
+        const QList<Outgoing> &pending = m_sendQueues[SubscriptionPriority];
+        for (const Outgoing &o : pending) {
+            m_webSocket->sendTextMessage(o.text);
+        }
+        const QStringList topics = m_subscriptions.activeTopics();
+        for (const QString &topic : topics) {
+            QJsonObject unsub;
+            unsub["op"] = "unsubscribe";
+            unsub["topic"] = topic;
+            m_webSocket->sendTextMessage(QString::fromUtf8(QJsonDocument(unsub).toJson(QJsonDocument::Compact)));
+        }
+        qDebug() << "WebSocketWorker: closing, unsubscribed" << topics.size() << "topics";
+    }
+    // 其余未发送的消息丢弃，避免下次连接时执行过期命令
+    for (QList<Outgoing> &queue : m_sendQueues) queue.clear();
+    m_awaitingFirst.clear();
     if (m_reconnectTimer) {
         m_reconnectTimer->stop();
     }
+    if (m_connectTimeoutTimer) {
+        m_connectTimeoutTimer->stop();
+    }
+    m_state = Disconnected;
     if (m_webSocket) {
+        m_webSocket->flush();
         m_webSocket->close();
     }
 }
 
+// 各优先级消息在队列中的有效期（ms），超时未发出的消息丢弃，遥控命令过期后执行反而危险
+static const qint64 SEND_TTL_MS[WebSocketWorker::PriorityCount] = { 1000, 10000, 30000 };
+// 每个优先级队列的最大长度
+static const int MAX_QUEUE_LENGTH = 1000;
+// 单次 flush 最多发送的订阅类消息数，其余留到下一轮，让新到的遥控命令可以插队
+static const int MAX_BULK_PER_FLUSH = 16;
+
 void WebSocketWorker::sendText(const QString &text)
 {
-    if (m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState) {
-        m_webSocket->sendTextMessage(text);
+    enqueueText(text, ControlPriority);
+}
+
+void WebSocketWorker::enqueueText(const QString &text, int priority, const QString &coalesceKey)
+{
+    priority = qBound(0, priority, PriorityCount - 1);
+    QList<Outgoing> &queue = m_sendQueues[priority];
+
+    // 合并：同一 key 的旧消息尚未发出时，直接用新消息取代（保留原位置）
+    if (!coalesceKey.isEmpty()) {
+        for (Outgoing &o : queue) {
+            if (o.key == coalesceKey) {
+                o.text = text;
+                o.age.restart();
+                scheduleFlush();
+                return;
+            }
+        }
+    }
+    if (queue.size() >= MAX_QUEUE_LENGTH) {
+        qDebug() << "WebSocketWorker: send queue full, dropping oldest message, priority" << priority;
+        queue.removeFirst();
+    }
+    Outgoing o;
+    o.text = text;
+    o.key = coalesceKey;
+    o.age.start();
+    queue.append(o);
+    scheduleFlush();
+}
+
+// 同一轮事件循环内入队的消息合并到一次 flush 中，按优先级发送
+void WebSocketWorker::scheduleFlush()
+{
+    if (m_flushScheduled) return;
+    m_flushScheduled = true;
+    QTimer::singleShot(0, this, &WebSocketWorker::flushSendQueue);
+}
+
+void WebSocketWorker::flushSendQueue()
+{
+    m_flushScheduled = false;
+    if (!m_webSocket || m_webSocket->state() != QAbstractSocket::ConnectedState) {
+        // 未连接时保留在队列中，重连后再发送
+        return;
+    }
+    for (int p = 0; p < PriorityCount; ++p) {
+        QList<Outgoing> &queue = m_sendQueues[p];
+        int sent = 0;
+        while (!queue.isEmpty()) {
+            if (p == SubscriptionPriority && sent >= MAX_BULK_PER_FLUSH) {
+                scheduleFlush();
+                return;
+            }
+            Outgoing o = queue.takeFirst();
+            if (o.age.elapsed() > SEND_TTL_MS[p]) {
+                qDebug() << "WebSocketWorker: dropping expired message, priority" << p;
+                continue;
+            }
+            m_webSocket->sendTextMessage(o.text);
+            ++sent;
+        }
+    }
+}
+// 所有 subscribe 请求都由这里构建，按话题QoS填写 throttle_rate/queue_length/fragment_size/compression
+static QString buildSubscribeOp(const QString &topic, const QString &type, const TopicQos &qos)
+{
+    QJsonObject subscribeMsg;
+    subscribeMsg["op"] = "subscribe";
+    subscribeMsg["topic"] = topic;
+    if (!type.isEmpty()) subscribeMsg["type"] = type;
+    if (qos.throttle_rate > 0) subscribeMsg["throttle_rate"] = qos.throttle_rate;
+    if (qos.queue_length > 0) subscribeMsg["queue_length"] = qos.queue_length;
+    if (qos.fragment_size > 0) subscribeMsg["fragment_size"] = qos.fragment_size;
+    if (!qos.compression.isEmpty() && qos.compression != "none") subscribeMsg["compression"] = qos.compression;
+    QJsonDocument doc(subscribeMsg);
+    return QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+}
+
+bool WebSocketWorker::isConnected() const
+{
+    return m_webSocket && m_webSocket->state() == QAbstractSocket::ConnectedState;
+}
+
+void WebSocketWorker::sendSubscribe(const QString &topic)
+{
+    TopicQos qos = loadTopicQosFromConfig(topic);
+    qDebug() << "WebSocketWorker: subscribe" << topic << "throttle_rate" << qos.throttle_rate
+             << "queue_length" << qos.queue_length << "fragment_size" << qos.fragment_size
+             << "compression" << (qos.compression.isEmpty() ? QStringLiteral("none") : qos.compression);
+    enqueueText(buildSubscribeOp(topic, m_subscriptions.typeOf(topic), qos), SubscriptionPriority, QStringLiteral("sub:") + topic);
+}
+
+void WebSocketWorker::sendUnsubscribe(const QString &topic)
+{
+    qDebug() << "WebSocketWorker: unsubscribe" << topic;
+    QJsonObject unsub;
+    unsub["op"] = "unsubscribe";
+    unsub["topic"] = topic;
+    QJsonDocument doc(unsub);
+    enqueueText(QString::fromUtf8(doc.toJson(QJsonDocument::Compact)), SubscriptionPriority, QStringLiteral("sub:") + topic);
+}
+
+// 订阅话题：在使用者线程中把使用者换成编号，再排队到 worker 线程
+// 编号在使用者销毁时（destroyed 直接连接，仍在析构过程中）同步作废，同一地址上新建的对象会得到新编号；
+// 所有变更都经同一个事件队列按调用顺序执行，销毁前已排队的订阅请求也会在释放之前处理
+void WebSocketWorker::subscribeTopic(QObject *consumer, const QString &topic, const QString &type)
+{
+    if (!consumer || topic.isEmpty()) return;
+    quint64 id = 0;
+    {
+        QMutexLocker locker(&m_consumerMutex);
+        id = m_consumerIds.value(consumer);
+        if (!id) {
+            id = m_nextConsumerId++;
+            m_consumerIds.insert(consumer, id);
+            connect(consumer, &QObject::destroyed, this, [this](QObject *obj) {
+                unsubscribeAll(obj);
+            }, Qt::DirectConnection);
+        }
+    }
+    QMetaObject::invokeMethod(this, [this, id, topic, type]() {
+        acquireTopic(id, topic, type);
+    }, Qt::QueuedConnection);
+}
+
+void WebSocketWorker::unsubscribeTopic(QObject *consumer, const QString &topic)
+{
+    if (!consumer || topic.isEmpty()) return;
+    quint64 id = 0;
+    {
+        QMutexLocker locker(&m_consumerMutex);
+        id = m_consumerIds.value(consumer);
+    }
+    if (!id) return;
+    QMetaObject::invokeMethod(this, [this, id, topic]() {
+        releaseTopic(id, topic);
+    }, Qt::QueuedConnection);
+}
+
+void WebSocketWorker::unsubscribeAll(QObject *consumer)
+{
+    if (!consumer) return;
+    quint64 id = 0;
+    {
+        QMutexLocker locker(&m_consumerMutex);
+        id = m_consumerIds.take(consumer);
+    }
+    if (!id) return;
+    disconnect(consumer, &QObject::destroyed, this, nullptr);
+    QMetaObject::invokeMethod(this, [this, id]() {
+        releaseConsumer(id);
+    }, Qt::QueuedConnection);
+}
+
+void WebSocketWorker::acquireTopic(quint64 consumerId, const QString &topic, const QString &type)
+{
+    if (m_subscriptions.acquire(consumerId, topic, type)) {
+        DecodeExecutor::instance().setMaxPending(topic, loadTopicQosFromConfig(topic).decode_queue);
+        if (isConnected()) sendSubscribe(topic);
     } else {
-        qDebug() << "WebSocketWorker: cannot send, socket not connected";
+        qDebug() << "WebSocketWorker:" << topic << "already subscribed, consumers:" << m_subscriptions.consumerCount(topic);
     }
 }
-// 连接成功
+
+// 取消订阅：仍有其他使用者时不发送 unsubscribe，避免影响其他窗口的同一话题
+void WebSocketWorker::releaseTopic(quint64 consumerId, const QString &topic)
+{
+    if (m_subscriptions.release(consumerId, topic)) {
+        if (isConnected()) sendUnsubscribe(topic);
+    }
+}
+
+void WebSocketWorker::releaseConsumer(quint64 consumerId)
+{
+    const QStringList released = m_subscriptions.releaseConsumer(consumerId);
+    if (!isConnected()) return;
+    for (const QString &topic : released) {
+        sendUnsubscribe(topic);
+    }
+}
+
+// 新连接上 rosbridge 没有任何订阅：丢弃上次连接遗留的订阅请求，按注册表重放
+// 断线期间发起的服务调用仍在途，照常发出；已结束（超时等）的调用请求丢弃
+void WebSocketWorker::resubscribeAll()
+{
+    QList<Outgoing> &queue = m_sendQueues[SubscriptionPriority];
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (it->key.startsWith(QLatin1String("sub:"))) it = queue.erase(it);
+        else if (it->key.startsWith(QLatin1String("call:")) && !m_services.isPending(it->key.mid(5))) it = queue.erase(it);
+        else ++it;
+    }
+    const QStringList topics = m_subscriptions.activeTopics();
+    qDebug() << "WebSocketWorker: resubscribing" << topics.size() << "topics";
+    for (const QString &topic : topics) {
+        sendSubscribe(topic);
+    }
+}
+
+// 连接成功：立即重放全部订阅（不等待应答，按发送队列流水线发出），并开始统计各话题首条消息耗时
 void WebSocketWorker::onConnected()
 {
-    qDebug() << "WebSocketWorker: onConnected on thread" << QThread::currentThread();
-    m_isReconnecting = false;
+    qDebug() << "WebSocketWorker: onConnected on thread" << QThread::currentThread()
+             << "after" << m_reconnectAttempts << "retries";
     if (m_reconnectTimer) {
         m_reconnectTimer->stop();
     }
+    if (m_connectTimeoutTimer) {
+        m_connectTimeoutTimer->stop();
+    }
+    m_reconnectAttempts = 0;
+    m_state = Connected;
+    m_sessionTimer.start();
+    const QStringList topics = m_subscriptions.activeTopics();
+    m_awaitingFirst = QSet<QString>(topics.begin(), topics.end());
+    resubscribeAll();
+    // 发送断线期间缓存的消息
+    scheduleFlush();
+    // 重新估计与机器人的时钟偏差（机器人可能已重启）
+    m_clockSync->start();
     emit connected();
 }
+// 服务调用以失败结束后，其请求即使之后发出，应答也没有人接收
+void WebSocketWorker::failServiceCalls(const QString &error)
+{
+    m_services.failAll(error);
+    QList<Outgoing> &queue = m_sendQueues[SubscriptionPriority];
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (it->key.startsWith(QLatin1String("call:"))) it = queue.erase(it);
+        else ++it;
+    }
+}
+
 // 连接断开
 void WebSocketWorker::onDisconnected()
 {
     qDebug() << "WebSocketWorker: onDisconnected";
+    m_awaitingFirst.clear();
+    m_clockSync->stop();
+    // 断线后不会再收到应答，在途的服务调用立即失败，调用方不必等到超时
+    failServiceCalls(QStringLiteral("disconnected"));
     emit disconnected();
-    if (m_isReconnecting) {
-        m_reconnectTimer->start();
+    scheduleReconnect();
+}
+
+// 记录连接建立后每个话题第一条消息的到达耗时，用于跟踪断线恢复延迟
+void WebSocketWorker::noteFirstMessage(QStringView topic)
+{
+    if (m_awaitingFirst.isEmpty() || topic.isEmpty()) return;
+    const QString key = topic.toString();
+    if (!m_awaitingFirst.remove(key)) return;
+    const qint64 ms = m_sessionTimer.elapsed();
+    qDebug() << "WebSocketWorker: first message on" << key << "after" << ms << "ms";
+    TopicMetrics &metrics = TopicMetrics::instance();
+    metrics.recordResume(metrics.entry(key), ms);
+    if (m_awaitingFirst.isEmpty()) {
+        qDebug() << "WebSocketWorker: all subscriptions resumed after" << ms << "ms";
+        metrics.recordResume(metrics.entry(QStringLiteral("<session>")), ms);
     }
 }
-// 从QWebSocket接收到消息时，直接把原始消息发回主线程，由主线程处理 JSON/UI 更新
+
+// 从QWebSocket接收到的原始帧：录制中时先交给录制器（只入队，不写盘）
 void WebSocketWorker::onTextMessageReceived(const QString &message)
 {
-    emit messageReceived(message);
+    if (m_recorder) {
+        QStringView op, topic;
+        EnvelopePrefilter::peek(message, &op, &topic);
+        m_recorder->record(SessionRecorder::TextFrame, MessageStamps::nowUs(), topic.toString(), message.toUtf8());
+    }
+    processTextFrame(message);
+}
+
+void WebSocketWorker::onBinaryMessageReceived(const QByteArray &message)
+{
+    if (m_recorder) {
+        QLatin1String op, topic;
+        EnvelopePrefilter::peekCbor(message, &op, &topic);
+        m_recorder->record(SessionRecorder::BinaryFrame, MessageStamps::nowUs(), QString(topic), message);
+    }
+    processBinaryFrame(message);
+}
+
+void WebSocketWorker::startRecording(const QString &path)
+{
+    stopRecording();
+    SessionRecorder *recorder = new SessionRecorder();
+    if (!recorder->start(path, m_url)) {
+        delete recorder;
+        emit recordingChanged(false, path);
+        return;
+    }
+    m_recorder = recorder;
+    emit recordingChanged(true, path);
+}
+
+// 停止时要等写线程写完最后一块，放到线程池中进行
+void WebSocketWorker::stopRecording()
+{
+    if (!m_recorder) return;
+    SessionRecorder *recorder = m_recorder;
+    m_recorder = nullptr;
+    const QString path = recorder->path();
+    QThreadPool::globalInstance()->start([recorder]() { delete recorder; });
+    emit recordingChanged(false, path);
+}
+
+// 先用预过滤读出 op/topic，没有处理对象的话题直接丢弃，
+// 其余消息由路由器解析一次信封并分发给对应话题的监视器
+void WebSocketWorker::processTextFrame(const QString &message)
+{
+    TraceRecorder::Zone zone("socket.textFrame", message.size());
+    QStringView op, topic;
+    if (EnvelopePrefilter::peek(message, &op, &topic)) {
+        if (op == QLatin1String("fragment")) {
+            handleFragment(message);
+            return;
+        }
+        if (op == QLatin1String("png")) {
+            handlePng(message);
+            return;
+        }
+        if (op == QLatin1String("service_response")) {
+            handleServiceResponse(message);
+            return;
+        }
+        if (op == QLatin1String("publish") && !topic.isEmpty()) {
+            noteFirstMessage(topic);
+            // JSON 基本为 ASCII，按字符数近似字节数
+            if (!recordReceived(topic, message.size())) return;
+        }
+    }
+    m_router->route(message);
+}
+
+// 分片消息：{"op": "fragment", "id": ..., "data": ..., "num": ..., "total": ...}
+bool WebSocketWorker::handleFragment(const QString &message)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    if (!doc.isObject()) return false;
+    QJsonObject obj = doc.object();
+    if (obj.value("op").toString() != "fragment") return false;
+
+    QString complete;
+    if (m_fragments.add(obj.value("id").toVariant().toString(), obj.value("num").toInt(-1),
+                        obj.value("total").toInt(-1), obj.value("data").toString(), &complete)) {
+        processTextFrame(complete);
+    }
+    return true;
+}
+
+// 服务调用：调用方线程中创建 promise，请求的登记和发送都在 socket 线程中进行
+QFuture<ServiceResponse> WebSocketWorker::callService(const QString &service, const QJsonObject &args, int timeoutMs)
+{
+    // promise 未经 ServiceCaller 结束就被释放（worker 线程已停止、排队的请求随 worker 销毁）时以失败结束，
+    // 否则 future 只会被取消，调用方的 then 回调永远不会执行
+    ServiceCaller::Promise promise(new QPromise<ServiceResponse>(), [service](QPromise<ServiceResponse> *p) {
+        if (!p->future().isFinished()) {
+            ServiceResponse r;
+            r.service = service;
+            r.error = QStringLiteral("worker stopped");
+            p->addResult(r);
+            p->finish();
+        }
+        delete p;
+    });
+    QFuture<ServiceResponse> future = promise->future();
+    promise->start();
+    QMetaObject::invokeMethod(this, [this, promise, service, args, timeoutMs]() {
+        startServiceCall(promise, service, args, timeoutMs);
+    }, Qt::QueuedConnection);
+    return future;
+}
+
+void WebSocketWorker::callService(const QString &service, const QJsonObject &args, QObject *context,
+                                  std::function<void(const ServiceResponse &)> callback, int timeoutMs)
+{
+    if (!context || !callback) {
+        callService(service, args, timeoutMs);
+        return;
+    }
+    callService(service, args, timeoutMs).then(context, [callback](const ServiceResponse &response) {
+        callback(response);
+    }).onCanceled(context, [callback, service]() {
+        ServiceResponse r;
+        r.service = service;
+        r.error = QStringLiteral("cancelled");
+        callback(r);
+    });
+}
+
+// 请求与订阅类消息同级入队：批量查询（如逐个查话题类型）时遥控命令仍可插队
+void WebSocketWorker::startServiceCall(const ServiceCaller::Promise &promise, const QString &service, const QJsonObject &args, int timeoutMs)
+{
+    QString request;
+    const QString id = m_services.add(service, args, timeoutMs, promise, &request);
+    // 合并键按请求 id 区分，不会合并不同的调用；断线或关闭时按前缀从队列中移除
+    enqueueText(request, SubscriptionPriority, QStringLiteral("call:") + id);
+    // 定时器在第一个请求时创建，init() 之前发出的请求同样会超时
+    if (!m_serviceTimer) {
+        m_serviceTimer = new QTimer(this);
+        m_serviceTimer->setInterval(50);
+        connect(m_serviceTimer, &QTimer::timeout, this, [this]() {
+            m_services.expire();
+            if (m_services.pendingCount() == 0) m_serviceTimer->stop();
+        });
+    }
+    if (!m_serviceTimer->isActive()) m_serviceTimer->start();
+}
+
+void WebSocketWorker::handleServiceResponse(const QString &message)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    if (!doc.isObject()) return;
+    if (!m_services.complete(doc.object())) {
+        qDebug() << "WebSocketWorker: service_response without pending call, id" << doc.object().value("id").toString();
+    }
+}
+
+// png 压缩消息：{"op": "png", "data": <base64 PNG>}，还原出 JSON 文本后按普通文本帧处理
+// 还原前不知道话题名，解码耗时和失败统一记在 <png> 下
+bool WebSocketWorker::handlePng(const QString &message)
+{
+    QString json;
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = PngDecoder::decode(message, &json);
+    TopicMetrics::instance().recordTime(QStringLiteral("<png>"), TopicMetrics::Parse, timer.nsecsElapsed());
+    if (!ok) {
+        TopicMetrics::instance().recordDrop(QStringLiteral("<png>"));
+        return false;
+    }
+    processTextFrame(json);
+    return true;
+}
+
+// 记录收到的 publish 帧；话题没有处理对象时记为丢弃并返回 false（预过滤）
+// 有处理对象的话题从路由器的快照取得统计项，不加锁；没有处理对象的话题统一记在 <unrouted> 下，
+// 不按话题名建统计项（避免每个未知话题都在全局锁下创建一项）
+bool WebSocketWorker::recordReceived(QStringView topic, qint64 bytes)
+{
+    TopicMetrics &metrics = TopicMetrics::instance();
+    if (TopicMetrics::Entry *entry = m_router->metrics(topic)) {
+        metrics.recordReceived(entry, bytes);
+        return true;
+    }
+    metrics.recordReceived(m_unroutedMetrics, bytes);
+    metrics.recordDrop(m_unroutedMetrics);
+    return false;
+}
+
+// 二进制帧（cbor/cbor-raw），解码后 msg.data 的原始字节直接交给监视器
+void WebSocketWorker::processBinaryFrame(const QByteArray &message)
+{
+    TraceRecorder::Zone zone("socket.binaryFrame", message.size());
+    QLatin1String op, topic;
+    if (EnvelopePrefilter::peekCbor(message, &op, &topic)) {
+        if (op != QLatin1String("publish")) return;
+        if (!topic.isEmpty()) {
+            const QString name(topic);
+            noteFirstMessage(name);
+            if (!recordReceived(name, message.size())) return;
+        }
+    }
+
+    RosMessage m;
+    m.receivedUs = MessageStamps::nowUs();
+    QElapsedTimer timer;
+    timer.start();
+    if (CborDecoder::decode(message, m_subscriptions.topicTypes(), &m)) {
+        m.metrics = m_router->metrics(m.topic);
+        TopicMetrics::instance().recordTime(m.metrics, TopicMetrics::Parse, timer.nsecsElapsed());
+        m_router->dispatch(m);
+    }
 }
 
 void WebSocketWorker::onErrorOccurred(QAbstractSocket::SocketError error)
@@ -117,4 +727,8 @@ void WebSocketWorker::onErrorOccurred(QAbstractSocket::SocketError error)
     QString err = m_webSocket ? m_webSocket->errorString() : QString("unknown");
     qDebug() << "WebSocketWorker: error:" << err;
     emit errorOccurred(err);
+    // 连接尝试失败时不一定会发出 disconnected
+    if (m_webSocket && m_webSocket->state() == QAbstractSocket::UnconnectedState) {
+        scheduleReconnect();
+    }
 }
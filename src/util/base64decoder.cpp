@@ -0,0 +1,231 @@
+#include "util/base64decoder.h"
+#include "util/tracerecorder.h"
+
+#if defined(Q_PROCESSOR_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define BASE64_HAVE_X86 1
+#endif
+
+// GCC/Clang 需要按函数开启指令集，整个工程不必加 -mavx2；MSVC 可直接使用内建函数
+#if defined(BASE64_HAVE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BASE64_TARGET_SSE41 __attribute__((target("ssse3,sse4.1")))
+#define BASE64_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BASE64_TARGET_SSE41
+#define BASE64_TARGET_AVX2
+#endif
+
+namespace {
+
+enum : quint8 {
+    Skip = 0x80,    // 非字母表字符，跳过
+    Pad = 0x81      // '='，结束
+};
+
+struct DecodeTable
+{
+    quint8 v[256];
+    DecodeTable()
+    {
+        for (int i = 0; i < 256; ++i) v[i] = Skip;
+        const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i) v[quint8(alphabet[i])] = quint8(i);
+        v[quint8('=')] = Pad;
+    }
+};
+
+const DecodeTable TABLE;
+
+// 查表解码，直到凑满一组 4 个字符（返回 true，可回到 SIMD 循环）或遇到 '='/输入结束（返回 false）
+bool decodeQuantum(const char **srcp, const char *end, char **dstp, bool *finished)
+{
+    const char *p = *srcp;
+    char *o = *dstp;
+    quint32 acc = 0;
+    int n = 0;
+    while (p < end) {
+        const quint8 c = TABLE.v[quint8(*p++)];
+        if (c == Skip) continue;
+        if (c == Pad) {
+            p = end;
+            break;
+        }
+        acc = (acc << 6) | c;
+        if (++n == 4) {
+            o[0] = char(acc >> 16);
+            o[1] = char(acc >> 8);
+            o[2] = char(acc);
+            *srcp = p;
+            *dstp = o + 3;
+            return true;
+        }
+    }
+    // 末尾不足 4 个字符：2 个字符得 1 字节，3 个字符得 2 字节
+    if (n == 2) {
+        *o++ = char(acc >> 4);
+    } else if (n == 3) {
+        *o++ = char(acc >> 10);
+        *o++ = char(acc >> 2);
+    }
+    *srcp = end;
+    *dstp = o;
+    *finished = true;
+    return false;
+}
+
+#if defined(BASE64_HAVE_X86)
+
+// 字符 -> 6 位值的向量化转换（按高/低半字节查表判断合法性并求偏移），再把 4 个 6 位值拼成 3 字节
+// 遇到不在字母表内的字符（包括 '='）时停下，由查表实现处理
+
+BASE64_TARGET_SSE41
+void decodeSse41(const char **srcp, const char *end, char **dstp)
+{
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                          0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask2F = _mm_set1_epi8(0x2F);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    const char *p = *srcp;
+    char *o = *dstp;
+    // 每次写 16 字节（有效 12 字节），剩余输入不少于 24 个字符时输出缓冲区一定放得下
+    while (end - p >= 24) {
+        __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask2F);
+        const __m128i lo = _mm_shuffle_epi8(lutLo, _mm_and_si128(str, mask2F));
+        const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+        if (!_mm_testz_si128(lo, hi)) break;
+        const __m128i eq2F = _mm_cmpeq_epi8(str, mask2F);
+        str = _mm_add_epi8(str, _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles)));
+
+        const __m128i mergeAB = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        const __m128i merged = _mm_madd_epi16(mergeAB, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(merged, pack));
+        p += 16;
+        o += 12;
+    }
+    *srcp = p;
+    *dstp = o;
+}
+
+BASE64_TARGET_AVX2
+void decodeAvx2(const char **srcp, const char *end, char **dstp)
+{
+    const __m256i lutLo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                           0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                           0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                           0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lutHi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                           0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                           0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                           0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                             0, 0, 0, 0, 0, 0, 0, 0,
+                                             0, 16, 19, 4, -65, -65, -71, -71,
+                                             0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask2F = _mm256_set1_epi8(0x2F);
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+    const char *p = *srcp;
+    char *o = *dstp;
+    // 每次写 32 字节（有效 24 字节），剩余输入不少于 44 个字符时输出缓冲区一定放得下
+    while (end - p >= 44) {
+        __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2F);
+        const __m256i lo = _mm256_shuffle_epi8(lutLo, _mm256_and_si256(str, mask2F));
+        const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+        if (!_mm256_testz_si256(lo, hi)) break;
+        const __m256i eq2F = _mm256_cmpeq_epi8(str, mask2F);
+        str = _mm256_add_epi8(str, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eq2F, hiNibbles)));
+
+        const __m256i mergeAB = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        __m256i merged = _mm256_madd_epi16(mergeAB, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, pack);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), _mm256_permutevar8x32_epi32(merged, lanes));
+        p += 32;
+        o += 24;
+    }
+    *srcp = p;
+    *dstp = o;
+}
+
+enum Backend { Scalar, Sse41, Avx2 };
+
+Backend detectBackend()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Avx2;
+    if (__builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3")) return Sse41;
+    return Scalar;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    // AVX2 还需要操作系统保存 YMM 寄存器（OSXSAVE + XCR0）
+    const bool osYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    if (maxLeaf >= 7 && osYmm) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) return Avx2;
+    }
+    return (ssse3 && sse41) ? Sse41 : Scalar;
+#else
+    return Scalar;
+#endif
+}
+
+const Backend BACKEND = detectBackend();
+
+#endif // BASE64_HAVE_X86
+
+} // namespace
+
+qsizetype Base64Decoder::decode(const char *src, qsizetype length, char *dst)
+{
+    const char *p = src;
+    const char *end = src + length;
+    char *o = dst;
+    bool finished = false;
+    while (!finished) {
+#if defined(BASE64_HAVE_X86)
+        if (BACKEND == Avx2) decodeAvx2(&p, end, &o);
+        if (BACKEND != Scalar) decodeSse41(&p, end, &o);
+#endif
+        // SIMD 停下的位置（非法字符、'=' 或剩余不足一个向量）交给查表实现处理一组后再继续
+        decodeQuantum(&p, end, &o, &finished);
+    }
+    return o - dst;
+}
+
+qsizetype Base64Decoder::decode(QByteArrayView src, QByteArray *out)
+{
+    TraceRecorder::Zone zone("base64.decode", src.size());
+    out->resize(maxDecodedSize(src.size()));
+    const qsizetype n = decode(src.data(), src.size(), out->data());
+    out->resize(n);     // 缩小不释放容量，下一帧复用
+    return n;
+}
+
+const char *Base64Decoder::backend()
+{
+#if defined(BASE64_HAVE_X86)
+    switch (BACKEND) {
+    case Avx2: return "avx2";
+    case Sse41: return "sse4.1";
+    default: break;
+    }
+#endif
+    return "scalar";
+}
@@ -0,0 +1,252 @@
+#include "util/topicmetrics.h"
+
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+
+// 每个话题每类样本保留的最近样本数
+static const int SAMPLE_CAPACITY = 512;
+
+// 固定容量的最近样本，用于计算分位数；多个线程可同时写入，各自占用不同的槽位
+struct SampleRing {
+    std::atomic<qint64> values[SAMPLE_CAPACITY] {};
+    std::atomic<quint64> next{0};      // 累计写入数
+
+    void add(qint64 v)
+    {
+        const quint64 i = next.fetch_add(1, std::memory_order_relaxed);
+        values[i % SAMPLE_CAPACITY].store(v, std::memory_order_relaxed);
+    }
+
+    void percentiles(qint64 *p50, qint64 *p99) const
+    {
+        const int n = int(qMin<quint64>(next.load(std::memory_order_relaxed), SAMPLE_CAPACITY));
+        if (n == 0) {
+            *p50 = *p99 = 0;
+            return;
+        }
+        QVector<qint64> sorted(n);
+        for (int i = 0; i < n; ++i) sorted[i] = values[i].load(std::memory_order_relaxed);
+        std::sort(sorted.begin(), sorted.end());
+        *p50 = sorted[(n - 1) * 50 / 100];
+        *p99 = sorted[(n - 1) * 99 / 100];
+    }
+
+    void reset() { next.store(0, std::memory_order_relaxed); }
+};
+
+struct TopicMetrics::Entry {
+    QString topic;
+    std::atomic<quint64> messages{0};
+    std::atomic<quint64> bytes{0};
+    std::atomic<quint64> drops{0};
+    std::atomic<quint64> skipped{0};
+    std::atomic<qint64> second{-1};         // 当前计数窗口（秒）
+    std::atomic<quint64> windowMessages{0};
+    std::atomic<quint64> windowBytes{0};
+    std::atomic<quint64> lastMessages{0};   // 上一个完整秒的计数
+    std::atomic<quint64> lastBytes{0};
+    SampleRing sizes;
+    SampleRing parseNs;
+    SampleRing decodeNs;
+    SampleRing transportNs;
+    SampleRing endToEndNs;
+    std::atomic<quint64> transportSamples{0};
+    std::atomic<quint64> endToEndSamples{0};
+    std::atomic<qint64> resumeMs{-1};
+};
+
+TopicMetrics &TopicMetrics::instance()
+{
+    static TopicMetrics metrics;
+    return metrics;
+}
+
+TopicMetrics::TopicMetrics()
+{
+    m_clock.start();
+}
+
+TopicMetrics::Entry *TopicMetrics::entry(const QString &topic)
+{
+    QMutexLocker locker(&m_mutex);
+    Entry *&e = m_entries[topic];
+    if (!e) {
+        e = new Entry;
+        e->topic = topic;
+    }
+    return e;
+}
+
+// 进入新的一秒时，把上一秒的计数保存为速率；中间空了一秒以上则速率为 0
+// 只有把 second 换成新值的线程负责切换；切换期间其他线程的少量计数可能记到相邻的一秒，对速率统计可以忽略
+void TopicMetrics::roll(Entry &e, qint64 second)
+{
+    qint64 current = e.second.load(std::memory_order_relaxed);
+    while (current < second) {
+        if (!e.second.compare_exchange_weak(current, second, std::memory_order_relaxed)) continue;
+        const quint64 messages = e.windowMessages.exchange(0, std::memory_order_relaxed);
+        const quint64 bytes = e.windowBytes.exchange(0, std::memory_order_relaxed);
+        const bool consecutive = current == second - 1;
+        e.lastMessages.store(consecutive ? messages : 0, std::memory_order_relaxed);
+        e.lastBytes.store(consecutive ? bytes : 0, std::memory_order_relaxed);
+        return;
+    }
+}
+
+void TopicMetrics::recordReceived(Entry *e, qint64 bytes)
+{
+    if (!e) return;
+    roll(*e, m_clock.elapsed() / 1000);
+    e->messages.fetch_add(1, std::memory_order_relaxed);
+    e->bytes.fetch_add(quint64(bytes), std::memory_order_relaxed);
+    e->windowMessages.fetch_add(1, std::memory_order_relaxed);
+    e->windowBytes.fetch_add(quint64(bytes), std::memory_order_relaxed);
+    e->sizes.add(bytes);
+}
+
+void TopicMetrics::recordTime(Entry *e, Stage stage, qint64 nsecs)
+{
+    if (!e) return;
+    switch (stage) {
+    case Parse: e->parseNs.add(nsecs); break;
+    case Decode: e->decodeNs.add(nsecs); break;
+    case Transport:
+        e->transportNs.add(nsecs);
+        e->transportSamples.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case EndToEnd:
+        e->endToEndNs.add(nsecs);
+        e->endToEndSamples.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+}
+
+void TopicMetrics::recordDrop(Entry *e, int count)
+{
+    if (!e || count <= 0) return;
+    e->drops.fetch_add(quint64(count), std::memory_order_relaxed);
+}
+
+void TopicMetrics::recordSkip(Entry *e, int count)
+{
+    if (!e || count <= 0) return;
+    e->skipped.fetch_add(quint64(count), std::memory_order_relaxed);
+}
+
+void TopicMetrics::recordResume(Entry *e, qint64 ms)
+{
+    if (!e || ms < 0) return;
+    e->resumeMs.store(ms, std::memory_order_relaxed);
+}
+
+void TopicMetrics::recordReceived(const QString &topic, qint64 bytes)
+{
+    if (topic.isEmpty()) return;
+    recordReceived(entry(topic), bytes);
+}
+
+void TopicMetrics::recordTime(const QString &topic, Stage stage, qint64 nsecs)
+{
+    if (topic.isEmpty()) return;
+    recordTime(entry(topic), stage, nsecs);
+}
+
+void TopicMetrics::recordDrop(const QString &topic, int count)
+{
+    if (topic.isEmpty() || count <= 0) return;
+    recordDrop(entry(topic), count);
+}
+
+TopicStats TopicMetrics::toStats(const Entry &e, qint64 second)
+{
+    TopicStats s;
+    s.topic = e.topic;
+    s.messages = e.messages.load(std::memory_order_relaxed);
+    s.bytes = e.bytes.load(std::memory_order_relaxed);
+    s.drops = e.drops.load(std::memory_order_relaxed);
+    s.skipped = e.skipped.load(std::memory_order_relaxed);
+    s.resumeMs = e.resumeMs.load(std::memory_order_relaxed);
+    // 只读快照，不修改计数窗口：当前秒刚开始时使用上一秒的值
+    const qint64 window = e.second.load(std::memory_order_relaxed);
+    if (window == second) {
+        s.msgsPerSec = double(e.lastMessages.load(std::memory_order_relaxed));
+        s.bytesPerSec = double(e.lastBytes.load(std::memory_order_relaxed));
+    } else if (window == second - 1) {
+        s.msgsPerSec = double(e.windowMessages.load(std::memory_order_relaxed));
+        s.bytesPerSec = double(e.windowBytes.load(std::memory_order_relaxed));
+    }
+    e.sizes.percentiles(&s.sizeP50, &s.sizeP99);
+    qint64 p50 = 0, p99 = 0;
+    e.parseNs.percentiles(&p50, &p99);
+    s.parseUsP50 = p50 / 1000.0;
+    s.parseUsP99 = p99 / 1000.0;
+    e.decodeNs.percentiles(&p50, &p99);
+    s.decodeUsP50 = p50 / 1000.0;
+    s.decodeUsP99 = p99 / 1000.0;
+    e.transportNs.percentiles(&p50, &p99);
+    s.transportMsP50 = p50 / 1e6;
+    s.transportMsP99 = p99 / 1e6;
+    e.endToEndNs.percentiles(&p50, &p99);
+    s.endToEndMsP50 = p50 / 1e6;
+    s.endToEndMsP99 = p99 / 1e6;
+    s.transportSamples = e.transportSamples.load(std::memory_order_relaxed);
+    s.endToEndSamples = e.endToEndSamples.load(std::memory_order_relaxed);
+    return s;
+}
+
+QList<TopicStats> TopicMetrics::snapshot() const
+{
+    const qint64 second = m_clock.elapsed() / 1000;
+    QList<TopicStats> out;
+    {
+        QMutexLocker locker(&m_mutex);
+        out.reserve(m_entries.size());
+        for (const Entry *e : m_entries) {
+            out.append(toStats(*e, second));
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const TopicStats &a, const TopicStats &b) {
+        return a.topic < b.topic;
+    });
+    return out;
+}
+
+TopicStats TopicMetrics::stats(const QString &topic) const
+{
+    const qint64 second = m_clock.elapsed() / 1000;
+    QMutexLocker locker(&m_mutex);
+    const Entry *e = m_entries.value(topic);
+    if (!e) {
+        TopicStats s;
+        s.topic = topic;
+        return s;
+    }
+    return toStats(*e, second);
+}
+
+// 其他线程可能持有 Entry 指针，只清零不释放
+void TopicMetrics::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (Entry *e : m_entries) {
+        e->messages.store(0, std::memory_order_relaxed);
+        e->bytes.store(0, std::memory_order_relaxed);
+        e->drops.store(0, std::memory_order_relaxed);
+        e->skipped.store(0, std::memory_order_relaxed);
+        e->resumeMs.store(-1, std::memory_order_relaxed);
+        e->second.store(-1, std::memory_order_relaxed);
+        e->windowMessages.store(0, std::memory_order_relaxed);
+        e->windowBytes.store(0, std::memory_order_relaxed);
+        e->lastMessages.store(0, std::memory_order_relaxed);
+        e->lastBytes.store(0, std::memory_order_relaxed);
+        e->sizes.reset();
+        e->parseNs.reset();
+        e->decodeNs.reset();
+        e->transportNs.reset();
+        e->endToEndNs.reset();
+        e->transportSamples.store(0, std::memory_order_relaxed);
+        e->endToEndSamples.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,265 @@
+#include "util/tracerecorder.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QVector>
+#include <QDebug>
+
+#include <chrono>
+
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// 静态初始化时读取环境变量：isEnabled() 不构造单例，放在构造函数里读取不会生效
+std::atomic<bool> TraceRecorder::s_enabled{qEnvironmentVariableIntValue("ROBANWEB_TRACE") > 0};
+
+// 线程退出时把缓冲区交还给 TraceRecorder，供之后创建的线程复用
+struct TraceThreadHandle
+{
+    TraceRecorder::ThreadBuffer *buffer = nullptr;
+    ~TraceThreadHandle()
+    {
+        if (buffer) TraceRecorder::instance().releaseBuffer(buffer);
+    }
+};
+
+static thread_local TraceThreadHandle t_handle;
+
+TraceRecorder &TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : m_originNs(nowNs())
+{
+}
+
+qint64 TraceRecorder::nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    instance();     // 确保 m_originNs 早于第一个事件
+    s_enabled.store(enabled, std::memory_order_relaxed);
+    qDebug() << "TraceRecorder:" << (enabled ? "开始记录追踪" : "停止记录追踪");
+}
+
+void TraceRecorder::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    for (ThreadBuffer *b : m_buffers) b->start.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+TraceRecorder::ThreadBuffer *TraceRecorder::acquireBuffer()
+{
+    QThread *thread = QThread::currentThread();
+    QString name = thread ? thread->objectName() : QString();
+    const bool isMain = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+    if (isMain) name = QStringLiteral("main");
+
+    QMutexLocker locker(&m_mutex);
+    ThreadBuffer *buffer = nullptr;
+    for (ThreadBuffer *b : m_buffers) {
+        if (!b->alive) {
+            buffer = b;
+            break;
+        }
+    }
+    if (!buffer) {
+        buffer = new ThreadBuffer;
+        m_buffers.append(buffer);
+    }
+    buffer->start.store(buffer->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    buffer->alive = true;
+    buffer->tid = m_nextTid++;
+    buffer->name = name.isEmpty() ? QStringLiteral("thread %1").arg(buffer->tid) : name;
+    return buffer;
+}
+
+void TraceRecorder::releaseBuffer(ThreadBuffer *buffer)
+{
+    QMutexLocker locker(&m_mutex);
+    buffer->alive = false;
+}
+
+// 只由所属线程调用：写入事件各字段后再发布 head，导出线程按 head 判断哪些事件完整
+void TraceRecorder::record(const char *name, qint64 startNs, qint64 durationNs, qint64 arg)
+{
+    if (!t_handle.buffer) t_handle.buffer = acquireBuffer();
+    ThreadBuffer *b = t_handle.buffer;
+    const quint64 i = b->head.load(std::memory_order_relaxed);
+    Event &e = b->events[i % BUFFER_EVENTS];
+    e.name.store(name, std::memory_order_relaxed);
+    e.startNs.store(startNs, std::memory_order_relaxed);
+    e.durationNs.store(durationNs, std::memory_order_relaxed);
+    e.arg.store(arg, std::memory_order_relaxed);
+    b->head.store(i + 1, std::memory_order_release);
+}
+
+static QByteArray jsonString(const QString &s)
+{
+    QByteArray out = "\"";
+    for (const QChar c : s) {
+        if (c == QLatin1Char('"') || c == QLatin1Char('\\')) {
+            out += '\\';
+            out += char(c.unicode());
+        } else if (c.unicode() < 0x20) {
+            out += QStringLiteral("\\u%1").arg(int(c.unicode()), 4, 16, QLatin1Char('0')).toLatin1();
+        } else {
+            out += QString(c).toUtf8();
+        }
+    }
+    out += '"';
+    return out;
+}
+
+bool TraceRecorder::writeChromeTrace(const QString &path, QString *error) const
+{
+    struct Copy {
+        int tid;
+        QString name;
+        QVector<const char *> names;
+        QVector<qint64> starts;
+        QVector<qint64> durations;
+        QVector<qint64> args;
+    };
+    QList<Copy> copies;
+    {
+        // 持锁只为读取缓冲区列表和线程名；事件本身不加锁读取，写入线程不会被阻塞
+        QMutexLocker locker(&m_mutex);
+        for (ThreadBuffer *b : m_buffers) {
+            Copy c;
+            c.tid = b->tid;
+            c.name = b->name;
+            const quint64 head = b->head.load(std::memory_order_acquire);
+            quint64 begin = qMax(b->start.load(std::memory_order_relaxed),
+                                 head > quint64(BUFFER_EVENTS) ? head - BUFFER_EVENTS : quint64(0));
+            for (quint64 i = begin; i < head; ++i) {
+                const Event &e = b->events[i % BUFFER_EVENTS];
+                c.names.append(e.name.load(std::memory_order_relaxed));
+                c.starts.append(e.startNs.load(std::memory_order_relaxed));
+                c.durations.append(e.durationNs.load(std::memory_order_relaxed));
+                c.args.append(e.arg.load(std::memory_order_relaxed));
+            }
+            // 读取期间写入线程可能已绕回覆盖了最早的一部分，丢弃这些（以及正在写入的那一格对应的）事件
+            const quint64 after = b->head.load(std::memory_order_acquire);
+            const quint64 firstIntact = after >= quint64(BUFFER_EVENTS) ? after - BUFFER_EVENTS + 1 : 0;
+            if (firstIntact > begin) {
+                const int skip = int(qMin<quint64>(firstIntact - begin, quint64(c.names.size())));
+                c.names.remove(0, skip);
+                c.starts.remove(0, skip);
+                c.durations.remove(0, skip);
+                c.args.remove(0, skip);
+            }
+            copies.append(c);
+        }
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto flush = [&]() {
+        if (out.size() > (1 << 20)) {
+            f.write(out);
+            out.clear();
+        }
+    };
+    qint64 events = 0;
+    for (const Copy &c : copies) {
+        if (c.names.isEmpty()) continue;
+        const QByteArray tid = QByteArray::number(c.tid);
+        if (!first) out += ",\n";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid
+               + ",\"args\":{\"name\":" + jsonString(c.name) + "}}";
+        for (int i = 0; i < c.names.size(); ++i) {
+            if (!c.names.at(i)) continue;
+            out += ",\n{\"name\":\"";
+            out += c.names.at(i);
+            out += "\",\"cat\":\"robanweb\",\"ph\":\"X\",\"ts\":";
+            out += QByteArray::number(double(c.starts.at(i) - m_originNs) / 1000.0, 'f', 3);
+            out += ",\"dur\":";
+            out += QByteArray::number(double(c.durations.at(i)) / 1000.0, 'f', 3);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid;
+            if (c.args.at(i) >= 0) out += ",\"args\":{\"n\":" + QByteArray::number(c.args.at(i)) + "}";
+            out += "}";
+            ++events;
+            flush();
+        }
+    }
+    out += "\n]}\n";
+    f.write(out);
+    if (f.error() != QFileDevice::NoError) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    qDebug() << "TraceRecorder: 导出" << events << "个事件到" << path;
+    return true;
+}
+
+QString TraceRecorder::defaultPath()
+{
+    return QDir(QCoreApplication::applicationDirPath()).filePath(
+        QStringLiteral("traces/trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+}
+
+#ifdef Q_OS_UNIX
+// 信号处理函数中只能做异步信号安全的操作：写一个字节唤醒主线程的 QSocketNotifier
+static int s_signalFds[2] = { -1, -1 };
+
+static void onDumpSignal(int)
+{
+    const char c = 1;
+    const ssize_t n = ::write(s_signalFds[0], &c, 1);
+    Q_UNUSED(n)
+}
+#endif
+
+void TraceRecorder::installDumpSignal()
+{
+    instance();     // 程序启动时确定时间原点
+#ifdef Q_OS_UNIX
+    if (s_signalFds[0] >= 0 || !QCoreApplication::instance()) return;
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFds) != 0) {
+        qDebug() << "TraceRecorder: socketpair 失败，SIGUSR1 导出不可用";
+        return;
+    }
+    auto *notifier = new QSocketNotifier(s_signalFds[1], QSocketNotifier::Read, QCoreApplication::instance());
+    QObject::connect(notifier, &QSocketNotifier::activated, notifier, []() {
+        char c;
+        const ssize_t n = ::read(s_signalFds[1], &c, 1);
+        Q_UNUSED(n)
+        QString error;
+        const QString path = defaultPath();
+        if (!instance().writeChromeTrace(path, &error)) qDebug() << "TraceRecorder: 导出失败" << path << error;
+    });
+
+    struct sigaction sa = {};
+    sa.sa_handler = onDumpSignal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    ::sigaction(SIGUSR1, &sa, nullptr);
+#endif
+}
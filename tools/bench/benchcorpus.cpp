@@ -0,0 +1,78 @@
+#include "benchcorpus.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QCborValue>
+#include <QHash>
+
+#include "socket_process/topicrouter.h"
+#include "socket_process/cbordecoder.h"
+
+namespace BenchCorpus
+{
+
+QCborMap message(const SyntheticStream::Config &config)
+{
+    SyntheticStream stream(config);
+    return stream.next(STAMP_US);
+}
+
+QJsonObject jsonMsg(const QCborMap &msg)
+{
+    return SyntheticStream::toJson(QCborValue(msg)).toObject();
+}
+
+QJsonObject jsonMsgWithArrayData(const QCborMap &msg)
+{
+    QJsonObject obj = jsonMsg(msg);
+    const QByteArray data = msg.value(QStringLiteral("data")).toByteArray();
+    QJsonArray arr;
+    for (char c : data) arr.append(int(uchar(c)));
+    obj["data"] = arr;
+    return obj;
+}
+
+QByteArray jsonFrame(const QString &topic, const QJsonObject &msg)
+{
+    QJsonObject envelope;
+    envelope["op"] = "publish";
+    envelope["topic"] = topic;
+    envelope["msg"] = msg;
+    return QJsonDocument(envelope).toJson(QJsonDocument::Compact);
+}
+
+QByteArray cborFrame(const QString &topic, const QCborMap &msg)
+{
+    QCborMap envelope;
+    envelope.insert(QStringLiteral("op"), QStringLiteral("publish"));
+    envelope.insert(QStringLiteral("topic"), topic);
+    envelope.insert(QStringLiteral("msg"), msg);
+    return envelope.toCborValue().toCbor();
+}
+
+RosMessage fromJsonFrame(const QByteArray &frame)
+{
+    RosMessage m;
+    TopicRouter::parseEnvelope(frame, &m);
+    return m;
+}
+
+RosMessage fromCborFrame(const QByteArray &frame)
+{
+    RosMessage m;
+    CborDecoder::decode(frame, QHash<QString, QString>(), &m);
+    return m;
+}
+
+QByteArray bytes(qsizetype size)
+{
+    QByteArray out(size, Qt::Uninitialized);
+    quint32 state = 0x12345678u;
+    for (qsizetype i = 0; i < size; ++i) {
+        state = state * 1664525u + 1013904223u;     // LCG，固定种子
+        out[i] = char(state >> 24);
+    }
+    return out;
+}
+
+} // namespace BenchCorpus
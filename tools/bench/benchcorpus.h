@@ -0,0 +1,38 @@
+#ifndef BENCHCORPUS_H
+#define BENCHCORPUS_H
+
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QCborMap>
+
+#include "syntheticstream.h"
+#include "socket_process/rosmessage.h"
+
+// 基准测试的固定语料：消息由 SyntheticStream 按固定时间戳生成（与模拟服务器发布的内容相同），
+// 再编码为 rosbridge 的 JSON 文本帧或 cbor 二进制帧，并按客户端的方式构造 RosMessage
+// 同样的参数每次生成逐字节相同的帧，不同版本之间的结果可以直接比较
+namespace BenchCorpus
+{
+    const qint64 STAMP_US = 1700000000000000LL;     // 消息 header.stamp
+
+    // 按配置生成一条消息（CBOR 形式，uint8[] 为字节串）
+    QCborMap message(const SyntheticStream::Config &config);
+
+    // rosbridge JSON 中的 msg：字节串为 base64（rosbridge 默认）
+    QJsonObject jsonMsg(const QCborMap &msg);
+    // 同上，但 data 为整数数组（部分 rosbridge 版本和 ROS 2 桥对 uint8[] 的编码）
+    QJsonObject jsonMsgWithArrayData(const QCborMap &msg);
+
+    QByteArray jsonFrame(const QString &topic, const QJsonObject &msg);    // {"op":"publish",...} 文本帧
+    QByteArray cborFrame(const QString &topic, const QCborMap &msg);       // compression: cbor 二进制帧
+
+    // 与 TopicRouter::routeUtf8 / CborDecoder 相同的方式构造 RosMessage
+    RosMessage fromJsonFrame(const QByteArray &frame);
+    RosMessage fromCborFrame(const QByteArray &frame);
+
+    // 确定性的字节序列
+    QByteArray bytes(qsizetype size);
+}
+
+#endif // BENCHCORPUS_H
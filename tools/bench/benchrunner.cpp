@@ -0,0 +1,176 @@
+#include "benchrunner.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QThread>
+#include <QHash>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+BenchRunner::BenchRunner(const Options &options)
+    : m_options(options)
+{
+}
+
+QString BenchRunner::caseName(const QString &group, const QString &variant, qint64 size)
+{
+    return QStringLiteral("%1/%2/%3").arg(group, variant).arg(size);
+}
+
+bool BenchRunner::matches(const QString &name) const
+{
+    if (m_options.filter.pattern().isEmpty()) return true;
+    return m_options.filter.match(name).hasMatch();
+}
+
+void BenchRunner::run(const QString &group, const QString &variant, qint64 size, qint64 bytes, qint64 items,
+                      const std::function<void()> &op, const std::function<bool()> &check)
+{
+    Result result;
+    result.name = caseName(group, variant, size);
+    if (!matches(result.name)) return;
+    result.group = group;
+    result.variant = variant;
+    result.size = size;
+    result.bytes = bytes;
+    result.items = items;
+
+    for (int i = 0; i < m_options.warmupIterations; ++i) op();
+    if (check) result.valid = check();
+
+    QVector<qint64> samples;
+    QElapsedTimer total;
+    total.start();
+    while (samples.size() < m_options.maxIterations
+           && (samples.size() < m_options.minIterations || total.elapsed() < m_options.minTimeMs)) {
+        QElapsedTimer timer;
+        timer.start();
+        op();
+        samples.append(timer.nsecsElapsed());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const int n = int(samples.size());
+    double sum = 0;
+    for (qint64 s : samples) sum += double(s);
+    result.iterations = n;
+    result.minNs = double(samples.first());
+    result.medianNs = n % 2 ? double(samples.at(n / 2)) : (double(samples.at(n / 2 - 1)) + double(samples.at(n / 2))) / 2.0;
+    result.meanNs = sum / n;
+    result.p90Ns = double(samples.at(int(0.9 * (n - 1))));
+    double var = 0;
+    for (qint64 s : samples) var += (double(s) - result.meanNs) * (double(s) - result.meanNs);
+    result.stddevNs = n > 1 ? std::sqrt(var / (n - 1)) : 0.0;
+    m_results.append(result);
+
+    const double mbPerSec = result.medianNs > 0 ? double(bytes) * 1000.0 / result.medianNs : 0;
+    qInfo().noquote() << QStringLiteral("%1 %2 us median  %3 us p90  %4 MB/s  x%5%6")
+                             .arg(result.name, -48)
+                             .arg(result.medianNs / 1000.0, 10, 'f', 1)
+                             .arg(result.p90Ns / 1000.0, 10, 'f', 1)
+                             .arg(mbPerSec, 9, 'f', 1)
+                             .arg(n)
+                             .arg(result.valid ? QString() : QStringLiteral("  [INVALID]"));
+}
+
+QJsonObject BenchRunner::resultToJson(const Result &result)
+{
+    QJsonObject obj;
+    obj["name"] = result.name;
+    obj["group"] = result.group;
+    obj["variant"] = result.variant;
+    obj["size"] = result.size;
+    obj["bytes"] = result.bytes;
+    obj["items"] = result.items;
+    obj["iterations"] = result.iterations;
+    obj["min_ns"] = result.minNs;
+    obj["median_ns"] = result.medianNs;
+    obj["mean_ns"] = result.meanNs;
+    obj["p90_ns"] = result.p90Ns;
+    obj["stddev_ns"] = result.stddevNs;
+    obj["mb_per_s"] = result.medianNs > 0 ? double(result.bytes) * 1000.0 / result.medianNs : 0.0;
+    obj["items_per_s"] = result.medianNs > 0 ? double(result.items) * 1e9 / result.medianNs : 0.0;
+    obj["valid"] = result.valid;
+    return obj;
+}
+
+QJsonObject BenchRunner::toJson() const
+{
+    QJsonObject env;
+    env["qt"] = QString::fromLatin1(qVersion());
+    env["abi"] = QSysInfo::buildAbi();
+    env["cpu"] = QSysInfo::currentCpuArchitecture();
+    env["os"] = QSysInfo::prettyProductName();
+    env["host"] = QSysInfo::machineHostName();
+    env["threads"] = QThread::idealThreadCount();
+#ifdef QT_NO_DEBUG
+    env["build"] = QStringLiteral("release");
+#else
+    env["build"] = QStringLiteral("debug");
+#endif
+
+    QJsonObject options;
+    options["min_time_ms"] = m_options.minTimeMs;
+    options["min_iterations"] = m_options.minIterations;
+    options["max_iterations"] = m_options.maxIterations;
+    options["warmup_iterations"] = m_options.warmupIterations;
+    options["filter"] = m_options.filter.pattern();
+
+    QJsonArray results;
+    for (const Result &r : m_results) results.append(resultToJson(r));
+
+    QJsonObject root;
+    root["format"] = QStringLiteral("robanweb-bench-1");
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["environment"] = env;
+    root["options"] = options;
+    root["results"] = results;
+    return root;
+}
+
+bool BenchRunner::writeJson(const QString &path) const
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "BenchRunner: 无法写入结果文件" << path << f.errorString();
+        return false;
+    }
+    f.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+int BenchRunner::compare(const QJsonObject &baseline) const
+{
+    QHash<QString, double> before;
+    const QJsonArray results = baseline.value("results").toArray();
+    for (const QJsonValue &v : results) {
+        const QJsonObject r = v.toObject();
+        before.insert(r.value("name").toString(), r.value("median_ns").toDouble());
+    }
+
+    int compared = 0;
+    qInfo().noquote() << QStringLiteral("%1 %2 %3 %4")
+                             .arg(QStringLiteral("case"), -48)
+                             .arg(QStringLiteral("baseline us"), 12)
+                             .arg(QStringLiteral("current us"), 12)
+                             .arg(QStringLiteral("change"), 9);
+    for (const Result &r : m_results) {
+        const auto it = before.constFind(r.name);
+        if (it == before.constEnd() || it.value() <= 0) continue;
+        const double change = (r.medianNs - it.value()) / it.value() * 100.0;
+        qInfo().noquote() << QStringLiteral("%1 %2 %3 %4%")
+                                 .arg(r.name, -48)
+                                 .arg(it.value() / 1000.0, 12, 'f', 1)
+                                 .arg(r.medianNs / 1000.0, 12, 'f', 1)
+                                 .arg(change, 8, 'f', 1);
+        ++compared;
+    }
+    return compared;
+}
@@ -0,0 +1,64 @@
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+#include <QRegularExpression>
+
+#include <functional>
+
+// 基准测试的计时与结果输出：每个用例先预热，再重复执行到至少 minTimeMs 且至少 minIterations 次，
+// 逐次计时后给出 min/median/mean/p90/stddev；结果写为 JSON，用 --baseline 指定旧结果时按用例名对比 median
+class BenchRunner
+{
+public:
+    struct Options {
+        int minTimeMs = 500;            // 每个用例至少测量的时间
+        int minIterations = 5;
+        int maxIterations = 100000;
+        int warmupIterations = 2;       // 预热次数（首次执行会分配复用的缓冲区、加载图像插件等）
+        QRegularExpression filter;      // 只运行名字匹配的用例，为空时全部运行
+    };
+
+    struct Result {
+        QString name;           // group/variant/size，比较结果时按此对齐
+        QString group;
+        QString variant;
+        qint64 size = 0;        // 语料规模（点数、关键帧数、像素数、字节数等，含义见 group）
+        qint64 bytes = 0;       // 每次输入的字节数，用于计算 MB/s
+        qint64 items = 0;       // 每次处理的元素数，用于计算 items/s
+        int iterations = 0;
+        double minNs = 0;
+        double medianNs = 0;
+        double meanNs = 0;
+        double p90Ns = 0;
+        double stddevNs = 0;
+        bool valid = true;      // 被测代码没有产生预期输出时为 false（结果仍记录，便于发现语料或解析问题）
+    };
+
+    explicit BenchRunner(const Options &options);
+
+    static QString caseName(const QString &group, const QString &variant, qint64 size);
+    bool matches(const QString &name) const;
+
+    // 运行一个用例：op 执行一次被测操作；check 在预热后调用一次，返回 false 表示输出不正确
+    // 不匹配 filter 的用例直接跳过；语料较大时调用方可先用 matches 判断，避免生成不需要的语料
+    void run(const QString &group, const QString &variant, qint64 size, qint64 bytes, qint64 items,
+             const std::function<void()> &op, const std::function<bool()> &check = std::function<bool()>());
+
+    const QList<Result> &results() const { return m_results; }
+
+    QJsonObject toJson() const;                 // 含运行环境信息和全部结果
+    bool writeJson(const QString &path) const;
+    // 与之前保存的结果对比：打印每个用例 median 的变化，返回两边都有的用例数
+    int compare(const QJsonObject &baseline) const;
+
+private:
+    static QJsonObject resultToJson(const Result &result);
+
+    Options m_options;
+    QList<Result> m_results;
+};
+
+#endif // BENCHRUNNER_H
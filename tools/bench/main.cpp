@@ -0,0 +1,340 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QSize>
+#include <QRegularExpression>
+#include <QImage>
+#include <QDebug>
+
+#include <cstdio>
+
+#include "benchrunner.h"
+#include "benchcorpus.h"
+
+#include "socket_process/websocketworker.h"
+#include "socket_process/typeddecoder.h"
+#include "socket_process/topicrouter.h"
+#include "socket_process/cbordecoder.h"
+#include "ros_process/slamMapPoint.h"
+#include "ros_process/cameraImage.h"
+#include "ros_process/imu.h"
+#include "util/load_param.hpp"
+
+// 消息解码路径的基准测试：点云、关键帧、图像、IMU 的处理槽，uint8[] 的 base64/整数数组解码，以及话题配置读取
+// 监视器的处理槽在本线程直接调用（与 DecodeExecutor 中的调用方式相同），WebSocketWorker 不建立连接
+//   robanweb_bench --filter pointcloud --min-time 1000 --baseline old.json
+// 结果写入 --output 指定的 JSON 文件（默认 robanweb_bench_<时间>.json），不同版本的结果可用 --baseline 对比
+
+static bool s_verbose = false;
+
+// 被测代码中的 qDebug 按帧打印，会淹没测量结果并计入耗时；默认只保留 info 以上的输出
+static void messageHandler(QtMsgType type, const QMessageLogContext &, const QString &msg)
+{
+    if (type == QtDebugMsg && !s_verbose) return;
+    fprintf(stderr, "%s\n", qPrintable(msg));
+    fflush(stderr);
+}
+
+static const char *POINT_CLOUD_TOPIC = "/SLAM/MapPoints";
+static const char *KEYFRAME_TOPIC = "/SLAM/KeyFrames";
+static const char *COMPRESSED_TOPIC = "/camera/color/image_raw/compressed";
+static const char *RAW_TOPIC = "/camera/color/image_raw";
+static const char *IMU_TOPIC = "/MediumSize/SensorHub/Imu";
+
+// SlamMapMonitor::parsePointCloud：JSON base64 / JSON 整数数组 / cbor 字节串三种 data 编码
+static void benchPointCloud(BenchRunner &runner, WebSocketWorker *worker)
+{
+    SlamMapMonitor monitor(worker);
+    const QString group = QStringLiteral("slam.pointcloud");
+    const QList<int> sizes = { 10000, 100000, 1000000 };
+    for (int points : sizes) {
+        const bool base64 = runner.matches(BenchRunner::caseName(group, "json-base64", points));
+        const bool array = points <= 100000 && runner.matches(BenchRunner::caseName(group, "json-array", points));
+        const bool cbor = runner.matches(BenchRunner::caseName(group, "cbor", points));
+        if (!base64 && !array && !cbor) continue;
+
+        SyntheticStream::Config config;
+        config.kind = SyntheticStream::PointCloud2;
+        config.topic = POINT_CLOUD_TOPIC;
+        config.points = points;
+        const QCborMap msg = BenchCorpus::message(config);
+
+        auto run = [&](const QString &variant, const QByteArray &frame, const RosMessage &message) {
+            const quint64 before = monitor.pointCloudMailbox().sequence();
+            runner.run(group, variant, points, frame.size(), points,
+                       [&]() { monitor.onRosMessage(message); },
+                       [&]() { return monitor.pointCloudMailbox().sequence() > before; });
+        };
+        if (base64) {
+            const QByteArray frame = BenchCorpus::jsonFrame(config.topic, BenchCorpus::jsonMsg(msg));
+            run("json-base64", frame, BenchCorpus::fromJsonFrame(frame));
+        }
+        if (array) {
+            const QByteArray frame = BenchCorpus::jsonFrame(config.topic, BenchCorpus::jsonMsgWithArrayData(msg));
+            run("json-array", frame, BenchCorpus::fromJsonFrame(frame));
+        }
+        if (cbor) {
+            const QByteArray frame = BenchCorpus::cborFrame(config.topic, msg);
+            run("cbor", frame, BenchCorpus::fromCborFrame(frame));
+        }
+    }
+}
+
+// SlamMapMonitor::parseKeyFrame（MarkerArray，每个关键帧一组点和线段）
+static void benchKeyFrames(BenchRunner &runner, WebSocketWorker *worker)
+{
+    SlamMapMonitor monitor(worker);
+    const QString group = QStringLiteral("slam.keyframes");
+    const QList<int> sizes = { 50, 200, 1000 };
+    for (int keyframes : sizes) {
+        SyntheticStream::Config config;
+        config.kind = SyntheticStream::MarkerArray;
+        config.topic = KEYFRAME_TOPIC;
+        config.keyframes = keyframes;
+        const QCborMap msg = BenchCorpus::message(config);
+
+        const QByteArray jsonFrame = BenchCorpus::jsonFrame(config.topic, BenchCorpus::jsonMsg(msg));
+        const QByteArray cborFrame = BenchCorpus::cborFrame(config.topic, msg);
+        const RosMessage jsonMessage = BenchCorpus::fromJsonFrame(jsonFrame);
+        const RosMessage cborMessage = BenchCorpus::fromCborFrame(cborFrame);
+        const quint64 before = monitor.keyFrameMailbox().sequence();
+        auto check = [&]() { return monitor.keyFrameMailbox().sequence() > before; };
+        runner.run(group, "json", keyframes, jsonFrame.size(), keyframes,
+                   [&]() { monitor.onRosMessage(jsonMessage); }, check);
+        runner.run(group, "cbor", keyframes, cborFrame.size(), keyframes,
+                   [&]() { monitor.onRosMessage(cborMessage); }, check);
+    }
+}
+
+// CameraImageMonitor::onRosMessage：压缩图像（jpeg 解码）和原始图像（bgr8 / mono8），尺寸为像素数
+static void benchCamera(BenchRunner &runner, WebSocketWorker *worker)
+{
+    const QList<QSize> sizes = { QSize(320, 240), QSize(640, 480), QSize(1280, 720) };
+
+    struct Variant {
+        QString group;
+        QString topic;
+        SyntheticStream::Kind kind;
+        QString encoding;
+    };
+    const QList<Variant> variants = {
+        { QStringLiteral("camera.compressed"), COMPRESSED_TOPIC, SyntheticStream::CompressedImage, QStringLiteral("jpeg") },
+        { QStringLiteral("camera.raw"), RAW_TOPIC, SyntheticStream::Image, QStringLiteral("bgr8") },
+        { QStringLiteral("camera.raw"), RAW_TOPIC, SyntheticStream::Image, QStringLiteral("mono8") },
+    };
+
+    for (const Variant &v : variants) {
+        CameraImageMonitor monitor(worker, nullptr, v.topic);
+        monitor.setMaxFps(1000000);     // 不限帧率，每帧都完整处理
+        bool gotImage = false;
+        QObject::connect(&monitor, &CameraImageMonitor::imageReceived, &monitor,
+                         [&gotImage](const QImage &image) { gotImage = !image.isNull(); }, Qt::DirectConnection);
+        auto check = [&]() {
+            gotImage = false;
+            monitor.requestFrame();
+            return gotImage;
+        };
+
+        for (const QSize &size : sizes) {
+            const qint64 pixels = qint64(size.width()) * size.height();
+            const QString jsonVariant = v.encoding + QStringLiteral("-json");
+            const QString cborVariant = v.encoding + QStringLiteral("-cbor");
+            if (!runner.matches(BenchRunner::caseName(v.group, jsonVariant, pixels))
+                && !runner.matches(BenchRunner::caseName(v.group, cborVariant, pixels))) {
+                continue;
+            }
+
+            SyntheticStream::Config config;
+            config.kind = v.kind;
+            config.topic = v.topic;
+            config.width = size.width();
+            config.height = size.height();
+            if (v.kind == SyntheticStream::Image) config.encoding = v.encoding;
+            const QCborMap msg = BenchCorpus::message(config);
+
+            const QByteArray jsonFrame = BenchCorpus::jsonFrame(config.topic, BenchCorpus::jsonMsg(msg));
+            const QByteArray cborFrame = BenchCorpus::cborFrame(config.topic, msg);
+            const RosMessage jsonMessage = BenchCorpus::fromJsonFrame(jsonFrame);
+            const RosMessage cborMessage = BenchCorpus::fromCborFrame(cborFrame);
+            runner.run(v.group, jsonVariant, pixels, jsonFrame.size(), pixels,
+                       [&]() { monitor.onRosMessage(jsonMessage); }, check);
+            runner.run(v.group, cborVariant, pixels, cborFrame.size(), pixels,
+                       [&]() { monitor.onRosMessage(cborMessage); }, check);
+        }
+    }
+}
+
+// uint8[] 字段的解码（原 jsonDataToByteArray，现为 TypedDecoder 读取 QByteArray 的叶子）：base64 字符串和整数数组
+static void benchByteArrayLeaf(BenchRunner &runner)
+{
+    const QString group = QStringLiteral("typeddecoder.bytes");
+    const QList<int> sizes = { 1024, 64 * 1024, 1024 * 1024 };
+    for (int size : sizes) {
+        const QByteArray data = BenchCorpus::bytes(size);
+        QJsonObject msg;
+        QJsonObject stamp;
+        stamp["secs"] = qint64(BenchCorpus::STAMP_US / 1000000);
+        stamp["nsecs"] = 0;
+        QJsonObject header;
+        header["seq"] = 0;
+        header["stamp"] = stamp;
+        header["frame_id"] = "camera";
+        msg["header"] = header;
+        msg["format"] = "jpeg";
+
+        msg["data"] = QString::fromLatin1(data.toBase64());
+        const QByteArray base64Json = QJsonDocument(msg).toJson(QJsonDocument::Compact);
+        QJsonArray array;
+        for (char c : data) array.append(int(uchar(c)));
+        msg["data"] = array;
+        const QByteArray arrayJson = QJsonDocument(msg).toJson(QJsonDocument::Compact);
+
+        rosmsg::CompressedImage image;     // data 缓冲区在迭代之间复用，与监视器中的用法相同
+        auto check = [&]() { return image.data == data; };
+        runner.run(group, "base64", size, base64Json.size(), size,
+                   [&]() { TypedDecoder::decode(QByteArrayView(base64Json), &image); }, check);
+        runner.run(group, "array", size, arrayJson.size(), size,
+                   [&]() { TypedDecoder::decode(QByteArrayView(arrayJson), &image); }, check);
+    }
+}
+
+// ImuMonitor::onRosMessage
+static void benchImu(BenchRunner &runner, WebSocketWorker *worker)
+{
+    ImuMonitor monitor(worker);
+    SyntheticStream::Config config;
+    config.kind = SyntheticStream::Imu;
+    config.topic = IMU_TOPIC;
+    const QCborMap msg = BenchCorpus::message(config);
+
+    const QByteArray jsonFrame = BenchCorpus::jsonFrame(config.topic, BenchCorpus::jsonMsg(msg));
+    const QByteArray cborFrame = BenchCorpus::cborFrame(config.topic, msg);
+    const RosMessage jsonMessage = BenchCorpus::fromJsonFrame(jsonFrame);
+    const RosMessage cborMessage = BenchCorpus::fromCborFrame(cborFrame);
+    const quint64 before = monitor.mailbox().sequence();
+    auto check = [&]() { return monitor.mailbox().sequence() > before; };
+    runner.run("imu", "json", 1, jsonFrame.size(), 1, [&]() { monitor.onRosMessage(jsonMessage); }, check);
+    runner.run("imu", "cbor", 1, cborFrame.size(), 1, [&]() { monitor.onRosMessage(cborMessage); }, check);
+}
+
+// socket 线程上的信封解析：JSON 帧（TopicRouter::parseEnvelope，需要跳过整个 msg）和 cbor 帧（CborDecoder）
+static void benchEnvelope(BenchRunner &runner)
+{
+    const QString group = QStringLiteral("router.envelope");
+    const QList<int> sizes = { 10000, 100000, 1000000 };
+    for (int points : sizes) {
+        if (!runner.matches(BenchRunner::caseName(group, "json", points))
+            && !runner.matches(BenchRunner::caseName(group, "cbor", points))) {
+            continue;
+        }
+        SyntheticStream::Config config;
+        config.kind = SyntheticStream::PointCloud2;
+        config.topic = POINT_CLOUD_TOPIC;
+        config.points = points;
+        const QCborMap msg = BenchCorpus::message(config);
+        const QByteArray jsonFrame = BenchCorpus::jsonFrame(config.topic, BenchCorpus::jsonMsg(msg));
+        const QByteArray cborFrame = BenchCorpus::cborFrame(config.topic, msg);
+        const QHash<QString, QString> types;
+
+        RosMessage out;
+        runner.run(group, "json", points, jsonFrame.size(), 1,
+                   [&]() { out = RosMessage(); TopicRouter::parseEnvelope(jsonFrame, &out); },
+                   [&]() { return out.hasJson(); });
+        runner.run(group, "cbor", points, cborFrame.size(), 1,
+                   [&]() { out = RosMessage(); CborDecoder::decode(cborFrame, types, &out); },
+                   [&]() { return !out.data.isEmpty(); });
+    }
+}
+
+// loadTopicFromConfig：每次调用都会重新读取并匹配 config/topic_config.yaml，size 为键在文件中的位置
+static void benchConfig(BenchRunner &runner)
+{
+    const QString group = QStringLiteral("config.loadTopicFromConfig");
+    struct Key {
+        QString variant;
+        QString key;
+    };
+    const QList<Key> keys = {
+        { QStringLiteral("first"), QStringLiteral("battery_topic") },
+        { QStringLiteral("last"), QStringLiteral("cameraPose_topic_type") },
+        { QStringLiteral("missing"), QStringLiteral("no_such_topic") },
+    };
+    for (const Key &k : keys) {
+        QString value;
+        runner.run(group, k.variant, 1, 0, 1,
+                   [&]() { value = loadTopicFromConfig(k.key); },
+                   [&]() { return k.variant == QLatin1String("missing") ? value.isEmpty() : !value.isEmpty(); });
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("robanweb_bench");
+    qInstallMessageHandler(messageHandler);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks for the robanweb message decode paths");
+    parser.addHelpOption();
+    const QList<QCommandLineOption> options = {
+        {"output", "Write results as JSON to this file.", "file"},
+        {"baseline", "Compare medians against a previous JSON result.", "file"},
+        {"filter", "Only run cases whose name (group/variant/size) matches this regex.", "regex"},
+        {"min-time", "Minimum measured time per case (ms).", "ms", "500"},
+        {"min-iterations", "Minimum iterations per case.", "count", "5"},
+        {"verbose", "Keep qDebug output of the code under test."},
+    };
+    parser.addOptions(options);
+    parser.process(app);
+    s_verbose = parser.isSet("verbose");
+
+    BenchRunner::Options runnerOptions;
+    runnerOptions.minTimeMs = parser.value("min-time").toInt();
+    runnerOptions.minIterations = qMax(1, parser.value("min-iterations").toInt());
+    if (parser.isSet("filter")) {
+        runnerOptions.filter = QRegularExpression(parser.value("filter"));
+        if (!runnerOptions.filter.isValid()) {
+            qCritical().noquote() << "无效的 --filter:" << runnerOptions.filter.errorString();
+            return 1;
+        }
+    }
+    BenchRunner runner(runnerOptions);
+
+    if (loadTopicFromConfig("slamPoint_topic").isEmpty()) {
+        qWarning() << "未找到 config/topic_config.yaml，loadTopicFromConfig 用例测得的是查找失败的路径";
+    }
+
+    WebSocketWorker worker;
+    benchEnvelope(runner);
+    benchPointCloud(runner, &worker);
+    benchKeyFrames(runner, &worker);
+    benchCamera(runner, &worker);
+    benchByteArrayLeaf(runner);
+    benchImu(runner, &worker);
+    benchConfig(runner);
+
+    const QString output = parser.isSet("output")
+        ? parser.value("output")
+        : QStringLiteral("robanweb_bench_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    if (!runner.writeJson(output)) return 1;
+    qInfo().noquote() << "结果已写入" << QFileInfo(output).absoluteFilePath();
+
+    if (parser.isSet("baseline")) {
+        QFile f(parser.value("baseline"));
+        if (!f.open(QIODevice::ReadOnly)) {
+            qWarning() << "无法读取基线结果" << f.fileName();
+            return 1;
+        }
+        runner.compare(QJsonDocument::fromJson(f.readAll()).object());
+    }
+
+    bool allValid = true;
+    for (const BenchRunner::Result &r : runner.results()) allValid = allValid && r.valid;
+    return allValid ? 0 : 2;
+}
@@ -0,0 +1,80 @@
+#include "displayconsumer.h"
+
+#include <QPainter>
+#include <QVector3D>
+
+#include "util/messagestamps.h"
+
+DisplayConsumer::DisplayConsumer(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &DisplayConsumer::pull);
+    setCanvasSize(QSize(640, 480));
+}
+
+// requestFrame 在本线程调用，imageReceived 直接在这里处理：画到画布上即为显示（markDisplayed 由 requestFrame 完成）
+void DisplayConsumer::setCameraMonitor(CameraImageMonitor *monitor, const QString &topic)
+{
+    if (m_camera) disconnect(m_camera, nullptr, this, nullptr);
+    m_camera = monitor;
+    m_cameraTopic = topic;
+    if (!monitor) return;
+    connect(monitor, &CameraImageMonitor::imageReceived, this, [this](const QImage &image) {
+        QPainter painter(&m_canvas);
+        const QSize scaled = image.size().scaled(m_canvas.size(), Qt::KeepAspectRatio);
+        painter.drawImage(QRect(QPoint(0, 0), scaled), image);
+        ++m_displayed[m_cameraTopic];
+    }, Qt::DirectConnection);
+}
+
+void DisplayConsumer::setCanvasSize(const QSize &size)
+{
+    m_canvas = QImage(size, QImage::Format_RGBA8888);
+    m_canvas.fill(Qt::black);
+}
+
+void DisplayConsumer::start(int fps)
+{
+    m_timer.start(qMax(1, 1000 / qMax(1, fps)));
+}
+
+void DisplayConsumer::stop()
+{
+    m_timer.stop();
+}
+
+// 与界面的拉取定时器相同：每个信箱只取最新的一份
+void DisplayConsumer::pull()
+{
+    if (m_camera) m_camera->requestFrame();
+
+    if (m_slam) {
+        QList<QVector3D> points;
+        MessageStamps stamps;
+        if (m_slam->pointCloudMailbox().take(&points, &stamps)) {
+            if (m_display) m_display->onPointCloudReceived(points);
+            stamps.markDisplayed(m_slam->pointCloudMailbox().topic());
+            ++m_displayed[m_slam->pointCloudMailbox().topic()];
+        }
+        KeyFrameMarkers markers;
+        if (m_slam->keyFrameMailbox().take(&markers)) {
+            if (m_display) m_display->onKeyFrameMarkers(markers.points, markers.lines);
+            ++m_displayed[m_slam->keyFrameMailbox().topic()];
+        }
+        QVector<double> matrix;
+        if (m_slam->cameraMatrixMailbox().take(&matrix)) {
+            if (m_display) m_display->onCameraMatrixReceived(matrix);
+            ++m_displayed[m_slam->cameraMatrixMailbox().topic()];
+        }
+    }
+
+    if (m_imu) {
+        ImuSample sample;
+        MessageStamps stamps;
+        if (m_imu->mailbox().take(&sample, &stamps)) {
+            stamps.markDisplayed(m_imu->mailbox().topic());
+            ++m_displayed[m_imu->mailbox().topic()];
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef DISPLAYCONSUMER_H
+#define DISPLAYCONSUMER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QImage>
+#include <QHash>
+#include <QString>
+#include <QPointer>
+#include <QSize>
+
+#include "ros_process/cameraImage.h"
+#include "ros_process/slamMapPoint.h"
+#include "ros_process/imu.h"
+#include "ros_process/pointCloudDisplay.h"
+
+// 模拟界面线程的取帧：按显示帧率拉取各监视器的最新数据并“显示”，显示时调用 MessageStamps::markDisplayed，
+// 端到端延迟（消息时间戳 -> 可显示）记到 TopicMetrics 的 EndToEnd 上，与主程序中 robanweb/ShDialog 的做法相同
+// 图像用 QPainter 画到离屏 QImage 上；指定 PointCloudDisplay 时点云、关键帧和相机矩阵交给它渲染（需要 OpenGL）
+class DisplayConsumer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DisplayConsumer(QObject *parent = nullptr);
+
+    void setCameraMonitor(CameraImageMonitor *monitor, const QString &topic);
+    void setSlamMonitor(SlamMapMonitor *monitor) { m_slam = monitor; }
+    void setImuMonitor(ImuMonitor *monitor) { m_imu = monitor; }
+    void setPointCloudDisplay(PointCloudDisplay *display) { m_display = display; }
+    void setCanvasSize(const QSize &size);
+
+    void start(int fps);
+    void stop();
+
+    // 各话题自上次 resetCounts 以来显示的帧数
+    quint64 displayed(const QString &topic) const { return m_displayed.value(topic); }
+    void resetCounts() { m_displayed.clear(); }
+
+private slots:
+    void pull();
+
+private:
+    QTimer m_timer;
+    QPointer<CameraImageMonitor> m_camera;
+    QPointer<SlamMapMonitor> m_slam;
+    QPointer<ImuMonitor> m_imu;
+    QPointer<PointCloudDisplay> m_display;
+    QString m_cameraTopic;
+    QImage m_canvas;                        // 离屏画布，相当于界面上的图像控件
+    QHash<QString, quint64> m_displayed;
+};
+
+#endif // DISPLAYCONSUMER_H
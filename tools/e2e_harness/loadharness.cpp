@@ -0,0 +1,433 @@
+#include "loadharness.h"
+
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QGuiApplication>
+#include <QDebug>
+
+#include "socket_process/connectionmanager.h"
+#include "socket_process/websocketworker.h"
+#include "socket_process/clocksync.h"
+#include "util/topicmetrics.h"
+#include "util/load_param.hpp"
+
+// 与监视器相同：配置文件中没有时使用默认话题名
+static QString topicFromConfig(const QString &key, const QString &fallback)
+{
+    const QString topic = loadTopicFromConfig(key);
+    return topic.isEmpty() ? fallback : topic;
+}
+
+LoadHarness::LoadHarness(const Options &options, QObject *parent)
+    : QObject(parent), m_options(options)
+{
+    m_serverThread.setObjectName("mock_rosbridge");
+}
+
+LoadHarness::~LoadHarness()
+{
+    tearDown();
+}
+
+void LoadHarness::start()
+{
+    if (!setUp()) {
+        finish(1);
+        return;
+    }
+    m_readyTimer.start();
+    waitReady();
+}
+
+// 模拟服务器在独立线程中运行，发布调度不受界面线程的取帧和绘制影响
+bool LoadHarness::setUp()
+{
+    const QString cameraTopic = topicFromConfig("cameraCompressed_topic", "/camera/color/image_raw/compressed");
+    const QString cloudTopic = topicFromConfig("slamPoint_topic", "/SLAM/MapPoints");
+    const QString keyframeTopic = topicFromConfig("slamKeyFrame_topic", "/SLAM/KeyFrames");
+    const QString matrixTopic = topicFromConfig("openGLMatrix_topic", "/SLAM/CameraOpenGLMatrix");
+    const QString poseTopic = topicFromConfig("cameraPose_topic", "/SLAM/CameraPoint");
+    const QString imuTopic = topicFromConfig("imu_topic", "/MediumSize/SensorHub/Imu");
+
+    m_server = new MockRosbridgeServer;
+    m_server->setStatsInterval(0);
+    m_server->setHonorThrottle(m_options.honorThrottle);
+
+    auto add = [this](SyntheticStream::Config config, double baseHz) {
+        if (baseHz <= 0) return;
+        config.rateHz = 0;      // 频率在每一级开始时设置
+        m_server->addStream(config);
+        m_loads.append(TopicLoad{ config.topic, baseHz });
+    };
+    SyntheticStream::Config camera;
+    camera.kind = SyntheticStream::CompressedImage;
+    camera.topic = cameraTopic;
+    camera.width = m_options.cameraSize.width();
+    camera.height = m_options.cameraSize.height();
+    camera.quality = m_options.cameraQuality;
+    add(camera, m_options.cameraHz);
+    SyntheticStream::Config cloud;
+    cloud.kind = SyntheticStream::PointCloud2;
+    cloud.topic = cloudTopic;
+    cloud.points = m_options.cloudPoints;
+    add(cloud, m_options.cloudHz);
+    SyntheticStream::Config keyframes;
+    keyframes.kind = SyntheticStream::MarkerArray;
+    keyframes.topic = keyframeTopic;
+    keyframes.keyframes = m_options.keyframes;
+    add(keyframes, m_options.keyframeHz);
+    SyntheticStream::Config matrix;
+    matrix.kind = SyntheticStream::Float64MultiArray;
+    matrix.topic = matrixTopic;
+    add(matrix, m_options.poseHz);
+    SyntheticStream::Config pose;
+    pose.kind = SyntheticStream::PoseStamped;
+    pose.topic = poseTopic;
+    add(pose, m_options.poseHz);
+    SyntheticStream::Config imu;
+    imu.kind = SyntheticStream::Imu;
+    imu.topic = imuTopic;
+    add(imu, m_options.imuHz);
+
+    if (!m_options.ramp.isEmpty()) {
+        bool found = false;
+        for (const TopicLoad &load : m_loads) found = found || load.topic == m_options.ramp;
+        if (!found) {
+            qWarning().noquote() << "LoadHarness: --ramp 指定的话题没有数据流:" << m_options.ramp;
+            return false;
+        }
+    }
+
+    m_server->moveToThread(&m_serverThread);
+    connect(&m_serverThread, &QThread::finished, m_server, &QObject::deleteLater);
+    m_serverThread.start();
+    bool listening = false;
+    QMetaObject::invokeMethod(m_server, [this, &listening]() {
+        listening = m_server->listen(QHostAddress::LocalHost, 0);
+        m_url = m_server->url();
+    }, Qt::BlockingQueuedConnection);
+    if (!listening) return false;
+
+    // 客户端与主程序相同：每个连接一个 worker 线程，监视器在界面线程创建
+    m_connections = new ConnectionManager(this);
+    connect(m_connections, &ConnectionManager::robotConnected, this, [this](const QString &) { m_connected = true; });
+    m_worker = m_connections->open(m_url);
+    if (!m_worker) return false;
+
+    m_camera = new CameraImageMonitor(m_worker, nullptr, cameraTopic);
+    m_camera->setTargetSize(m_options.cameraSize);
+    m_camera->setMaxFps(1000);      // 不在客户端限帧：压测的是管线本身能处理的帧率
+    m_slam = new SlamMapMonitor(m_worker);
+    m_imu = new ImuMonitor(m_worker);
+    m_camera->start();
+    m_slam->start();
+    m_imu->start();
+
+    if (m_options.gl) {
+        m_display = new PointCloudDisplay;
+        m_display->resize(800, 600);
+        m_display->show();
+    }
+    m_consumer.setCameraMonitor(m_camera, cameraTopic);
+    m_consumer.setSlamMonitor(m_slam);
+    m_consumer.setImuMonitor(m_imu);
+    m_consumer.setPointCloudDisplay(m_display);
+    m_consumer.setCanvasSize(m_options.cameraSize);
+    m_consumer.start(m_options.displayFps);
+
+    qInfo().noquote() << "LoadHarness:" << m_url << "platform" << QGuiApplication::platformName()
+                      << "topics" << m_loads.size();
+    return true;
+}
+
+// 等待连接建立和时钟同步（mock 的 get_time 与本机为同一时钟，同步后偏差约为往返时间的一半）
+void LoadHarness::waitReady()
+{
+    const bool synced = m_worker->clockSync()->isSynced();
+    if (m_connected && synced) {
+        m_factor = m_options.startFactor;
+        runStep();
+        return;
+    }
+    if (m_readyTimer.elapsed() > m_options.syncTimeoutMs) {
+        if (!m_connected) {
+            qWarning().noquote() << "LoadHarness: 连接模拟服务器超时" << m_url;
+            finish(1);
+            return;
+        }
+        qWarning().noquote() << "LoadHarness: 时钟未同步，结果中没有端到端延迟";
+        m_factor = m_options.startFactor;
+        runStep();
+        return;
+    }
+    QTimer::singleShot(100, this, &LoadHarness::waitReady);
+}
+
+double LoadHarness::targetHz(const TopicLoad &load, double factor) const
+{
+    if (!m_options.ramp.isEmpty() && load.topic != m_options.ramp) return load.baseHz;
+    return load.baseHz * factor;
+}
+
+void LoadHarness::setRates(double factor)
+{
+    QList<QPair<QString, double>> rates;
+    for (const TopicLoad &load : m_loads) rates.append(qMakePair(load.topic, targetHz(load, factor)));
+    QMetaObject::invokeMethod(m_server, [this, rates]() {
+        for (const auto &rate : rates) m_server->setStreamRate(rate.first, rate.second);
+    }, Qt::BlockingQueuedConnection);
+}
+
+MockRosbridgeServer::Stats LoadHarness::serverStats(const QString &topic)
+{
+    MockRosbridgeServer::Stats stats;
+    QMetaObject::invokeMethod(m_server, [this, &stats, topic]() { stats = m_server->stats(topic); },
+                              Qt::BlockingQueuedConnection);
+    return stats;
+}
+
+void LoadHarness::runStep()
+{
+    setRates(m_factor);
+    QTimer::singleShot(m_options.warmupMs, this, &LoadHarness::beginMeasure);
+}
+
+// 计数窗口开始：服务端统计、TopicMetrics 和显示计数同时清零
+void LoadHarness::beginMeasure()
+{
+    QMetaObject::invokeMethod(m_server, [this]() { m_server->resetStats(); }, Qt::BlockingQueuedConnection);
+    TopicMetrics::instance().reset();
+    m_consumer.resetCounts();
+    m_measureTimer.start();
+    QTimer::singleShot(m_options.measureMs, this, &LoadHarness::endMeasure);
+}
+
+void LoadHarness::endMeasure()
+{
+    const double secs = qMax<qint64>(1, m_measureTimer.elapsed()) / 1000.0;
+    StepResult step;
+    step.factor = m_factor;
+    for (const TopicLoad &load : m_loads) {
+        const MockRosbridgeServer::Stats server = serverStats(load.topic);
+        const TopicStats client = TopicMetrics::instance().stats(load.topic);
+        TopicResult r;
+        r.topic = load.topic;
+        r.targetHz = targetHz(load, m_factor);
+        r.generated = server.messages;
+        r.offeredHz = server.messages / secs;
+        r.receivedHz = client.messages / secs;
+        r.displayedHz = m_consumer.displayed(load.topic) / secs;
+        r.mbPerSec = server.bytes / secs / 1e6;
+        r.serverDropped = server.dropped;
+        r.clientDropped = client.drops;
+        r.clientSkipped = client.skipped;
+        r.dropRatio = double(server.dropped + client.drops) / double(qMax<quint64>(1, server.messages));
+        r.endToEndMsP50 = client.endToEndMsP50;
+        r.endToEndMsP99 = client.endToEndMsP99;
+        r.endToEndSamples = client.endToEndSamples;
+        r.transportMsP50 = client.transportMsP50;
+        r.transportMsP99 = client.transportMsP99;
+        r.decodeUsP99 = client.decodeUsP99;
+        step.msgsPerSec += r.offeredHz;
+        step.mbPerSec += r.mbPerSec;
+
+        if (r.dropRatio > m_options.dropThreshold && !step.saturated) {
+            step.saturated = true;
+            step.reason = QStringLiteral("drops %1% on %2").arg(r.dropRatio * 100.0, 0, 'f', 1).arg(r.topic);
+        }
+        if (m_options.latencyLimitMs > 0 && r.endToEndMsP99 > m_options.latencyLimitMs && !step.saturated) {
+            step.saturated = true;
+            step.reason = QStringLiteral("end-to-end p99 %1 ms on %2").arg(r.endToEndMsP99, 0, 'f', 1).arg(r.topic);
+        }
+        if (r.targetHz > 0 && r.offeredHz < 0.9 * r.targetHz) step.generatorLimited = true;
+        step.topics.append(r);
+    }
+    m_steps.append(step);
+
+    qInfo().noquote() << QStringLiteral("x%1  %2 msg/s  %3 MB/s  %4")
+                             .arg(m_factor, 0, 'f', 2)
+                             .arg(step.msgsPerSec, 0, 'f', 0)
+                             .arg(step.mbPerSec, 0, 'f', 1)
+                             .arg(step.saturated ? QStringLiteral("SATURATED (") + step.reason + ')' : QStringLiteral("ok"));
+    for (const TopicResult &r : step.topics) {
+        qInfo().noquote() << QStringLiteral("    %1 %2 Hz offered  %3 Hz shown  drop %4%  skipped %5  e2e p50 %6 ms p99 %7 ms")
+                                 .arg(r.topic, -40)
+                                 .arg(r.offeredHz, 8, 'f', 1)
+                                 .arg(r.displayedHz, 7, 'f', 1)
+                                 .arg(r.dropRatio * 100.0, 5, 'f', 1)
+                                 .arg(r.clientSkipped, 6)
+                                 .arg(r.endToEndMsP50, 7, 'f', 1)
+                                 .arg(r.endToEndMsP99, 7, 'f', 1);
+    }
+
+    if (step.saturated) {
+        finish(0);
+        return;
+    }
+    if (step.generatorLimited) {
+        qWarning().noquote() << "LoadHarness: 模拟服务器达不到目标频率，停止加压（饱和点为下限）";
+        finish(0);
+        return;
+    }
+    const double next = m_factor * m_options.stepFactor;
+    if (next > m_options.maxFactor || m_options.stepFactor <= 1.0) {
+        finish(0);
+        return;
+    }
+    m_factor = next;
+    runStep();
+}
+
+QJsonObject LoadHarness::stepToJson(const StepResult &step)
+{
+    QJsonArray topics;
+    for (const TopicResult &r : step.topics) {
+        QJsonObject t;
+        t["topic"] = r.topic;
+        t["target_hz"] = r.targetHz;
+        t["offered_hz"] = r.offeredHz;
+        t["received_hz"] = r.receivedHz;
+        t["displayed_hz"] = r.displayedHz;
+        t["mb_per_s"] = r.mbPerSec;
+        t["generated"] = double(r.generated);
+        t["server_dropped"] = double(r.serverDropped);
+        t["client_dropped"] = double(r.clientDropped);
+        t["client_skipped"] = double(r.clientSkipped);
+        t["drop_ratio"] = r.dropRatio;
+        t["e2e_p50_ms"] = r.endToEndMsP50;
+        t["e2e_p99_ms"] = r.endToEndMsP99;
+        t["e2e_samples"] = double(r.endToEndSamples);
+        t["transport_p50_ms"] = r.transportMsP50;
+        t["transport_p99_ms"] = r.transportMsP99;
+        t["decode_p99_us"] = r.decodeUsP99;
+        topics.append(t);
+    }
+    QJsonObject obj;
+    obj["factor"] = step.factor;
+    obj["saturated"] = step.saturated;
+    obj["generator_limited"] = step.generatorLimited;
+    obj["reason"] = step.reason;
+    obj["msgs_per_s"] = step.msgsPerSec;
+    obj["mb_per_s"] = step.mbPerSec;
+    obj["topics"] = topics;
+    return obj;
+}
+
+// saturatedIndex 为第一个饱和的级，-1 表示到最大倍数仍未饱和
+QJsonObject LoadHarness::toJson(int saturatedIndex) const
+{
+    QJsonObject env;
+    env["qt"] = QString::fromLatin1(qVersion());
+    env["cpu"] = QSysInfo::currentCpuArchitecture();
+    env["os"] = QSysInfo::prettyProductName();
+    env["threads"] = QThread::idealThreadCount();
+    env["platform"] = QGuiApplication::platformName();
+
+    QJsonObject options;
+    options["start_factor"] = m_options.startFactor;
+    options["step_factor"] = m_options.stepFactor;
+    options["max_factor"] = m_options.maxFactor;
+    options["warmup_ms"] = m_options.warmupMs;
+    options["measure_ms"] = m_options.measureMs;
+    options["drop_threshold"] = m_options.dropThreshold;
+    options["latency_limit_ms"] = m_options.latencyLimitMs;
+    options["display_fps"] = m_options.displayFps;
+    options["honor_throttle"] = m_options.honorThrottle;
+    options["gl"] = m_options.gl;
+    options["ramp"] = m_options.ramp;
+    QJsonObject base;
+    for (const TopicLoad &load : m_loads) base[load.topic] = load.baseHz;
+    options["base_hz"] = base;
+    options["camera_size"] = QStringLiteral("%1x%2").arg(m_options.cameraSize.width()).arg(m_options.cameraSize.height());
+    options["cloud_points"] = m_options.cloudPoints;
+    options["keyframes"] = m_options.keyframes;
+
+    QJsonArray steps;
+    for (const StepResult &step : m_steps) steps.append(stepToJson(step));
+
+    // 饱和点：第一次饱和之前的最后一级；全部未饱和时为最后一级（下限）
+    QJsonObject saturation;
+    const int lastGood = saturatedIndex < 0 ? int(m_steps.size()) - 1 : saturatedIndex - 1;
+    saturation["reached"] = saturatedIndex >= 0;
+    saturation["reason"] = saturatedIndex >= 0 ? m_steps.at(saturatedIndex).reason : QString();
+    saturation["factor"] = lastGood >= 0 ? m_steps.at(lastGood).factor : 0.0;
+    saturation["msgs_per_s"] = lastGood >= 0 ? m_steps.at(lastGood).msgsPerSec : 0.0;
+    saturation["mb_per_s"] = lastGood >= 0 ? m_steps.at(lastGood).mbPerSec : 0.0;
+    saturation["generator_limited"] = !m_steps.isEmpty() && m_steps.last().generatorLimited;
+
+    QJsonObject root;
+    root["format"] = QStringLiteral("robanweb-e2e-1");
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["environment"] = env;
+    root["options"] = options;
+    root["steps"] = steps;
+    root["saturation"] = saturation;
+    return root;
+}
+
+void LoadHarness::finish(int exitCode)
+{
+    m_consumer.stop();
+    if (!m_steps.isEmpty()) {
+        int saturatedIndex = -1;
+        for (int i = 0; i < m_steps.size() && saturatedIndex < 0; ++i) {
+            if (m_steps.at(i).saturated) saturatedIndex = i;
+        }
+        const QJsonObject result = toJson(saturatedIndex);
+        const QJsonObject saturation = result.value("saturation").toObject();
+        qInfo().noquote() << QStringLiteral("saturation: x%1  %2 msg/s  %3 MB/s%4")
+                                 .arg(saturation.value("factor").toDouble(), 0, 'f', 2)
+                                 .arg(saturation.value("msgs_per_s").toDouble(), 0, 'f', 0)
+                                 .arg(saturation.value("mb_per_s").toDouble(), 0, 'f', 1)
+                                 .arg(saturation.value("reached").toBool() ? QString() : QStringLiteral("  (not reached, lower bound)"));
+
+        const QString path = m_options.output.isEmpty()
+            ? QStringLiteral("robanweb_e2e_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"))
+            : m_options.output;
+        QFile f(path);
+        if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            f.write(QJsonDocument(result).toJson(QJsonDocument::Indented));
+            qInfo().noquote() << "结果已写入" << QFileInfo(path).absoluteFilePath();
+        } else {
+            qWarning().noquote() << "LoadHarness: 无法写入结果文件" << path << f.errorString();
+            if (exitCode == 0) exitCode = 1;
+        }
+    }
+    tearDown();
+    emit finished(exitCode);
+}
+
+// 先销毁监视器（析构时从 worker 的路由器注销），再关闭连接，最后停止模拟服务器
+void LoadHarness::tearDown()
+{
+    m_consumer.setCameraMonitor(nullptr, QString());
+    m_consumer.setSlamMonitor(nullptr);
+    m_consumer.setImuMonitor(nullptr);
+    m_consumer.setPointCloudDisplay(nullptr);
+    delete m_display;
+    m_display = nullptr;
+    delete m_camera;
+    m_camera = nullptr;
+    delete m_slam;
+    m_slam = nullptr;
+    delete m_imu;
+    m_imu = nullptr;
+    if (m_connections) {
+        m_connections->closeAll();
+        delete m_connections;
+        m_connections = nullptr;
+        m_worker = nullptr;
+    }
+    if (m_serverThread.isRunning()) {
+        m_serverThread.quit();
+        m_serverThread.wait();
+    } else if (m_server) {
+        delete m_server;
+    }
+    m_server = nullptr;
+}
@@ -0,0 +1,137 @@
+#ifndef LOADHARNESS_H
+#define LOADHARNESS_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSize>
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+
+#include "mockrosbridgeserver.h"
+#include "displayconsumer.h"
+
+class ConnectionManager;
+class WebSocketWorker;
+
+// 端到端压测：同一进程内启动模拟 rosbridge（独立线程，回环地址）和客户端的完整管线
+// （ConnectionManager/WebSocketWorker、路由器与解码线程池、监视器、DisplayConsumer 模拟的界面取帧），
+// 按倍数逐级提高各话题的发布频率，每一级测量：
+//   发布频率、收到/显示的帧数、服务端积压丢弃与客户端丢弃（解码队列溢出、分片超时等）、
+//   消息时间戳到可显示的延迟（TopicMetrics 的 EndToEnd，时钟经 /rosapi/get_time 同步）
+// 第一次出现丢弃比例超过阈值（或延迟超过上限）的前一级即为饱和点，作为版本之间比较的单一指标
+class LoadHarness : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options {
+        double startFactor = 1.0;       // 第一级相对基础频率的倍数
+        double stepFactor = 1.5;        // 每级倍数的增长
+        double maxFactor = 64.0;
+        int warmupMs = 2000;            // 每级改变频率后先稳定一段时间再计数
+        int measureMs = 5000;
+        double dropThreshold = 0.01;    // 丢弃比例超过该值视为饱和
+        double latencyLimitMs = 0;      // 端到端 p99 超过该值也视为饱和，0 为不限
+        int displayFps = 60;
+        int syncTimeoutMs = 10000;      // 等待连接和时钟同步的最长时间
+        bool honorThrottle = false;     // 默认忽略 topic_qos 的 throttle_rate，否则服务端限频会掩盖客户端的处理能力
+        bool gl = false;                // 点云交给 PointCloudDisplay 渲染（需要平台支持 OpenGL）
+        QString ramp;                   // 只提高该话题的频率，其他话题保持基础频率；为空时全部提高
+        QString output;                 // 结果 JSON 文件
+
+        // 基础负载（倍数为 1 时）
+        double cameraHz = 30;
+        QSize cameraSize = QSize(640, 480);
+        int cameraQuality = 80;
+        double cloudHz = 5;
+        int cloudPoints = 100000;
+        double keyframeHz = 2;
+        int keyframes = 200;
+        double poseHz = 30;
+        double imuHz = 400;
+    };
+
+    explicit LoadHarness(const Options &options, QObject *parent = nullptr);
+    ~LoadHarness();
+
+public slots:
+    void start();
+
+signals:
+    void finished(int exitCode);
+
+private:
+    struct TopicLoad {
+        QString topic;
+        double baseHz = 0;
+    };
+
+    struct TopicResult {
+        QString topic;
+        double targetHz = 0;
+        double offeredHz = 0;       // 服务端实际生成的频率
+        double receivedHz = 0;
+        double displayedHz = 0;
+        double mbPerSec = 0;
+        quint64 generated = 0;
+        quint64 serverDropped = 0;  // 客户端发送缓冲积压而丢弃
+        quint64 clientDropped = 0;  // TopicMetrics 记录的丢弃（解码队列满等）
+        quint64 clientSkipped = 0;  // 最新值信箱覆盖、限帧跳过，单独报告，不计入丢弃比例
+        double dropRatio = 0;       // (serverDropped + clientDropped) / generated
+        double endToEndMsP50 = 0;
+        double endToEndMsP99 = 0;
+        quint64 endToEndSamples = 0;
+        double transportMsP50 = 0;
+        double transportMsP99 = 0;
+        double decodeUsP99 = 0;
+    };
+
+    struct StepResult {
+        double factor = 0;
+        bool saturated = false;
+        bool generatorLimited = false;  // 模拟服务器达不到目标频率，本级及以后的结果不可信
+        QString reason;
+        double msgsPerSec = 0;
+        double mbPerSec = 0;
+        QList<TopicResult> topics;
+    };
+
+    bool setUp();
+    void waitReady();
+    void runStep();
+    void beginMeasure();
+    void endMeasure();
+    void finish(int exitCode);
+    void tearDown();
+
+    double targetHz(const TopicLoad &load, double factor) const;
+    void setRates(double factor);
+    MockRosbridgeServer::Stats serverStats(const QString &topic);
+    static QJsonObject stepToJson(const StepResult &step);
+    QJsonObject toJson(int saturatedIndex) const;
+
+    Options m_options;
+    QList<TopicLoad> m_loads;
+
+    QThread m_serverThread;
+    MockRosbridgeServer *m_server = nullptr;
+    QString m_url;
+
+    ConnectionManager *m_connections = nullptr;
+    WebSocketWorker *m_worker = nullptr;
+    bool m_connected = false;
+    CameraImageMonitor *m_camera = nullptr;
+    SlamMapMonitor *m_slam = nullptr;
+    ImuMonitor *m_imu = nullptr;
+    PointCloudDisplay *m_display = nullptr;
+    DisplayConsumer m_consumer;
+
+    QElapsedTimer m_readyTimer;
+    QElapsedTimer m_measureTimer;
+    double m_factor = 0;
+    QList<StepResult> m_steps;
+};
+
+#endif // LOADHARNESS_H
@@ -0,0 +1,96 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include <QDebug>
+
+#include <cstdio>
+
+#include "loadharness.h"
+
+// 无界面的端到端压测：模拟 rosbridge + 客户端管线，逐级加压直到出现丢弃，输出饱和点
+//   robanweb_e2e --step-factor 1.5 --measure 5000 --output e2e.json
+//   robanweb_e2e --ramp /SLAM/MapPoints --cloud-points 1000000
+// 默认使用 offscreen 平台（可用 QT_QPA_PLATFORM 覆盖），不需要显示器
+
+static bool s_verbose = false;
+
+// 管线各处按帧打印 qDebug，默认只保留 info 以上的输出
+static void messageHandler(QtMsgType type, const QMessageLogContext &, const QString &msg)
+{
+    if (type == QtDebugMsg && !s_verbose) return;
+    fprintf(stderr, "%s\n", qPrintable(msg));
+    fflush(stderr);
+}
+
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("robanweb_e2e");
+    qInstallMessageHandler(messageHandler);
+
+    LoadHarness::Options defaults;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless end-to-end latency and throughput harness");
+    parser.addHelpOption();
+    const QList<QCommandLineOption> options = {
+        {"output", "Write results as JSON to this file.", "file"},
+        {"start-factor", "Load multiplier of the first step.", "x", QString::number(defaults.startFactor)},
+        {"step-factor", "Load multiplier growth per step.", "x", QString::number(defaults.stepFactor)},
+        {"max-factor", "Stop after this load multiplier.", "x", QString::number(defaults.maxFactor)},
+        {"warmup", "Settle time after each rate change (ms).", "ms", QString::number(defaults.warmupMs)},
+        {"measure", "Measurement window per step (ms).", "ms", QString::number(defaults.measureMs)},
+        {"drop-threshold", "Drop ratio that counts as saturated.", "ratio", QString::number(defaults.dropThreshold)},
+        {"latency-limit", "End-to-end p99 (ms) that counts as saturated, 0 to disable.", "ms", QString::number(defaults.latencyLimitMs)},
+        {"display-fps", "Rate at which the emulated UI pulls frames.", "fps", QString::number(defaults.displayFps)},
+        {"ramp", "Only increase the rate of this topic.", "topic"},
+        {"honor-throttle", "Apply throttle_rate from topic_qos on the mock server."},
+        {"gl", "Render point clouds with PointCloudDisplay (needs OpenGL on the platform)."},
+        {"camera-rate", "Base CompressedImage rate (Hz), 0 to disable.", "hz", QString::number(defaults.cameraHz)},
+        {"camera-size", "CompressedImage size WxH.", "size", "640x480"},
+        {"camera-quality", "JPEG quality 1-100.", "quality", QString::number(defaults.cameraQuality)},
+        {"cloud-rate", "Base PointCloud2 rate (Hz), 0 to disable.", "hz", QString::number(defaults.cloudHz)},
+        {"cloud-points", "PointCloud2 points per message.", "points", QString::number(defaults.cloudPoints)},
+        {"keyframe-rate", "Base keyframe MarkerArray rate (Hz), 0 to disable.", "hz", QString::number(defaults.keyframeHz)},
+        {"keyframes", "Keyframes per MarkerArray.", "count", QString::number(defaults.keyframes)},
+        {"pose-rate", "Base camera pose and OpenGL matrix rate (Hz), 0 to disable.", "hz", QString::number(defaults.poseHz)},
+        {"imu-rate", "Base Imu rate (Hz), 0 to disable.", "hz", QString::number(defaults.imuHz)},
+        {"verbose", "Keep qDebug output of the pipeline."},
+    };
+    parser.addOptions(options);
+    parser.process(app);
+    s_verbose = parser.isSet("verbose");
+
+    LoadHarness::Options o;
+    o.output = parser.value("output");
+    o.startFactor = parser.value("start-factor").toDouble();
+    o.stepFactor = parser.value("step-factor").toDouble();
+    o.maxFactor = parser.value("max-factor").toDouble();
+    o.warmupMs = parser.value("warmup").toInt();
+    o.measureMs = qMax(100, parser.value("measure").toInt());
+    o.dropThreshold = parser.value("drop-threshold").toDouble();
+    o.latencyLimitMs = parser.value("latency-limit").toDouble();
+    o.displayFps = parser.value("display-fps").toInt();
+    o.ramp = parser.value("ramp");
+    o.honorThrottle = parser.isSet("honor-throttle");
+    o.gl = parser.isSet("gl");
+    o.cameraHz = parser.value("camera-rate").toDouble();
+    const QStringList size = parser.value("camera-size").split('x');
+    if (size.size() == 2) o.cameraSize = QSize(size.at(0).toInt(), size.at(1).toInt());
+    o.cameraQuality = parser.value("camera-quality").toInt();
+    o.cloudHz = parser.value("cloud-rate").toDouble();
+    o.cloudPoints = parser.value("cloud-points").toInt();
+    o.keyframeHz = parser.value("keyframe-rate").toDouble();
+    o.keyframes = parser.value("keyframes").toInt();
+    o.poseHz = parser.value("pose-rate").toDouble();
+    o.imuHz = parser.value("imu-rate").toDouble();
+    if (o.startFactor <= 0) {
+        qCritical() << "--start-factor 必须大于 0";
+        return 1;
+    }
+
+    LoadHarness harness(o);
+    QObject::connect(&harness, &LoadHarness::finished, &app, [&app](int code) { app.exit(code); }, Qt::QueuedConnection);
+    QTimer::singleShot(0, &harness, &LoadHarness::start);
+    return app.exec();
+}
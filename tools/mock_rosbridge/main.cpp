@@ -0,0 +1,115 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
+#include <QDebug>
+
+#include "mockrosbridgeserver.h"
+
+// 模拟 rosbridge 服务器：按 topic_config.yaml 中的默认话题名生成合成数据，客户端连接 ws://127.0.0.1:9090 即可
+//   mock_rosbridge --camera-rate 30 --cloud-points 1000000 --imu-rate 400
+// 频率为 0 的话题不发布
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("mock_rosbridge");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Mock rosbridge server with synthetic ROS topics");
+    parser.addHelpOption();
+
+    const QList<QCommandLineOption> options = {
+        {"listen", "Listen address.", "address", "127.0.0.1"},
+        {"port", "Listen port.", "port", "9090"},
+        {"camera-rate", "CompressedImage rate (Hz) on the camera and feature topics.", "hz", "30"},
+        {"camera-size", "CompressedImage size WxH.", "size", "640x480"},
+        {"camera-quality", "JPEG quality 1-100.", "quality", "80"},
+        {"raw-rate", "Raw Image rate (Hz).", "hz", "10"},
+        {"raw-size", "Raw Image size WxH.", "size", "640x480"},
+        {"raw-encoding", "Raw Image encoding: bgr8 or mono8.", "encoding", "bgr8"},
+        {"cloud-rate", "PointCloud2 rate (Hz).", "hz", "5"},
+        {"cloud-points", "PointCloud2 points per message (10k-5M).", "points", "100000"},
+        {"keyframe-rate", "Keyframe MarkerArray rate (Hz).", "hz", "2"},
+        {"keyframes", "Keyframes per MarkerArray.", "count", "200"},
+        {"imu-rate", "Imu rate (Hz).", "hz", "400"},
+        {"pose-rate", "Camera PoseStamped and OpenGL matrix rate (Hz).", "hz", "30"},
+        {"battery-rate", "BatteryState rate (Hz).", "hz", "1"},
+        {"stats", "Statistics interval (ms), 0 to disable.", "ms", QString::number(MockRosbridgeServer::STATS_INTERVAL_MS)},
+    };
+    parser.addOptions(options);
+    parser.process(app);
+
+    auto rate = [&parser](const char *name) { return parser.value(name).toDouble(); };
+    auto size = [&parser](const char *name, int *w, int *h) {
+        const QStringList parts = parser.value(name).split('x');
+        if (parts.size() == 2) {
+            *w = parts.at(0).toInt();
+            *h = parts.at(1).toInt();
+        }
+    };
+
+    MockRosbridgeServer server;
+    server.setStatsInterval(parser.value("stats").toInt());
+
+    SyntheticStream::Config camera;
+    camera.kind = SyntheticStream::CompressedImage;
+    camera.rateHz = rate("camera-rate");
+    camera.quality = parser.value("camera-quality").toInt();
+    size("camera-size", &camera.width, &camera.height);
+    camera.topic = "/camera/color/image_raw/compressed";
+    server.addStream(camera);
+    camera.topic = "/SLAM/FeaturePoint/Image/compressed";
+    server.addStream(camera);
+
+    SyntheticStream::Config raw;
+    raw.kind = SyntheticStream::Image;
+    raw.rateHz = rate("raw-rate");
+    raw.encoding = parser.value("raw-encoding");
+    size("raw-size", &raw.width, &raw.height);
+    raw.topic = "/camera/color/image_raw";
+    server.addStream(raw);
+    raw.topic = "/SLAM/FeaturePoint/Image";
+    server.addStream(raw);
+
+    SyntheticStream::Config cloud;
+    cloud.kind = SyntheticStream::PointCloud2;
+    cloud.topic = "/SLAM/MapPoints";
+    cloud.rateHz = rate("cloud-rate");
+    cloud.points = parser.value("cloud-points").toInt();
+    server.addStream(cloud);
+
+    SyntheticStream::Config keyframes;
+    keyframes.kind = SyntheticStream::MarkerArray;
+    keyframes.topic = "/SLAM/KeyFrames";
+    keyframes.rateHz = rate("keyframe-rate");
+    keyframes.keyframes = parser.value("keyframes").toInt();
+    server.addStream(keyframes);
+
+    SyntheticStream::Config imu;
+    imu.kind = SyntheticStream::Imu;
+    imu.topic = "/MediumSize/SensorHub/Imu";
+    imu.rateHz = rate("imu-rate");
+    server.addStream(imu);
+
+    SyntheticStream::Config pose;
+    pose.kind = SyntheticStream::PoseStamped;
+    pose.topic = "/SLAM/CameraPoint";
+    pose.rateHz = rate("pose-rate");
+    server.addStream(pose);
+
+    SyntheticStream::Config matrix;
+    matrix.kind = SyntheticStream::Float64MultiArray;
+    matrix.topic = "/SLAM/CameraOpenGLMatrix";
+    matrix.rateHz = rate("pose-rate");
+    server.addStream(matrix);
+
+    SyntheticStream::Config battery;
+    battery.kind = SyntheticStream::BatteryState;
+    battery.topic = "/MediumSize/SensorHub/BatteryState";
+    battery.rateHz = rate("battery-rate");
+    server.addStream(battery);
+
+    if (!server.listen(QHostAddress(parser.value("listen")), quint16(parser.value("port").toUInt()))) {
+        return 1;
+    }
+    return app.exec();
+}
@@ -0,0 +1,368 @@
+#include "mockrosbridgeserver.h"
+
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QImage>
+#include <QBuffer>
+#include <QCborMap>
+#include <QtMath>
+#include <cstring>
+#include <chrono>
+
+// 消息 header.stamp 和 get_time 使用的时间（微秒，自 epoch），与客户端 MessageStamps::nowUs 为同一时钟
+static qint64 epochUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+MockRosbridgeServer::MockRosbridgeServer(QObject *parent)
+    : QObject(parent),
+      m_server(new QWebSocketServer(QStringLiteral("mock_rosbridge"), QWebSocketServer::NonSecureMode, this)),
+      m_tickTimer(new QTimer(this)),
+      m_statsTimer(new QTimer(this))
+{
+    connect(m_server, &QWebSocketServer::newConnection, this, &MockRosbridgeServer::onNewConnection);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    m_tickTimer->setInterval(TICK_MS);
+    connect(m_tickTimer, &QTimer::timeout, this, &MockRosbridgeServer::onTick);
+    connect(m_statsTimer, &QTimer::timeout, this, &MockRosbridgeServer::printStats);
+    setStatsInterval(STATS_INTERVAL_MS);
+    m_clock.start();
+}
+
+MockRosbridgeServer::~MockRosbridgeServer()
+{
+    for (Client *client : m_clients) {
+        client->socket->disconnect(this);
+        client->socket->abort();
+        delete client->socket;
+        delete client;
+    }
+    m_clients.clear();
+}
+
+bool MockRosbridgeServer::listen(const QHostAddress &address, quint16 port)
+{
+    if (!m_server->listen(address, port)) {
+        qDebug() << "MockRosbridgeServer: listen failed:" << m_server->errorString();
+        return false;
+    }
+    qDebug() << "MockRosbridgeServer: listening on" << url();
+    m_tickTimer->start();
+    return true;
+}
+
+quint16 MockRosbridgeServer::port() const
+{
+    return m_server->serverPort();
+}
+
+QString MockRosbridgeServer::url() const
+{
+    return QStringLiteral("ws://%1:%2").arg(m_server->serverAddress().toString()).arg(m_server->serverPort());
+}
+
+void MockRosbridgeServer::addStream(const SyntheticStream::Config &config)
+{
+    Stream stream;
+    stream.source = std::make_shared<SyntheticStream>(config);
+    stream.nextDueUs = m_clock.nsecsElapsed() / 1000;
+    m_streams.insert(config.topic, stream);
+    qDebug() << "MockRosbridgeServer: stream" << config.topic << stream.source->type() << config.rateHz << "Hz";
+}
+
+void MockRosbridgeServer::setStreamRate(const QString &topic, double rateHz)
+{
+    auto it = m_streams.find(topic);
+    if (it == m_streams.end()) return;
+    it->source->setRateHz(rateHz);
+    it->nextDueUs = m_clock.nsecsElapsed() / 1000;
+}
+
+QStringList MockRosbridgeServer::topics() const
+{
+    return m_streams.keys();
+}
+
+void MockRosbridgeServer::setStatsInterval(int ms)
+{
+    if (ms > 0) m_statsTimer->start(ms);
+    else m_statsTimer->stop();
+}
+
+void MockRosbridgeServer::onNewConnection()
+{
+    while (QWebSocket *socket = m_server->nextPendingConnection()) {
+        Client *client = new Client;
+        client->socket = socket;
+        m_clients.append(client);
+        const QString peer = QStringLiteral("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+        qDebug() << "MockRosbridgeServer: client connected" << peer;
+
+        connect(socket, &QWebSocket::textMessageReceived, this, [this, client](const QString &message) {
+            handleText(client, message);
+        });
+        connect(socket, &QWebSocket::disconnected, this, [this, client, peer]() {
+            qDebug() << "MockRosbridgeServer: client disconnected" << peer;
+            m_clients.removeOne(client);
+            client->socket->deleteLater();
+            delete client;
+            emit clientDisconnected(peer);
+        });
+        emit clientConnected(peer);
+    }
+}
+
+// 按各数据流的频率生成消息；一次 tick 中某个流最多补发一条，落后太多时直接跳到当前时间，不会突发
+void MockRosbridgeServer::onTick()
+{
+    const qint64 now = m_clock.nsecsElapsed() / 1000;
+    for (auto it = m_streams.begin(); it != m_streams.end(); ++it) {
+        const double rate = it->source->config().rateHz;
+        if (rate <= 0 || now < it->nextDueUs) continue;
+        const qint64 periodUs = qMax<qint64>(1, qint64(1e6 / rate));
+        it->nextDueUs += periodUs;
+        if (it->nextDueUs < now) it->nextDueUs = now + periodUs;
+
+        const QString topic = it.key();
+        bool subscribed = false;
+        for (const Client *client : m_clients) {
+            if (client->subscriptions.contains(topic)) {
+                subscribed = true;
+                break;
+            }
+        }
+        if (!subscribed) continue;
+        publish(topic, it->source->next(epochUs()));
+    }
+}
+
+void MockRosbridgeServer::publish(const QString &topic, const QCborMap &msg)
+{
+    Stats &stats = m_stats[topic];
+    ++stats.messages;
+    QHash<QString, Encoded> cache;
+    for (Client *client : m_clients) {
+        auto sub = client->subscriptions.find(topic);
+        if (sub == client->subscriptions.end()) continue;
+        if (m_honorThrottle && sub->throttleMs > 0 && sub->lastSent.isValid() && sub->lastSent.elapsed() < sub->throttleMs) continue;
+
+        const QString key = sub->compression + QLatin1Char('/') + QString::number(sub->fragmentSize);
+        auto cached = cache.find(key);
+        if (cached == cache.end()) cached = cache.insert(key, encode(topic, msg, sub->compression, sub->fragmentSize));
+        if (send(client, topic, cached.value())) sub->lastSent.start();
+    }
+}
+
+MockRosbridgeServer::Encoded MockRosbridgeServer::encode(const QString &topic, const QCborMap &msg,
+                                                         const QString &compression, int fragmentSize)
+{
+    Encoded encoded;
+    QString mode = compression;
+    if (mode == QLatin1String("cbor-raw")) {
+        // cbor-raw 需要 ROS 序列化，模拟服务器不支持，按 cbor 发送
+        if (!m_cborRawWarned) {
+            qDebug() << "MockRosbridgeServer: cbor-raw not supported, sending cbor instead";
+            m_cborRawWarned = true;
+        }
+        mode = QStringLiteral("cbor");
+    }
+
+    if (mode == QLatin1String("cbor")) {
+        QCborMap envelope;
+        envelope.insert(QStringLiteral("op"), QStringLiteral("publish"));
+        envelope.insert(QStringLiteral("topic"), topic);
+        envelope.insert(QStringLiteral("msg"), msg);
+        encoded.binary = envelope.toCborValue().toCbor();
+        encoded.isBinary = true;
+        return encoded;
+    }
+
+    QJsonObject envelope;
+    envelope["op"] = "publish";
+    envelope["topic"] = topic;
+    envelope["msg"] = SyntheticStream::toJson(msg);
+    const QByteArray json = QJsonDocument(envelope).toJson(QJsonDocument::Compact);
+    const QString text = mode == QLatin1String("png") ? pngFrame(json) : QString::fromUtf8(json);
+    encoded.texts = fragmentSize > 0 && text.size() > fragmentSize
+                        ? fragment(text, fragmentSize)
+                        : QList<QString>{ text };
+    return encoded;
+}
+
+// 分片：{"op": "fragment", "id": ..., "data": 第 num 段文本, "num": ..., "total": ...}
+QList<QString> MockRosbridgeServer::fragment(const QString &text, int fragmentSize)
+{
+    const QString id = QStringLiteral("mock_fragment_%1").arg(++m_nextFragmentId);
+    const int total = int((text.size() + fragmentSize - 1) / fragmentSize);
+    QList<QString> out;
+    out.reserve(total);
+    for (int num = 0; num < total; ++num) {
+        QJsonObject frag;
+        frag["op"] = "fragment";
+        frag["id"] = id;
+        frag["data"] = text.mid(qsizetype(num) * fragmentSize, fragmentSize);
+        frag["num"] = num;
+        frag["total"] = total;
+        out.append(QString::fromUtf8(QJsonDocument(frag).toJson(QJsonDocument::Compact)));
+    }
+    return out;
+}
+
+// png：JSON 文本的字节按 RGB 像素排成近似正方形的图像，不足的部分补 '\n'，PNG 编码后 base64
+QString MockRosbridgeServer::pngFrame(const QByteArray &json)
+{
+    const qsizetype pixels = (json.size() + 2) / 3;
+    const int width = qMax(1, int(qCeil(qSqrt(double(pixels)))));
+    const int height = int((pixels + width - 1) / width);
+    QByteArray padded = json;
+    padded.append(qsizetype(width) * height * 3 - json.size(), '\n');
+
+    QImage image(width, height, QImage::Format_RGB888);
+    for (int y = 0; y < height; ++y) {
+        memcpy(image.scanLine(y), padded.constData() + qsizetype(y) * width * 3, size_t(width) * 3);
+    }
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+
+    QJsonObject frame;
+    frame["op"] = "png";
+    frame["data"] = QString::fromLatin1(png.toBase64());
+    return QString::fromUtf8(QJsonDocument(frame).toJson(QJsonDocument::Compact));
+}
+
+bool MockRosbridgeServer::send(Client *client, const QString &topic, const Encoded &encoded)
+{
+    Stats &stats = m_stats[topic];
+    if (client->socket->bytesToWrite() > MAX_CLIENT_BACKLOG_BYTES) {
+        ++stats.dropped;
+        return false;
+    }
+    if (encoded.isBinary) {
+        stats.bytes += quint64(client->socket->sendBinaryMessage(encoded.binary));
+        ++stats.frames;
+    } else {
+        for (const QString &text : encoded.texts) {
+            stats.bytes += quint64(client->socket->sendTextMessage(text));
+            ++stats.frames;
+        }
+    }
+    return true;
+}
+
+void MockRosbridgeServer::handleText(Client *client, const QString &message)
+{
+    const QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    if (!doc.isObject()) {
+        qDebug() << "MockRosbridgeServer: invalid JSON from client:" << message.left(200);
+        return;
+    }
+    handleOp(client, doc.object());
+}
+
+void MockRosbridgeServer::handleOp(Client *client, const QJsonObject &obj)
+{
+    const QString op = obj.value("op").toString();
+    const QString topic = obj.value("topic").toString();
+
+    if (op == QLatin1String("subscribe")) {
+        Subscription sub;
+        sub.type = obj.value("type").toString();
+        sub.throttleMs = obj.value("throttle_rate").toInt();
+        sub.fragmentSize = obj.value("fragment_size").toInt();
+        sub.compression = obj.value("compression").toString(QStringLiteral("none"));
+        client->subscriptions.insert(topic, sub);
+        qDebug() << "MockRosbridgeServer: subscribe" << topic << "throttle" << sub.throttleMs
+                 << "fragment" << sub.fragmentSize << "compression" << sub.compression
+                 << (m_streams.contains(topic) ? "" : "(no synthetic stream)");
+    } else if (op == QLatin1String("unsubscribe")) {
+        client->subscriptions.remove(topic);
+        qDebug() << "MockRosbridgeServer: unsubscribe" << topic;
+    } else if (op == QLatin1String("advertise")) {
+        client->advertised.insert(topic);
+        qDebug() << "MockRosbridgeServer: advertise" << topic << obj.value("type").toString();
+    } else if (op == QLatin1String("unadvertise")) {
+        client->advertised.remove(topic);
+    } else if (op == QLatin1String("publish")) {
+        // 客户端发布的消息（遥控、脚本命令等）转发给订阅者，与真实话题一样
+        publish(topic, QCborMap::fromJsonObject(obj.value("msg").toObject()));
+    } else if (op == QLatin1String("fragment")) {
+        const QString id = obj.value("id").toVariant().toString();
+        const int num = obj.value("num").toInt(-1);
+        const int total = obj.value("total").toInt(-1);
+        if (total <= 0 || num < 0 || num >= total) return;
+        PendingFragments &pending = client->fragments[id];
+        if (pending.parts.size() != total) {
+            pending.parts = QStringList(total, QString());
+            pending.received.fill(false, total);
+            pending.count = 0;
+        }
+        if (!pending.received.at(num)) {
+            pending.received.setBit(num);
+            ++pending.count;
+        }
+        pending.parts[num] = obj.value("data").toString();
+        if (pending.count < total) return;
+        const QString complete = pending.parts.join(QString());
+        client->fragments.remove(id);
+        handleText(client, complete);
+    } else if (op == QLatin1String("call_service")) {
+        handleServiceCall(client, obj);
+    } else {
+        qDebug() << "MockRosbridgeServer: unsupported op" << op;
+    }
+}
+
+// rosapi 服务：话题列表、话题类型和服务器时间（用于客户端的时钟同步）
+void MockRosbridgeServer::handleServiceCall(Client *client, const QJsonObject &obj)
+{
+    const QString service = obj.value("service").toString();
+    const QJsonObject args = obj.value("args").toObject();
+
+    QJsonObject response;
+    response["op"] = "service_response";
+    response["service"] = service;
+    if (obj.contains("id")) response["id"] = obj.value("id");
+
+    QJsonObject values;
+    bool ok = true;
+    if (service == QLatin1String("/rosapi/topics")) {
+        QJsonArray topics, types;
+        for (auto it = m_streams.constBegin(); it != m_streams.constEnd(); ++it) {
+            topics.append(it.key());
+            types.append(it->source->type());
+        }
+        values["topics"] = topics;
+        values["types"] = types;
+    } else if (service == QLatin1String("/rosapi/topic_type")) {
+        auto it = m_streams.constFind(args.value("topic").toString());
+        values["type"] = it == m_streams.constEnd() ? QString() : it.value().source->type();
+    } else if (service == QLatin1String("/rosapi/get_time")) {
+        const qint64 us = epochUs();
+        QJsonObject time;
+        time["secs"] = double(us / 1000000);
+        time["nsecs"] = double((us % 1000000) * 1000);
+        values["time"] = time;
+    } else {
+        ok = false;
+    }
+
+    response["result"] = ok;
+    if (ok) response["values"] = values;
+    else response["values"] = QStringLiteral("Service %1 does not exist").arg(service);
+    client->socket->sendTextMessage(QString::fromUtf8(QJsonDocument(response).toJson(QJsonDocument::Compact)));
+}
+
+void MockRosbridgeServer::printStats()
+{
+    if (m_stats.isEmpty()) return;
+    qDebug() << "MockRosbridgeServer: clients" << m_clients.size();
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        qDebug().noquote() << QStringLiteral("  %1: %2 msgs, %3 frames, %4 MiB, %5 dropped")
+                                  .arg(it.key()).arg(it->messages).arg(it->frames)
+                                  .arg(it->bytes / (1024.0 * 1024.0), 0, 'f', 1).arg(it->dropped);
+    }
+}
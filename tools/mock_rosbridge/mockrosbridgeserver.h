@@ -0,0 +1,127 @@
+#ifndef MOCKROSBRIDGESERVER_H
+#define MOCKROSBRIDGESERVER_H
+
+#include <QObject>
+#include <QWebSocketServer>
+#include <QWebSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QList>
+#include <QBitArray>
+#include <QJsonObject>
+#include <QDebug>
+
+#include <memory>
+
+#include "syntheticstream.h"
+
+// 本地模拟 rosbridge（v2 协议中客户端用到的部分）：
+//   subscribe / unsubscribe（throttle_rate、fragment_size、compression: none / png / cbor）
+//   advertise / unadvertise / publish（发布的消息转发给订阅了该话题的客户端）
+//   fragment（收发两个方向）、call_service（/rosapi/topics、/rosapi/topic_type、/rosapi/get_time）
+// 话题数据由 SyntheticStream 按设定的频率生成，不需要机器人和网络即可对客户端做压力测试
+// 与 rosbridge 的差异：
+//   queue_length 被忽略，没有按订阅的发送队列；只有一个按客户端的积压上限：发送缓冲超过 MAX_CLIENT_BACKLOG_BYTES
+//   时丢弃新消息（所有话题共用），丢弃数计入统计，发送方不会因慢客户端而无限占用内存
+//   compression: cbor-raw 需要 ROS 序列化，按 cbor 发送（第一次时输出一条日志）
+class MockRosbridgeServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MockRosbridgeServer(QObject *parent = nullptr);
+    ~MockRosbridgeServer();
+
+    static const qint64 MAX_CLIENT_BACKLOG_BYTES = 16 * 1024 * 1024;
+    static const int TICK_MS = 1;               // 发布调度的时间粒度
+    static const int STATS_INTERVAL_MS = 5000;  // 统计输出间隔，0 为不输出
+
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 9090);
+    quint16 port() const;
+    QString url() const;        // ws://地址:端口
+
+    // 添加数据流；同名话题替换旧的
+    void addStream(const SyntheticStream::Config &config);
+    void setStreamRate(const QString &topic, double rateHz);    // 0 为停止发布
+    QStringList topics() const;
+
+    struct Stats {
+        quint64 messages = 0;   // 生成的消息数
+        quint64 frames = 0;     // 发出的帧数（分片各算一帧）
+        quint64 bytes = 0;
+        quint64 dropped = 0;    // 因客户端积压或限频以外的原因未发出的消息
+    };
+    Stats stats(const QString &topic) const { return m_stats.value(topic); }
+    void resetStats() { m_stats.clear(); }
+    void setStatsInterval(int ms);
+    // 关闭后忽略订阅的 throttle_rate，按数据流的频率全部发出（压测客户端处理能力时使用）
+    void setHonorThrottle(bool honor) { m_honorThrottle = honor; }
+
+signals:
+    void clientConnected(const QString &peer);
+    void clientDisconnected(const QString &peer);
+
+private slots:
+    void onNewConnection();
+    void onTick();
+    void printStats();
+
+private:
+    struct Subscription {
+        QString type;
+        int throttleMs = 0;
+        int fragmentSize = 0;
+        QString compression;
+        QElapsedTimer lastSent;
+    };
+
+    struct PendingFragments {
+        QStringList parts;
+        QBitArray received;
+        int count = 0;
+    };
+
+    struct Client {
+        QWebSocket *socket = nullptr;
+        QHash<QString, Subscription> subscriptions;
+        QSet<QString> advertised;
+        QHash<QString, PendingFragments> fragments;    // 收到的分片（id -> 各片）
+    };
+
+    struct Stream {
+        std::shared_ptr<SyntheticStream> source;
+        qint64 nextDueUs = 0;       // 相对 m_clock 的下次发布时间
+    };
+
+    // 同一条消息按不同的 compression/fragment_size 编码一次，多个客户端共用
+    struct Encoded {
+        QList<QString> texts;
+        QByteArray binary;
+        bool isBinary = false;
+    };
+
+    void handleText(Client *client, const QString &message);
+    void handleOp(Client *client, const QJsonObject &obj);
+    void handleServiceCall(Client *client, const QJsonObject &obj);
+    void publish(const QString &topic, const QCborMap &msg);
+    Encoded encode(const QString &topic, const QCborMap &msg, const QString &compression, int fragmentSize);
+    bool send(Client *client, const QString &topic, const Encoded &encoded);
+    QList<QString> fragment(const QString &text, int fragmentSize);
+    static QString pngFrame(const QByteArray &json);
+
+    QWebSocketServer *m_server;
+    QList<Client *> m_clients;
+    QMap<QString, Stream> m_streams;
+    QHash<QString, Stats> m_stats;
+    QTimer *m_tickTimer;
+    QTimer *m_statsTimer;
+    QElapsedTimer m_clock;
+    quint64 m_nextFragmentId = 0;
+    bool m_cborRawWarned = false;
+    bool m_honorThrottle = true;
+};
+
+#endif // MOCKROSBRIDGESERVER_H
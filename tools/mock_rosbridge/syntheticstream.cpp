@@ -0,0 +1,309 @@
+#include "syntheticstream.h"
+
+#include <QImage>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QtEndian>
+#include <QtMath>
+#include <QDebug>
+
+// RFC 8746 类型化数组标签（与客户端 CborDecoder 一致）
+static const quint64 TAG_FLOAT64_LE = 86;
+// sensor_msgs/PointField::FLOAT32
+static const int POINT_FIELD_FLOAT32 = 7;
+// 预先编码的 jpeg 帧数
+static const int JPEG_FRAMES = 8;
+
+static QCborValue float64Array(const QVector<double> &values)
+{
+    QByteArray bytes(values.size() * int(sizeof(double)), Qt::Uninitialized);
+    for (int i = 0; i < values.size(); ++i) {
+        qToLittleEndian(values.at(i), bytes.data() + i * sizeof(double));
+    }
+    return QCborValue(QCborTag(TAG_FLOAT64_LE), bytes);
+}
+
+static QCborMap vector3(double x, double y, double z)
+{
+    QCborMap v;
+    v.insert(QStringLiteral("x"), x);
+    v.insert(QStringLiteral("y"), y);
+    v.insert(QStringLiteral("z"), z);
+    return v;
+}
+
+static QCborMap quaternion(double x, double y, double z, double w)
+{
+    QCborMap q = vector3(x, y, z);
+    q.insert(QStringLiteral("w"), w);
+    return q;
+}
+
+SyntheticStream::SyntheticStream(const Config &config)
+    : m_config(config)
+{
+    prepare();
+}
+
+QString SyntheticStream::typeName(Kind kind)
+{
+    switch (kind) {
+    case CompressedImage:   return QStringLiteral("sensor_msgs/CompressedImage");
+    case Image:             return QStringLiteral("sensor_msgs/Image");
+    case PointCloud2:       return QStringLiteral("sensor_msgs/PointCloud2");
+    case MarkerArray:       return QStringLiteral("visualization_msgs/MarkerArray");
+    case Imu:               return QStringLiteral("sensor_msgs/Imu");
+    case PoseStamped:       return QStringLiteral("geometry_msgs/PoseStamped");
+    case Float64MultiArray: return QStringLiteral("std_msgs/Float64MultiArray");
+    case BatteryState:      return QStringLiteral("sensor_msgs/BatteryState");
+    }
+    return QString();
+}
+
+QString SyntheticStream::type() const
+{
+    return typeName(m_config.kind);
+}
+
+// 生成大块数据：jpeg 帧、原始图像、点云、关键帧
+void SyntheticStream::prepare()
+{
+    m_config.width = qMax(16, m_config.width);
+    m_config.height = qMax(16, m_config.height);
+    const int w = m_config.width;
+    const int h = m_config.height;
+
+    if (m_config.kind == CompressedImage) {
+        for (int f = 0; f < JPEG_FRAMES; ++f) {
+            // 渐变背景加一个移动的白色方块，便于看出帧在更新
+            QImage image(w, h, QImage::Format_RGB888);
+            const int boxX = f * (w - w / 4) / JPEG_FRAMES;
+            for (int y = 0; y < h; ++y) {
+                uchar *line = image.scanLine(y);
+                const bool boxRow = y >= h / 3 && y < 2 * h / 3;
+                for (int x = 0; x < w; ++x) {
+                    const bool box = boxRow && x >= boxX && x < boxX + w / 4;
+                    line[x * 3] = box ? 255 : uchar(x * 255 / w);
+                    line[x * 3 + 1] = box ? 255 : uchar(y * 255 / h);
+                    line[x * 3 + 2] = box ? 255 : uchar((x + y + f * 32) & 0xFF);
+                }
+            }
+
+            QByteArray jpeg;
+            QBuffer buffer(&jpeg);
+            buffer.open(QIODevice::WriteOnly);
+            image.save(&buffer, "JPG", m_config.quality);
+            m_jpegFrames.append(jpeg);
+        }
+        qDebug() << "SyntheticStream:" << m_config.topic << w << "x" << h << "jpeg," << m_jpegFrames.first().size() << "bytes/frame";
+    } else if (m_config.kind == Image) {
+        const int channels = m_config.encoding == QLatin1String("mono8") ? 1 : 3;
+        m_pixels.resize(qsizetype(w) * h * channels);
+        uchar *p = reinterpret_cast<uchar *>(m_pixels.data());
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                for (int c = 0; c < channels; ++c) {
+                    *p++ = uchar((x * (c + 1) + y) & 0xFF);
+                }
+            }
+        }
+    } else if (m_config.kind == PointCloud2) {
+        // 点分布在一个螺旋面上，point_step 16（x, y, z, 4 字节填充，与 PCL 的 PointXYZ 相同）
+        const int n = qMax(1, m_config.points);
+        m_cloud.resize(qsizetype(n) * 16);
+        char *p = m_cloud.data();
+        for (int i = 0; i < n; ++i) {
+            const float t = float(i) / float(n);
+            const float angle = t * 40.0f * float(M_PI);
+            const float r = 1.0f + 4.0f * t;
+            const float xyz[4] = { r * float(qCos(angle)), r * float(qSin(angle)), 2.0f * t - 1.0f, 0.0f };
+            for (int k = 0; k < 4; ++k) qToLittleEndian(xyz[k], p + k * 4);
+            p += 16;
+        }
+        qDebug() << "SyntheticStream:" << m_config.topic << n << "points," << m_cloud.size() << "bytes/message";
+    } else if (m_config.kind == MarkerArray) {
+        // 关键帧位置（POINTS）和每个关键帧的视锥线框（LINE_LIST，8 条线段）
+        const int k = qMax(1, m_config.keyframes);
+        QCborArray positions, frustums;
+        for (int i = 0; i < k; ++i) {
+            const double angle = 2 * M_PI * i / k;
+            const double x = 5 * qCos(angle), y = 5 * qSin(angle), z = 0.1 * qSin(angle * 3);
+            positions.append(vector3(x, y, z));
+            const double s = 0.1;
+            const double corners[4][2] = { {-s, -s}, {s, -s}, {s, s}, {-s, s} };
+            for (int c = 0; c < 4; ++c) {
+                frustums.append(vector3(x, y, z));
+                frustums.append(vector3(x + corners[c][0], y + corners[c][1], z + 2 * s));
+                frustums.append(vector3(x + corners[c][0], y + corners[c][1], z + 2 * s));
+                frustums.append(vector3(x + corners[(c + 1) % 4][0], y + corners[(c + 1) % 4][1], z + 2 * s));
+            }
+        }
+        const QCborArray pointLists[2] = { positions, frustums };
+        const int types[2] = { 8, 10 };     // POINTS, LINE_LIST
+        for (int m = 0; m < 2; ++m) {
+            QCborMap marker;
+            marker.insert(QStringLiteral("ns"), QStringLiteral("KeyFrames"));
+            marker.insert(QStringLiteral("id"), m);
+            marker.insert(QStringLiteral("type"), types[m]);
+            marker.insert(QStringLiteral("action"), 0);
+            QCborMap pose;
+            pose.insert(QStringLiteral("orientation"), quaternion(0, 0, 0, 1));
+            marker.insert(QStringLiteral("pose"), pose);
+            marker.insert(QStringLiteral("scale"), vector3(0.05, 0.05, 0.05));
+            QCborMap color;
+            color.insert(QStringLiteral("r"), m == 0 ? 0.0 : 1.0);
+            color.insert(QStringLiteral("g"), 1.0);
+            color.insert(QStringLiteral("b"), 0.0);
+            color.insert(QStringLiteral("a"), 1.0);
+            marker.insert(QStringLiteral("color"), color);
+            marker.insert(QStringLiteral("points"), pointLists[m]);
+            m_markers.append(marker);
+        }
+    }
+}
+
+QCborMap SyntheticStream::header(qint64 stampUs, const QString &frameId)
+{
+    QCborMap stamp;
+    stamp.insert(QStringLiteral("secs"), stampUs / 1000000);
+    stamp.insert(QStringLiteral("nsecs"), (stampUs % 1000000) * 1000);
+    QCborMap h;
+    h.insert(QStringLiteral("seq"), qint64(m_seq));
+    h.insert(QStringLiteral("stamp"), stamp);
+    h.insert(QStringLiteral("frame_id"), frameId);
+    return h;
+}
+
+QCborMap SyntheticStream::next(qint64 stampUs)
+{
+    ++m_seq;
+    const double t = stampUs / 1e6;
+    QCborMap msg;
+
+    switch (m_config.kind) {
+    case CompressedImage:
+        msg.insert(QStringLiteral("header"), header(stampUs, QStringLiteral("camera")));
+        msg.insert(QStringLiteral("format"), QStringLiteral("jpeg"));
+        msg.insert(QStringLiteral("data"), m_jpegFrames.at(int(m_seq % quint32(m_jpegFrames.size()))));
+        break;
+    case Image: {
+        const int channels = m_config.encoding == QLatin1String("mono8") ? 1 : 3;
+        msg.insert(QStringLiteral("header"), header(stampUs, QStringLiteral("camera")));
+        msg.insert(QStringLiteral("height"), m_config.height);
+        msg.insert(QStringLiteral("width"), m_config.width);
+        msg.insert(QStringLiteral("encoding"), channels == 1 ? QStringLiteral("mono8") : QStringLiteral("bgr8"));
+        msg.insert(QStringLiteral("is_bigendian"), 0);
+        msg.insert(QStringLiteral("step"), m_config.width * channels);
+        msg.insert(QStringLiteral("data"), m_pixels);
+        break;
+    }
+    case PointCloud2: {
+        const int n = qMax(1, m_config.points);
+        QCborArray fields;
+        const char *names[3] = { "x", "y", "z" };
+        for (int i = 0; i < 3; ++i) {
+            QCborMap field;
+            field.insert(QStringLiteral("name"), QString::fromLatin1(names[i]));
+            field.insert(QStringLiteral("offset"), i * 4);
+            field.insert(QStringLiteral("datatype"), POINT_FIELD_FLOAT32);
+            field.insert(QStringLiteral("count"), 1);
+            fields.append(field);
+        }
+        msg.insert(QStringLiteral("header"), header(stampUs, QStringLiteral("map")));
+        msg.insert(QStringLiteral("height"), 1);
+        msg.insert(QStringLiteral("width"), n);
+        msg.insert(QStringLiteral("fields"), fields);
+        msg.insert(QStringLiteral("is_bigendian"), false);
+        msg.insert(QStringLiteral("point_step"), 16);
+        msg.insert(QStringLiteral("row_step"), qint64(n) * 16);
+        msg.insert(QStringLiteral("data"), m_cloud);
+        msg.insert(QStringLiteral("is_dense"), true);
+        break;
+    }
+    case MarkerArray: {
+        QCborArray markers;
+        const QCborMap h = header(stampUs, QStringLiteral("map"));
+        for (QCborValue v : m_markers) {
+            QCborMap marker = v.toMap();
+            marker.insert(QStringLiteral("header"), h);
+            markers.append(marker);
+        }
+        msg.insert(QStringLiteral("markers"), markers);
+        break;
+    }
+    case Imu: {
+        const double yaw = 0.5 * t;
+        msg.insert(QStringLiteral("header"), header(stampUs, QStringLiteral("imu")));
+        msg.insert(QStringLiteral("orientation"), quaternion(0, 0, qSin(yaw / 2), qCos(yaw / 2)));
+        msg.insert(QStringLiteral("orientation_covariance"), float64Array(QVector<double>(9, 0.0)));
+        msg.insert(QStringLiteral("angular_velocity"), vector3(0.01 * qSin(t), 0.01 * qCos(t), 0.5));
+        msg.insert(QStringLiteral("angular_velocity_covariance"), float64Array(QVector<double>(9, 0.0)));
+        msg.insert(QStringLiteral("linear_acceleration"), vector3(0.1 * qSin(3 * t), 0.1 * qCos(3 * t), 9.81));
+        msg.insert(QStringLiteral("linear_acceleration_covariance"), float64Array(QVector<double>(9, 0.0)));
+        break;
+    }
+    case PoseStamped: {
+        const double angle = 0.2 * t;
+        QCborMap pose;
+        pose.insert(QStringLiteral("position"), vector3(5 * qCos(angle), 5 * qSin(angle), 0));
+        pose.insert(QStringLiteral("orientation"), quaternion(0, 0, qSin(angle / 2), qCos(angle / 2)));
+        msg.insert(QStringLiteral("header"), header(stampUs, QStringLiteral("map")));
+        msg.insert(QStringLiteral("pose"), pose);
+        break;
+    }
+    case Float64MultiArray: {
+        // 绕 z 轴旋转的相机位姿（列主序 4x4）
+        const double angle = 0.2 * t;
+        const double c = qCos(angle), s = qSin(angle);
+        const QVector<double> m = { c, s, 0, 0,  -s, c, 0, 0,  0, 0, 1, 0,  5 * c, 5 * s, 0, 1 };
+        QCborMap layout;
+        layout.insert(QStringLiteral("dim"), QCborArray());
+        layout.insert(QStringLiteral("data_offset"), 0);
+        msg.insert(QStringLiteral("layout"), layout);
+        msg.insert(QStringLiteral("data"), float64Array(m));
+        break;
+    }
+    case BatteryState:
+        msg.insert(QStringLiteral("header"), header(stampUs, QString()));
+        msg.insert(QStringLiteral("voltage"), 11.8 + 0.3 * qSin(t / 60));
+        msg.insert(QStringLiteral("current"), -1.2);
+        msg.insert(QStringLiteral("charge"), 2.0);
+        msg.insert(QStringLiteral("capacity"), 3.0);
+        msg.insert(QStringLiteral("percentage"), 0.7);
+        msg.insert(QStringLiteral("power_supply_status"), 2);
+        msg.insert(QStringLiteral("present"), true);
+        break;
+    }
+    return msg;
+}
+
+QJsonValue SyntheticStream::toJson(const QCborValue &value)
+{
+    if (value.isMap()) {
+        QJsonObject obj;
+        const QCborMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            obj.insert(it.key().toString(), toJson(it.value()));
+        }
+        return obj;
+    }
+    if (value.isArray()) {
+        QJsonArray arr;
+        const QCborArray a = value.toArray();
+        for (const QCborValue &v : a) arr.append(toJson(v));
+        return arr;
+    }
+    if (value.isTag() && quint64(value.tag()) == TAG_FLOAT64_LE) {
+        const QByteArray bytes = value.taggedValue().toByteArray();
+        QJsonArray arr;
+        for (qsizetype i = 0; i + qsizetype(sizeof(double)) <= bytes.size(); i += sizeof(double)) {
+            arr.append(qFromLittleEndian<double>(bytes.constData() + i));
+        }
+        return arr;
+    }
+    if (value.isByteArray()) {
+        // rosbridge JSON 中 uint8[] 为标准 base64（QCborValue::toJsonValue 使用的是 base64url）
+        return QString::fromLatin1(value.toByteArray().toBase64());
+    }
+    return value.toJsonValue();
+}
@@ -0,0 +1,69 @@
+#ifndef SYNTHETICSTREAM_H
+#define SYNTHETICSTREAM_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QCborMap>
+#include <QCborArray>
+#include <QCborValue>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QElapsedTimer>
+
+// 模拟话题的数据源：按类型生成 ROS1 风格的消息（header.stamp 为 secs/nsecs），供 MockRosbridgeServer 发布
+// 消息统一生成为 CBOR map，uint8[] 为字节串，数值数组为 RFC 8746 类型化数组（与 rosbridge cbor 编码一致）；
+// JSON 编码时字节串转为 base64 字符串、类型化数组展开为数值数组（见 toJson）
+// 大块数据（图像、点云）启动时生成一次，之后每条消息只更新时间戳等小字段，生成开销不影响发布速率
+class SyntheticStream
+{
+public:
+    enum Kind {
+        CompressedImage,    // sensor_msgs/CompressedImage，jpeg
+        Image,              // sensor_msgs/Image，bgr8 或 mono8
+        PointCloud2,        // sensor_msgs/PointCloud2，xyz float32
+        MarkerArray,        // visualization_msgs/MarkerArray，关键帧（POINTS + LINE_LIST）
+        Imu,                // sensor_msgs/Imu
+        PoseStamped,        // geometry_msgs/PoseStamped
+        Float64MultiArray,  // std_msgs/Float64MultiArray，4x4 OpenGL 相机矩阵
+        BatteryState        // sensor_msgs/BatteryState
+    };
+
+    struct Config {
+        QString topic;
+        Kind kind = Imu;
+        double rateHz = 0;          // 0 为不发布
+        int width = 640;            // 图像尺寸
+        int height = 480;
+        int quality = 80;           // jpeg 质量
+        QString encoding = "bgr8";  // 原始图像编码：bgr8 / mono8
+        int points = 100000;        // 点云点数
+        int keyframes = 100;        // 关键帧数
+    };
+
+    explicit SyntheticStream(const Config &config);
+
+    const Config &config() const { return m_config; }
+    void setRateHz(double rateHz) { m_config.rateHz = rateHz; }     // 只影响调度，数据不重新生成
+    QString type() const;                   // ROS 消息类型名
+    static QString typeName(Kind kind);
+
+    // 生成下一条消息，stampUs 为 header.stamp（微秒，自 epoch）
+    QCborMap next(qint64 stampUs);
+
+    // CBOR 消息转 rosbridge JSON：字节串 -> base64，类型化数组 -> 数值数组
+    static QJsonValue toJson(const QCborValue &value);
+
+private:
+    void prepare();
+    QCborMap header(qint64 stampUs, const QString &frameId);
+
+    Config m_config;
+    quint32 m_seq = 0;
+    QVector<QByteArray> m_jpegFrames;   // 预先编码的 jpeg，依次轮换
+    QByteArray m_pixels;                // 原始图像
+    QByteArray m_cloud;                 // 点云 data
+    QCborArray m_markers;               // 关键帧 markers
+};
+
+#endif // SYNTHETICSTREAM_H